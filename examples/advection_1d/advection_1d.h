@@ -27,26 +27,43 @@
 #include <math.h>
 
 #include "uniform_cartesian_mesh_1d.h"
+#include "cartesian_mesh_1d.h"
 #include "mapping_segment.h"
 #include "reference_segment.h"
+#include "lgl_gl_transfer.h"
 #include "flux_advection_1d.h"
 #include "convective_flux_div_1d.h"
+#include "execution_space.h"
 
 // host code of the problem of linear advection equation in one dimensional space
-template<typename T>
+// MESH - 1D mesh type, e.g., uniform_cartesian_mesh_1d or cartesian_mesh_1d
+// SPACE - execution space of the face and element loops (see execution_space.h)
+template<typename T, typename MESH = rdg::uniform_cartesian_mesh_1d<T>, typename SPACE = rdg::serial_space>
 class advection_1d
 {
 public:
   advection_1d(std::size_t numCells, int order)
     : m_numCells(numCells), m_order(order), m_mesh((T)(0), (T)(2. * M_PI), numCells) {}
+
+  // the mesh is of [0, 2 pi] as the one of the above constructor: there is no halo to
+  // connect a part of it to its neighbors, so both of its ends take the inflow/outflow
+  // conditions, which hold only at the physical ends 0 and 2 pi
+  advection_1d(const MESH& mesh, int order)
+    : m_numCells(mesh.num_cells()), m_order(order), m_mesh(mesh) {}
   ~advection_1d(){}
   
   T wave_speed() const { return s_waveSpeed; }
 
-  T min_elem_size() const { return (T)(2.L) * (T)(M_PI) / m_numCells; }
+  T min_elem_size() const { return m_mesh.min_cell_size(); }
 
   int num_dofs() const { return m_numCells * (m_order + 1); }
 
+  // the face and element loops run on the execution space, whose grain cost is in faces
+  // or two-point fluxes of the elements
+  void set_execution_space(const SPACE& space) { m_space = space; }
+
+  const SPACE& execution_space() const { return m_space; }
+
   // the layout of DOFs in memory are different for CPU execution and GPU execution;
   // the first iterator sets the DOF positions and the second iterator sets the
   // initial values of the DOFs
@@ -57,6 +74,12 @@ public:
   template<typename OutputIterator>
   void exact_solution(T t, OutputIterator it) const;
 
+  // L2 norm of the difference between the numerical solution given at the DOFs and the
+  // exact solution at time t, integrated by Gauss-Legendre quadrature of (order + 4) points
+  // in each cell, i.e., over-integrated to resolve the non-polynomial exact solution
+  template<typename ConstItr>
+  T l2_error(T t, ConstItr cbegin) const;
+
   // CPU execution of the spatial discrete operator
   template<typename ConstItr, typename Itr>
   void operator()(ConstItr in_cbegin, std::size_t size, T t, Itr out_begin) const;
@@ -67,8 +90,12 @@ private:
   template<typename ConstItr>
   void numerical_fluxes(ConstItr cbegin, T t) const; // time t is used for boundary conditions
 
+  // element loop of the spatial discrete operator, given the divergence operator
+  template<typename DivOp, typename ConstItr, typename Itr>
+  void apply_div_op(DivOp& divOp, int np, ConstItr in_cbegin, Itr out_begin) const;
+
 private:
-  using mesh_type         = rdg::uniform_cartesian_mesh_1d<T>;
+  using mesh_type         = MESH;
   using mapping_type      = rdg::mapping_segment;
   using reference_element = rdg::reference_segment<T>;
   using flux_calculator   = flux_advection_1d<T>;
@@ -83,10 +110,13 @@ private:
 
   // work space for numerical fluxes
   mutable std::vector<T> m_numericalFluxes;
+
+  // parallel execution
+  SPACE m_space;
 };
 
-template<typename T> template<typename OutputIterator1, typename OutputIterator2>
-void advection_1d<T>::initialize_dofs(OutputIterator1 it1, OutputIterator2 it2) const
+template<typename T, typename MESH, typename SPACE> template<typename OutputIterator1, typename OutputIterator2>
+void advection_1d<T, MESH, SPACE>::initialize_dofs(OutputIterator1 it1, OutputIterator2 it2) const
 {
   reference_element refElem(m_order);
   std::vector<T> pos;
@@ -104,8 +134,8 @@ void advection_1d<T>::initialize_dofs(OutputIterator1 it1, OutputIterator2 it2)
   }
 }
 
-template<typename T> template<typename OutputIterator>
-void advection_1d<T>::exact_solution(T t, OutputIterator it) const
+template<typename T, typename MESH, typename SPACE> template<typename OutputIterator>
+void advection_1d<T, MESH, SPACE>::exact_solution(T t, OutputIterator it) const
 {
   reference_element refElem(m_order);
   std::vector<T> pos;
@@ -122,45 +152,87 @@ void advection_1d<T>::exact_solution(T t, OutputIterator it) const
   }
 }
 
-template<typename T> template<typename ConstItr>
-void advection_1d<T>::numerical_fluxes(ConstItr cbegin, T t) const
+template<typename T, typename MESH, typename SPACE> template<typename ConstItr>
+T advection_1d<T, MESH, SPACE>::l2_error(T t, ConstItr cbegin) const
+{
+  const auto& transfer = rdg::lgl_gl_transfer<T>::get(m_order + 1, m_order + 4);
+  const auto& I = transfer.lgl_to_gl();
+  std::size_t np = transfer.num_lgl_points();
+  std::size_t nq = transfer.num_gl_points();
+
+  T err = rdg::parallel_reduce(m_space, m_numCells, static_cast<T>(0), [&](std::size_t i, T& partial)
+  {
+    std::vector<T> uq(nq);
+    auto cell= m_mesh.get_cell(i);
+    T J = m_mesh.J(i);
+    I.gemv(static_cast<T>(1), cbegin + i * np, static_cast<T>(0), uq.begin());
+    for (std::size_t q = 0; q < nq; ++q)
+    {
+      T x = mapping_type::r_to_x(std::get<0>(cell), std::get<1>(cell), transfer.gl_points()[q]);
+      T diff = uq[q] - std::sin(x - s_waveSpeed * t);
+      partial += transfer.gl_weights()[q] * J * diff * diff;
+    }
+  }, [](T a, T b) { return a + b; });
+  return std::sqrt(err);
+}
+
+template<typename T, typename MESH, typename SPACE> template<typename ConstItr>
+void advection_1d<T, MESH, SPACE>::numerical_fluxes(ConstItr cbegin, T t) const
 {
   flux_calculator fluxCalculator(s_waveSpeed);
 
   std::size_t numFluxes = m_numCells + 1;
   if (m_numericalFluxes.size() < numFluxes) m_numericalFluxes.resize(numFluxes);
 
-  T a, b;
-  int np = reference_element(m_order).num_nodes();
-  for (std::size_t i = 0; i < numFluxes; ++i)
+  int np = m_order + 1;
+  rdg::parallel_for(m_space, numFluxes, [&](std::size_t i)
   {
+    T a, b;
     if (i > 0) a = *(cbegin + (i * np - 1));
     else a = - sin(2.0 * M_PI * t); // inflow boundary condition
     if (i < numFluxes - 1) b = *(cbegin + (i * np));
     else b = *(cbegin + (i * np - 1)); // outflow boundary condition - alternatively, may be set to zero ?
     m_numericalFluxes[i] = fluxCalculator.numerical_surface_flux(a, b, 1);
-  }
+  });
 }
 
-template<typename T> template<typename ConstItr, typename Itr>
-void advection_1d<T>::operator()(ConstItr in_cbegin, std::size_t size, T t, Itr out_begin) const
+template<typename T, typename MESH, typename SPACE> template<typename ConstItr, typename Itr>
+void advection_1d<T, MESH, SPACE>::operator()(ConstItr in_cbegin, std::size_t size, T t, Itr out_begin) const
 {
   numerical_fluxes(in_cbegin, t);
 
-  reference_element refElem(m_order);
   flux_calculator fluxCalculator(s_waveSpeed);
-  rdg::convective_flux_div_1d<reference_element, flux_calculator> divOp(refElem, fluxCalculator);
 
-  int np = refElem.num_nodes();
-  std::vector<T> cellOut(np);
-  for (std::size_t cell = 0; cell < m_numCells; ++cell)
+  // kernels of fixed orders use the compile-time tables of the reference element
+  bool fixedOrder = rdg::dispatch_fixed_order(m_order, [&](auto order)
   {
-    auto cellGeom = m_mesh.get_cell(cell);
-    T J = mapping_type::J(std::get<0>(cellGeom), std::get<1>(cellGeom));
-    divOp.apply(in_cbegin + np * cell, m_numericalFluxes.cbegin() + cell, J, cellOut.begin());
+    rdg::fixed_order_convective_flux_div_1d<decltype(order)::value, flux_calculator> divOp(fluxCalculator);
+    apply_div_op(divOp, decltype(order)::value + 1, in_cbegin, out_begin);
+  });
 
-    for(int i = 0; i < np; ++i) *(out_begin + np * cell + i) = -cellOut[i];
+  if (!fixedOrder)
+  {
+    reference_element refElem(m_order);
+    rdg::convective_flux_div_1d<reference_element, flux_calculator> divOp(refElem, fluxCalculator);
+    apply_div_op(divOp, refElem.num_nodes(), in_cbegin, out_begin);
   }
 }
 
+template<typename T, typename MESH, typename SPACE> template<typename DivOp, typename ConstItr, typename Itr>
+void advection_1d<T, MESH, SPACE>::apply_div_op(DivOp& divOp, int np, ConstItr in_cbegin, Itr out_begin) const
+{
+  // the cost of an element is about the number of its two-point fluxes
+  T cost = static_cast<T>(np * np);
+  rdg::parallel_for(m_space, m_numCells, [cost](std::size_t) { return cost; }, [&](std::size_t begin, std::size_t end)
+  {
+    std::vector<T> cellOut(np);
+    for (std::size_t cell = begin; cell < end; ++cell)
+    {
+      divOp.apply(in_cbegin + np * cell, m_numericalFluxes.cbegin() + cell, m_mesh.J(cell), cellOut.begin());
+
+      for(int i = 0; i < np; ++i) *(out_begin + np * cell + i) = -cellOut[i];
+    }
+  });
+}
+
 #endif
@@ -20,20 +20,13 @@
  
 #include <vector>
 #include <iostream>
-#include <fstream>
 #include <limits>
 #include <chrono>
 
 #include "advection_1d.h"
 #include "explicit_runge_kutta.h"
-
-double compute_error_norm(double* ref_v, double* v, int size)
-{
-  double err = 0.0;
-  for(int i = 0; i < size; ++i)
-    err += (ref_v[i] - v[i]) * (ref_v[i] - v[i]);
-  return err / size;
-}
+#include "work_stealing_scheduler.h"
+#include "text_writer.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 // Program main
@@ -42,13 +35,19 @@ int main(int argc, char **argv) {
 
   int numCells = 1024 * 8;
   int order = 6;
-  if (argc > 1)
+  int numThreads = 1;
+  if (argc > 2)
   {
     numCells = std::atoi(argv[1]);
     order = std::atoi(argv[2]);
   }
+  if (argc > 3) numThreads = std::atoi(argv[3]);
 
-  advection_1d<double> op(numCells, order);
+  // the face and element loops and the Runge-Kutta updates run on the thread pool
+  rdg::work_stealing_scheduler scheduler(numThreads);
+  rdg::thread_pool_space space(numThreads > 1 ? &scheduler : nullptr);
+  advection_1d<double, rdg::uniform_cartesian_mesh_1d<double>, rdg::thread_pool_space> op(numCells, order);
+  op.set_execution_space(space);
 
   // DOF positions and initial conditions
   int numDOFs = op.num_dofs();
@@ -72,7 +71,7 @@ int main(int argc, char **argv) {
   auto t0 = std::chrono::system_clock::now();
   for (int i = 0; i < totalTSs; ++i)
   {
-    rdg::rk4(v.begin(), numDOFs, t, dt, op, v1.begin(), v2.begin(), v3.begin(), v4.begin(), v5.begin());
+    rdg::rk4(space, v.begin(), numDOFs, t, dt, op, rdg::no_stage_filter(), v1.begin(), v2.begin(), v3.begin(), v4.begin(), v5.begin());
     t += dt;
   }
   auto t1 = std::chrono::system_clock::now();
@@ -81,21 +80,17 @@ int main(int argc, char **argv) {
   op.exact_solution(t, ref_v.begin());
 
   // output the last error
-  double errNorm = compute_error_norm(ref_v.data(), v.data(), numDOFs);
-  std::cout << "t = " << t << ", error norm = " << errNorm << std::endl;
-  std::cout << "time used: " << std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count() << " ms" << std::endl;
+  double errNorm = op.l2_error(t, v.cbegin());
+  std::cout << "t = " << t << ", L2 error norm = " << errNorm << std::endl;
+  std::cout << "time used: " << std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count() << " ms with "
+            << numThreads << " thread(s)" << std::endl;
 
   // output to visualize
-  std::ofstream file;
-  file.open("Advection1DDataFile.txt");
-  file.precision(std::numeric_limits<double>::digits10);
-  file << "#         x         y" << std::endl;
-  for(int i = 0; i < numDOFs; ++i)
-    file << x[i] << "  " << v[i] << std::endl;
-  file << std::endl;
-  file << "#         x         reference solution" << std::endl;
-  for(int i = 0; i < numDOFs; ++i)
-    file << x[i] << " " << ref_v[i] << std::endl;
+  rdg::text_writer file("Advection1DDataFile.txt", rdg::text_format{std::chars_format::general, std::numeric_limits<double>::digits10});
+  file.write_text("#         x         y\n");
+  file.write_columns(rdg::serial_space(), numDOFs, "  ", [&](std::size_t i) { return x[i]; }, [&](std::size_t i) { return v[i]; });
+  file.write_text("\n#         x         reference solution\n");
+  file.write_columns(rdg::serial_space(), numDOFs, " ", [&](std::size_t i) { return x[i]; }, [&](std::size_t i) { return ref_v[i]; });
   file.close();
 
   return 0;
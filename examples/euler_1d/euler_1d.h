@@ -25,6 +25,7 @@
 #include <cmath>
 #include <cassert>
 #include <limits>
+#include <algorithm>
 
 // use boost::tuple instead of std::tuple because boost::tuple
 // can work with boost::zip_iterator; standard library does not
@@ -34,24 +35,73 @@
 #include "variable.h"
 
 #include "uniform_cartesian_mesh_1d.h"
+#include "cartesian_mesh_1d.h"
 #include "mapping_segment.h"
 #include "reference_segment.h"
 #include "flux_euler_1d.h"
 #include "convective_flux_div_1d.h"
+#include "variable_order_layout.h"
+#include "cell_partition.h"
+#include "execution_space.h"
+#include "halo_exchange_1d.h"
 
 
 // host code of the problem of euler equation in one dimensional space
-template<typename T>
+// MESH - 1D mesh type, e.g., uniform_cartesian_mesh_1d or cartesian_mesh_1d
+// HALO - halo exchange of the traces at the ends of the mesh, which is the range of the
+//        cells of a rank in a distributed run (see halo_exchange_1d.h)
+// SPACE - execution space of the face and element loops (see execution_space.h)
+//
+// The order can vary from cell to cell (see variable_order_layout); the element loop runs
+// over the buckets of the cells of the same order, each with the kernel of its order, and
+// the numerical fluxes between cells of different orders need no interpolation in 1D
+// since the LGL nodes include the end points, i.e., the traces are nodal values.
+//
+// The volume phase runs over the parts of a cell_partition of the bucketed order of the
+// cells, balanced in the flux differencing costs, a few parts per thread of the space,
+// and first_touch() places the pages of the nodes by the same parts.
+template<typename T, typename MESH = rdg::uniform_cartesian_mesh_1d<T>, typename HALO = rdg::no_halo_1d,
+         typename SPACE = rdg::serial_space>
 class euler_1d
 {
 public:
   euler_1d(std::size_t numCells, int order)
-    : m_numCells(numCells), m_order(order), m_mesh((T)(0), (T)(1), numCells) {}
+    : m_numCells(numCells), m_layout(numCells, order), m_mesh((T)(0), (T)(1), numCells),
+      m_partition(volume_partition()) {}
+
+  // the mesh is of [0, 1] as the one of the above constructor, or a contiguous part of it
+  // whose ends inside [0, 1] are connected to the neighboring parts by the HALO (see
+  // set_halo()); only the physical ends 0 and 1 take the inflow/outflow conditions
+  euler_1d(const MESH& mesh, int order)
+    : m_numCells(mesh.num_cells()), m_layout(mesh.num_cells(), order), m_mesh(mesh),
+      m_partition(volume_partition()) {}
+
+  // orders of the cells given by the layout
+  euler_1d(const MESH& mesh, const rdg::variable_order_layout& layout)
+    : m_numCells(mesh.num_cells()), m_layout(layout), m_mesh(mesh), m_partition(volume_partition())
+  { assert(layout.num_cells() == m_numCells); }
   ~euler_1d(){}
 
   T gamma() const { return s_gamma; }
 
-  int num_nodes() const { return m_numCells * (m_order + 1); }
+  int num_nodes() const { return m_layout.num_dofs(); }
+
+  const rdg::variable_order_layout& layout() const { return m_layout; }
+
+  // the face and element loops run on the execution space, whose grain cost is in faces,
+  // nodes, or two-point fluxes of the elements
+  void set_execution_space(const SPACE& space)
+  {
+    m_space = space;
+    m_partition = volume_partition();
+  }
+
+  const SPACE& execution_space() const { return m_space; }
+
+  // the states beyond the ends of the mesh come from the halo exchange where it has
+  // neighbors, otherwise from the boundary conditions; both ranks of the face between
+  // two ranges compute its numerical flux, so only the traces are exchanged
+  void set_halo(HALO* halo) { m_halo = halo; }
 
   // the layout of DOFs in memory are different for CPU execution and GPU execution;
   // the first iterator sets the node positions and the second iterator sets the
@@ -59,6 +109,13 @@ public:
   template<typename OutputIterator1, typename OutputZipIterator2>
   void initialize_dofs(OutputIterator1 it1, OutputZipIterator2 it2) const;
 
+  // sets the values of the nodes, e.g., the positions or the solution allocated by
+  // rdg::default_init_allocator, by the parts of the volume phase on the space, so that
+  // their pages are first touched by, i.e., placed on the NUMA nodes of, the threads that
+  // run the elements; call it after set_execution_space()
+  template<typename OutputIterator, typename V>
+  void first_touch(OutputIterator it, const V& value) const;
+
   // suggested next timestep size
   // input is the solution at the current timestep
   template<typename InputZipIterator>
@@ -71,21 +128,51 @@ public:
   using variable_type = boost::tuple<T, T, T>;
 
 private:
-  template<typename ConstItr>
-  void numerical_fluxes(ConstItr cbegin, T t) const; // time t is used for boundary conditions
+  // numerical fluxes of the faces [begin, end); the faces at the ends of the mesh take the
+  // states from the halo, once its exchange finished, or from the boundary conditions
+  template<typename ConstZipItr>
+  void numerical_fluxes(ConstZipItr cbegin, std::size_t begin, std::size_t end, T t) const; // time t is used for boundary conditions
+
+  // calls f(divOp, np) with the divergence operator of the order, i.e., the kernel of the
+  // fixed order if there is one
+  template<typename F>
+  void with_div_op(int order, F&& f) const;
+
+  // the partition of the bucketed order into s_partsPerThread parts per thread of the space
+  // weighted by the flux differencing costs of the cells, i.e., their two-point fluxes
+  rdg::cell_partition volume_partition() const;
+
+  // cost hint of the part p in the volume phase
+  T part_cost(std::size_t p) const { return static_cast<T>(m_partition.part_weight(static_cast<int>(p))); }
+
+  // calls f(divOp, np, first, last) on the cells [first, last) of each bucket that are at
+  // the positions [begin, end) of the bucketed order of the layout
+  template<typename F>
+  void for_each_bucket(std::size_t begin, std::size_t end, F&& f) const;
+
+  // element loops of the spatial discrete operator over the cells [first, last) of np nodes,
+  // given the divergence operator: the volume phase leaves the volume integrals in out,
+  // which the surface phase completes, skipping the cells at the ends of the mesh if asked
+  template<typename DivOp, typename ConstZipItr, typename ZipItr>
+  void volume_phase(DivOp& divOp, int np, const std::size_t* first, const std::size_t* last,
+                    ConstZipItr in_cbegin, ZipItr out_begin) const;
+
+  template<typename DivOp, typename ConstZipItr, typename ZipItr>
+  void surface_phase(DivOp& divOp, int np, const std::size_t* first, const std::size_t* last,
+                     ConstZipItr in_cbegin, ZipItr out_begin, bool skipEnds) const;
 
   // re-direct the search for the unary operator- to the rdg name space
   static variable_type negative(const variable_type& v) { return rdg::operator-(v); }
 
 private:
-  using mesh_type         = rdg::uniform_cartesian_mesh_1d<T>;
+  using mesh_type         = MESH;
   using mapping_type      = rdg::mapping_segment;
   using reference_element = rdg::reference_segment<T>;
   using flux_calculator   = flux_euler_1d<T>;
 
   // numerical scheme data (could be constants if never change)
   std::size_t m_numCells;
-  int m_order;
+  rdg::variable_order_layout m_layout;
 
   // problem definitions
   const mesh_type m_mesh;
@@ -93,18 +180,28 @@ private:
 
   // work space for numerical fluxes
   mutable std::vector<variable_type> m_numericalFluxes;
+
+  // parallel execution
+  SPACE m_space;
+  rdg::cell_partition m_partition;
+  static constexpr unsigned s_partsPerThread = 4;
+
+  // distributed execution
+  HALO* m_halo = nullptr;
+  mutable variable_type m_haloLeft;
+  mutable variable_type m_haloRight;
 };
 
-template<typename T> template<typename OutputIterator1, typename OutputZipIterator2>
-void euler_1d<T>::initialize_dofs(OutputIterator1 it1, OutputZipIterator2 it2) const
+template<typename T, typename MESH, typename HALO, typename SPACE> template<typename OutputIterator1, typename OutputZipIterator2>
+void euler_1d<T, MESH, HALO, SPACE>::initialize_dofs(OutputIterator1 it1, OutputZipIterator2 it2) const
 {
-  reference_element refElem(m_order);
-  std::vector<T> pos;
-  refElem.node_positions(std::back_inserter(pos));
+  std::vector<std::vector<T>> positions(m_layout.max_order() + 1);
 
   // conserved variables, not primary variables
   for (std::size_t i = 0; i < m_numCells; ++i)
   {
+    std::vector<T>& pos = positions[m_layout.order(i)];
+    if (pos.empty()) reference_element(m_layout.order(i)).node_positions(std::back_inserter(pos));
     auto cell= m_mesh.get_cell(i);
     for (std::size_t j = 0; j < pos.size(); ++j)
     {
@@ -117,64 +214,178 @@ void euler_1d<T>::initialize_dofs(OutputIterator1 it1, OutputZipIterator2 it2) c
   }
 }
 
-template<typename T> template<typename InputZipIterator>
-T euler_1d<T>::timestep_size(InputZipIterator it) const
+template<typename T, typename MESH, typename HALO, typename SPACE> template<typename OutputIterator, typename V>
+void euler_1d<T, MESH, HALO, SPACE>::first_touch(OutputIterator it, const V& value) const
 {
-  T rho, rhou, E;
+  auto touch = [&](std::size_t begin, std::size_t end)
+  {
+    for (std::size_t k = m_partition.part_begin(begin); k < m_partition.part_end(end - 1); ++k)
+    {
+      std::size_t i = m_layout.bucketed_cell(k);
+      for (std::size_t j = m_layout.offset(i); j < m_layout.offset(i) + m_layout.num_nodes(i); ++j)
+        *(it + j) = value;
+    }
+  };
 
-  T maxV = std::numeric_limits<T>::lowest();
-  for (std::size_t i = 0; i < num_nodes(); ++i)
+  rdg::parallel_for_static(m_space, m_partition.num_parts(), [this](std::size_t p) { return part_cost(p); }, touch);
+}
+
+template<typename T, typename MESH, typename HALO, typename SPACE>
+rdg::cell_partition euler_1d<T, MESH, HALO, SPACE>::volume_partition() const
+{
+  std::vector<std::size_t> bucketed(m_numCells);
+  std::vector<double> weights(m_numCells);
+  for (std::size_t k = 0; k < m_numCells; ++k)
   {
-    boost::tie(rho, rhou, E) = *it++;
+    bucketed[k] = m_layout.bucketed_cell(k);
+    weights[bucketed[k]] = rdg::flux_differencing_cost(m_layout.order(bucketed[k]), 1);
+  }
+
+  std::size_t numParts = std::min<std::size_t>(std::max<std::size_t>(m_numCells, 1), s_partsPerThread * m_space.concurrency());
+  return rdg::cell_partition(rdg::cell_permutation(std::move(bucketed)), weights, static_cast<int>(numParts));
+}
+
+template<typename T, typename MESH, typename HALO, typename SPACE> template<typename InputZipIterator>
+T euler_1d<T, MESH, HALO, SPACE>::timestep_size(InputZipIterator it) const
+{
+  T maxV = rdg::parallel_reduce(m_space, num_nodes(), std::numeric_limits<T>::lowest(), [&](std::size_t i, T& partial)
+  {
+    T rho, rhou, E;
+    boost::tie(rho, rhou, E) = *(it + i);
     T u = rhou / rho;
     T p = (E - rhou * u / static_cast<T>(2)) * (s_gamma - static_cast<T>(1)); 
     T v = std::abs(u) + std::sqrt(s_gamma * p / rho);
-    if (v > maxV) maxV = v;
-  }
+    if (v > partial) partial = v;
+  }, [](T a, T b) { return std::max(a, b); });
 
-  return static_cast<T>(0.25) / (maxV * static_cast<T>(m_mesh.num_cells())) / static_cast<T>(m_order);
+  return static_cast<T>(0.25) * m_mesh.min_cell_size() / maxV / static_cast<T>(m_layout.max_order());
 }
 
-template<typename T> template<typename ConstZipItr>
-void euler_1d<T>::numerical_fluxes(ConstZipItr cbegin, T t) const
+template<typename T, typename MESH, typename HALO, typename SPACE> template<typename ConstZipItr>
+void euler_1d<T, MESH, HALO, SPACE>::numerical_fluxes(ConstZipItr cbegin, std::size_t begin, std::size_t end, T t) const
 {
   flux_calculator fluxCalculator(s_gamma);
 
   std::size_t numFluxes = m_numCells + 1;
-  if (m_numericalFluxes.size() < numFluxes) m_numericalFluxes.resize(numFluxes);
+  bool haloLeft = m_halo && m_halo->has_left(), haloRight = m_halo && m_halo->has_right();
 
   variable_type a, b;
-  int np = reference_element(m_order).num_nodes();
-  for (std::size_t i = 0; i < numFluxes; ++i)
+  for (std::size_t i = begin; i < end; ++i)
   {
-    if (i > 0) a = *(cbegin + (i * np - 1));
+    if (i > 0) a = *(cbegin + (m_layout.offset(i) - 1));
+    else if (haloLeft) a = m_haloLeft;
     // inflow boundary condition
     else a = boost::make_tuple(static_cast<T>(1), static_cast<T>(0), static_cast<T>(1) / (s_gamma - static_cast<T>(1)));
-    if (i < numFluxes - 1) b = *(cbegin + (i * np));
+    if (i < numFluxes - 1) b = *(cbegin + m_layout.offset(i));
+    else if (haloRight) b = m_haloRight;
     // outflow boundary condition
     else b = boost::make_tuple(T(0.125), static_cast<T>(0), T(0.1) / (s_gamma - static_cast<T>(1))); //*(cbegin + (i * np - 1));
     m_numericalFluxes[i] = fluxCalculator.numerical_surface_flux(a, b, 1);
   }
 }
 
-template<typename T> template<typename ConstZipItr, typename ZipItr>
-void euler_1d<T>::operator()(ConstZipItr in_cbegin, std::size_t size, T t, ZipItr out_begin) const
+// The phases are ordered so that the work waiting for the neighbors comes last: the halo
+// exchange of the traces starts first, the volume integration of all elements, which
+// needs no data of the neighbors and dominates at high orders, hides its latency, then
+// the interior faces and the elements away from the ends of the mesh follow, and only
+// the two faces at the ends and their elements wait for the exchange to finish.
+template<typename T, typename MESH, typename HALO, typename SPACE> template<typename ConstZipItr, typename ZipItr>
+void euler_1d<T, MESH, HALO, SPACE>::operator()(ConstZipItr in_cbegin, std::size_t size, T t, ZipItr out_begin) const
 {
-  numerical_fluxes(in_cbegin, t);
+  std::size_t numFluxes = m_numCells + 1;
+  if (m_numericalFluxes.size() < numFluxes) m_numericalFluxes.resize(numFluxes);
+
+  if (m_halo) m_halo->start(variable_type(*in_cbegin), variable_type(*(in_cbegin + (num_nodes() - 1))));
+
+  // the cost of an element is about the number of its two-point fluxes in the volume
+  // phase, as in the weights of the partition, and the number of its nodes in the surface phase
+  auto np = [this](std::size_t k) { return static_cast<T>(m_layout.order(m_layout.bucketed_cell(k)) + 1); };
+  rdg::team_for(m_space, m_partition.num_parts(), [this](std::size_t p) { return part_cost(p); }, [&](const rdg::team_member& team)
+  {
+    for_each_bucket(m_partition.part_begin(team.league_begin()), m_partition.part_end(team.league_end() - 1),
+                    [&](auto& divOp, int n, const std::size_t* first, const std::size_t* last)
+    { volume_phase(divOp, n, first, last, in_cbegin, out_begin); });
+  });
+
+  rdg::parallel_for(m_space, numFluxes - 2, [](std::size_t) { return static_cast<T>(1); }, [&](std::size_t begin, std::size_t end)
+  { numerical_fluxes(in_cbegin, begin + 1, end + 1, t); });
+
+  rdg::team_for(m_space, m_numCells, np, [&](const rdg::team_member& team)
+  {
+    for_each_bucket(team.league_begin(), team.league_end(), [&](auto& divOp, int n, const std::size_t* first, const std::size_t* last)
+    { surface_phase(divOp, n, first, last, in_cbegin, out_begin, true); });
+  });
 
-  reference_element refElem(m_order);
+  if (m_halo) m_halo->finish(m_haloLeft, m_haloRight);
+  numerical_fluxes(in_cbegin, 0, 1, t);
+  numerical_fluxes(in_cbegin, numFluxes - 1, numFluxes, t);
+  const std::size_t ends[2] = {0, m_numCells - 1};
+  for (std::size_t k = 0; k < (m_numCells > 1 ? 2 : 1); ++k)
+    with_div_op(m_layout.order(ends[k]), [&](auto& divOp, int n)
+    { surface_phase(divOp, n, ends + k, ends + k + 1, in_cbegin, out_begin, false); });
+}
+
+template<typename T, typename MESH, typename HALO, typename SPACE> template<typename F>
+void euler_1d<T, MESH, HALO, SPACE>::with_div_op(int order, F&& f) const
+{
   flux_calculator fluxCalculator(s_gamma);
-  rdg::convective_flux_div_1d<reference_element, flux_calculator> divOp(refElem, fluxCalculator);
 
-  int np = refElem.num_nodes();
+  // kernels of fixed orders use the compile-time tables of the reference element
+  bool fixedOrder = rdg::dispatch_fixed_order(order, [&](auto o)
+  {
+    rdg::fixed_order_convective_flux_div_1d<decltype(o)::value, flux_calculator> divOp(fluxCalculator);
+    f(divOp, decltype(o)::value + 1);
+  });
+
+  if (!fixedOrder)
+  {
+    reference_element refElem(order);
+    rdg::convective_flux_div_1d<reference_element, flux_calculator> divOp(refElem, fluxCalculator);
+    f(divOp, static_cast<int>(refElem.num_nodes()));
+  }
+}
+
+template<typename T, typename MESH, typename HALO, typename SPACE> template<typename F>
+void euler_1d<T, MESH, HALO, SPACE>::for_each_bucket(std::size_t begin, std::size_t end, F&& f) const
+{
+  for (std::size_t b = 0; b < m_layout.num_buckets(); ++b)
+  {
+    std::size_t lo = std::max(begin, m_layout.bucket_offset(b)), hi = std::min(end, m_layout.bucket_offset(b + 1));
+    if (lo >= hi) continue;
+    const std::size_t* first = m_layout.bucket_begin(b) + (lo - m_layout.bucket_offset(b));
+    const std::size_t* last = first + (hi - lo);
+    with_div_op(m_layout.bucket_order(b), [&](auto& divOp, int np) { f(divOp, np, first, last); });
+  }
+}
+
+template<typename T, typename MESH, typename HALO, typename SPACE> template<typename DivOp, typename ConstZipItr, typename ZipItr>
+void euler_1d<T, MESH, HALO, SPACE>::volume_phase(DivOp& divOp, int np, const std::size_t* first, const std::size_t* last,
+                                           ConstZipItr in_cbegin, ZipItr out_begin) const
+{
   std::vector<variable_type> cellOut(np);
-  for (std::size_t cell = 0; cell < m_numCells; ++cell)
+  for (const std::size_t* it = first; it != last; ++it)
   {
-    auto cellGeom = m_mesh.get_cell(cell);
-    T J = mapping_type::J(std::get<0>(cellGeom), std::get<1>(cellGeom));
-    divOp.apply(in_cbegin + np * cell, m_numericalFluxes.cbegin() + cell, J, cellOut.begin());
+    std::size_t offset = m_layout.offset(*it);
+    divOp.apply_volume(in_cbegin + offset, cellOut.begin());
+
+    for(int i = 0; i < np; ++i) *(out_begin + offset + i) = cellOut[i];
+  }
+}
+
+template<typename T, typename MESH, typename HALO, typename SPACE> template<typename DivOp, typename ConstZipItr, typename ZipItr>
+void euler_1d<T, MESH, HALO, SPACE>::surface_phase(DivOp& divOp, int np, const std::size_t* first, const std::size_t* last,
+                                            ConstZipItr in_cbegin, ZipItr out_begin, bool skipEnds) const
+{
+  std::vector<variable_type> cellOut(np);
+  for (const std::size_t* it = first; it != last; ++it)
+  {
+    std::size_t cell = *it, offset = m_layout.offset(cell);
+    if (skipEnds && (cell == 0 || cell + 1 == m_numCells)) continue;
+
+    for(int i = 0; i < np; ++i) cellOut[i] = *(out_begin + offset + i);
+    divOp.apply_surface(in_cbegin + offset, m_numericalFluxes.cbegin() + cell, m_mesh.J(cell), cellOut.begin());
 
-    for(int i = 0; i < np; ++i) *(out_begin + np * cell + i) = negative(cellOut[i]);
+    for(int i = 0; i < np; ++i) *(out_begin + offset + i) = negative(cellOut[i]);
   }
 }
 
@@ -20,15 +20,47 @@
  
 #include <vector>
 #include <iostream>
-#include <fstream>
 #include <limits>
 #include <chrono>
+#include <string>
+#include <stdexcept>
+#include <memory>
 
 #include <boost/iterator/zip_iterator.hpp>
 #include <boost/tuple/tuple.hpp> // boost::tuple works with boost::zip_iterator
 
 #include "euler_1d.h"
 #include "explicit_runge_kutta.h"
+#include "modal_basis.h"
+#include "default_init_allocator.h"
+#include "async_writer.h"
+#include "checkpoint.h"
+#include "vtu_writer.h"
+#include "text_writer.h"
+
+// writes the density, velocity and pressure of the snapshot of the columns x, rho, rhou
+// and E to the file of its name
+void write_sod(const rdg::async_writer<double>::snapshot& s, double gamma)
+{
+  const std::vector<double>& x = s.columns[0];
+  const std::vector<double>& d = s.columns[1];
+  const std::vector<double>& m = s.columns[2];
+  const std::vector<double>& e = s.columns[3];
+  std::size_t numNodes = x.size();
+
+  // on the writer thread, so serially: the thread pool is busy with the time loop
+  rdg::serial_space space;
+  auto xs = [&](std::size_t i) { return x[i]; };
+  rdg::text_writer file(s.name, rdg::text_format{std::chars_format::general, std::numeric_limits<double>::digits10});
+  file.write_text("#         x         rho\n");
+  file.write_columns(space, numNodes, "  ", xs, [&](std::size_t i) { return d[i]; });
+  file.write_text("\n#         x         u\n");
+  file.write_columns(space, numNodes, "  ", xs, [&](std::size_t i) { return m[i] / d[i]; });
+  file.write_text("\n#         x         p\n");
+  file.write_columns(space, numNodes, "  ", xs,
+                     [&](std::size_t i) { return (gamma - 1.) * (e[i] - m[i] * m[i] / (2. * d[i])); });
+  file.close();
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 // Program main
@@ -37,85 +69,164 @@ int main(int argc, char **argv) {
 
   int numCells = 1024;
   int order = 2;
+  bool useFilter = false;
+  int numThreads = 1;
+  int dumpInterval = 0;
+  int checkpointInterval = 0;
+  std::string restartFile;
+  rdg::thread_affinity affinity = rdg::thread_affinity::none;
   if (argc > 1)
   {
     numCells = std::atoi(argv[1]);
     order = std::atoi(argv[2]);
   }
+  if (argc > 3) useFilter = std::string(argv[3]) == "filter";
+  if (argc > 4) numThreads = std::atoi(argv[4]);
+  if (argc > 5) affinity = rdg::thread_affinity_from_string(argv[5]); // compact or scatter
+  if (argc > 6) dumpInterval = std::atoi(argv[6]); // time steps between two dumps, 0 for none
+  if (argc > 7) checkpointInterval = std::atoi(argv[7]); // time steps between two checkpoints, 0 for none
+  if (argc > 8) restartFile = argv[8]; // checkpoint to restart from
+
+  // a restart takes the mesh, the orders and the solution from the mapped checkpoint
+  std::unique_ptr<rdg::mapped_checkpoint<double>> restart;
+  if (!restartFile.empty())
+  {
+    restart = std::make_unique<rdg::mapped_checkpoint<double>>(restartFile);
+    if (!restart->verify() || restart->num_variables() != 3)
+      throw std::runtime_error("corrupt checkpoint " + restartFile);
+    numCells = restart->num_cells();
+  }
+  rdg::uniform_cartesian_mesh_1d<double> mesh = restart ?
+    rdg::uniform_cartesian_mesh_1d<double>(restart->vertices()[0], restart->vertices()[numCells], numCells) :
+    rdg::uniform_cartesian_mesh_1d<double>(0., 1., numCells);
+  rdg::variable_order_layout layout = restart ? restart->layout() : rdg::variable_order_layout(numCells, order);
+  order = layout.max_order();
+
+  // the loops of the spatial operator and of the time integration run on OpenMP if it is
+  // enabled (OPENMP=1 in the makefile; the affinity is then given by OMP_PROC_BIND), or
+  // on a pool of threads otherwise
+#ifdef _OPENMP
+  using space_type = rdg::openmp_space;
+  omp_set_num_threads(numThreads);
+  space_type space;
+#else
+  using space_type = rdg::thread_pool_space;
+  rdg::work_stealing_scheduler scheduler(numThreads, affinity);
+  space_type space(numThreads > 1 ? &scheduler : nullptr);
+#endif
+  using operator_type = euler_1d<double, rdg::uniform_cartesian_mesh_1d<double>, rdg::no_halo_1d, space_type>;
+
+  operator_type op(mesh, layout);
+  op.set_execution_space(space);
 
-  euler_1d<double> op(numCells, order);
+  // the vectors are left uninitialized by their allocator and first touched by the threads
+  // of the loops that stream them, so that their pages are on the NUMA nodes of the threads:
+  // the positions and the solution by the parts of the element loop, the work space of the
+  // Runge-Kutta loop by the static ranges of its updates
+  using dof_vector = std::vector<double, rdg::default_init_allocator<double>>;
+  const operator_type::variable_type zero(0., 0., 0.);
 
   // node positions and initial conditions
   int numNodes = op.num_nodes();
-  std::vector<double> x(numNodes);
-  std::vector<double> d(numNodes); // density rho
-  std::vector<double> m(numNodes); // momentum rhou
-  std::vector<double> e(numNodes); // energy
+  dof_vector x(numNodes);
+  dof_vector d(numNodes); // density rho
+  dof_vector m(numNodes); // momentum rhou
+  dof_vector e(numNodes); // energy
   auto varItr = boost::make_zip_iterator(boost::make_tuple(d.begin(), m.begin(), e.begin()));
+  op.first_touch(x.begin(), 0.);
+  op.first_touch(varItr, zero);
   op.initialize_dofs(x.begin(), varItr);
+  if (restart)
+  {
+    restart->read_variable(0, d.data(), space);
+    restart->read_variable(1, m.data(), space);
+    restart->read_variable(2, e.data(), space);
+  }
 
   // allocate work space for the Runge-Kutta loop
-  std::vector<double> d1(numNodes);
-  std::vector<double> m1(numNodes);
-  std::vector<double> e1(numNodes);
+  dof_vector d1(numNodes);
+  dof_vector m1(numNodes);
+  dof_vector e1(numNodes);
   auto var1Itr = boost::make_zip_iterator(boost::make_tuple(d1.begin(), m1.begin(), e1.begin()));
-  std::vector<double> d2(numNodes);
-  std::vector<double> m2(numNodes);
-  std::vector<double> e2(numNodes);
+  rdg::first_touch_n(space, var1Itr, numNodes, zero);
+  dof_vector d2(numNodes);
+  dof_vector m2(numNodes);
+  dof_vector e2(numNodes);
   auto var2Itr = boost::make_zip_iterator(boost::make_tuple(d2.begin(), m2.begin(), e2.begin()));
-  std::vector<double> d3(numNodes);
-  std::vector<double> m3(numNodes);
-  std::vector<double> e3(numNodes);
+  rdg::first_touch_n(space, var2Itr, numNodes, zero);
+  dof_vector d3(numNodes);
+  dof_vector m3(numNodes);
+  dof_vector e3(numNodes);
   auto var3Itr = boost::make_zip_iterator(boost::make_tuple(d3.begin(), m3.begin(), e3.begin()));
-  std::vector<double> d4(numNodes);
-  std::vector<double> m4(numNodes);
-  std::vector<double> e4(numNodes);
+  rdg::first_touch_n(space, var3Itr, numNodes, zero);
+  dof_vector d4(numNodes);
+  dof_vector m4(numNodes);
+  dof_vector e4(numNodes);
   auto var4Itr = boost::make_zip_iterator(boost::make_tuple(d4.begin(), m4.begin(), e4.begin()));
-  std::vector<double> d5(numNodes);
-  std::vector<double> m5(numNodes);
-  std::vector<double> e5(numNodes);
+  rdg::first_touch_n(space, var4Itr, numNodes, zero);
+  dof_vector d5(numNodes);
+  dof_vector m5(numNodes);
+  dof_vector e5(numNodes);
   auto var5Itr = boost::make_zip_iterator(boost::make_tuple(d5.begin(), m5.begin(), e5.begin()));
+  rdg::first_touch_n(space, var5Itr, numNodes, zero);
+
+  // optional exponential filter of the stage solutions to stabilize under-resolved runs
+  auto filter = rdg::spectral_filter<double>::exponential(order, 0, 16);
+  auto stageFilter = [&](auto itr, std::size_t size)
+  { if (useFilter) filter.apply<decltype(itr), operator_type::variable_type>(itr, size); };
+
+  // the dumps and the final output are serialized on a writer thread while the time loop
+  // continues; it only waits for the writer if both staging buffers are still in use
+  rdg::async_writer<double> writer([&op](const auto& s) { write_sod(s, op.gamma()); });
+  auto dump = [&](const std::string& name, double time)
+  { writer.write(name, time, numNodes, x.cbegin(), d.cbegin(), m.cbegin(), e.cbegin()); };
 
   // time advancing loop
   int maxNumTS = 10000;
   double T = 0.2;
-  double t = 0.0;
-  double dt = op.timestep_size(varItr);
+  double t = restart ? restart->time() : 0.0;
+  double dt = restart ? restart->dt() : op.timestep_size(varItr);
   std::cout << "dt = " << dt << std::endl;
 
   auto t0 = std::chrono::system_clock::now();
-  int numTS = 0;
+  int numTS = restart ? static_cast<int>(restart->step()) : 0;
+  restart.reset();
   while (t < T && numTS < maxNumTS)
   {
-    rdg::rk4(varItr, numNodes, t, dt, op, var1Itr, var2Itr, var3Itr, var4Itr, var5Itr);
+    rdg::rk4(space, varItr, numNodes, t, dt, op, stageFilter, var1Itr, var2Itr, var3Itr, var4Itr, var5Itr);
     t += dt;
     numTS++;
 
     dt = op.timestep_size(varItr);
     if ((t + dt) > T) dt = T - t;
     std::cout << "t = " << t << ", next dt = " << dt << std::endl;
+
+    if (dumpInterval > 0 && numTS % dumpInterval == 0)
+      dump("SodShockTubeProblem_" + std::to_string(numTS) + ".txt", t);
+    if (checkpointInterval > 0 && numTS % checkpointInterval == 0)
+    {
+      // the checkpoints are compressed losslessly, so a restart is bitwise, on the threads
+      // of the solver
+      std::uint64_t bytes = rdg::save_checkpoint<double>("SodShockTubeProblem.ckpt", mesh, layout, numTS, t, dt,
+                                                         {d.data(), m.data(), e.data()}, rdg::checkpoint_compression::lossless,
+                                                         space);
+      std::cout << "checkpoint at step " << numTS << ", compression ratio = " << 3. * numNodes * sizeof(double) / bytes << std::endl;
+    }
   }
   auto t1 = std::chrono::system_clock::now();
+  std::cout << "elapsed time = " << std::chrono::duration<double>(t1 - t0).count() << " s with "
+            << numThreads << " thread(s)" << std::endl;
 
   // output to visualize
-  std::ofstream file;
-  file.open("SodShockTubeProblem.txt");
-  file.precision(std::numeric_limits<double>::digits10);
-  file << "#         x         rho" << std::endl;
-  for(int i = 0; i < numNodes; ++i)
-    file << x[i] << "  " << d[i] << std::endl;
-  file << std::endl;
-  file << "#         x         u" << std::endl;
-  for(int i = 0; i < numNodes; ++i)
-    file << x[i] << "  " << m[i] / d[i] << std::endl;
-  file << std::endl;
-  file << "#         x         p" << std::endl;
-  for(int i = 0; i < numNodes; ++i)
-  {
-    double p = (op.gamma() - 1.) * (e[i] - m[i] * m[i] / (2. * d[i]));
-    file << x[i] << "  " << p << std::endl;
-  }
-  file.close();
+  dump("SodShockTubeProblem.txt", t);
+
+  // and for ParaView, a piece per thread written concurrently from the solution buffers
+  const rdg::variable_order_layout& opLayout = op.layout();
+  rdg::write_vtu_pieces<space_type, double>(space, "SodShockTubeProblem", space.concurrency(), rdg::vtk_lagrange_cell::curve, numCells,
+    [&](std::size_t c) { return opLayout.order(c); }, [&](std::size_t c) { return opLayout.offset(c); },
+    {x.data(), nullptr, nullptr}, {{"rho", d.data()}, {"rhou", m.data()}, {"E", e.data()}});
+  writer.flush();
+  std::cout << "output stalls = " << writer.num_stalls() << " (" << writer.stall_seconds() << " s)" << std::endl;
 
   return 0;
 }
@@ -0,0 +1,178 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+ 
+#include <vector>
+#include <iostream>
+#include <limits>
+#include <chrono>
+#include <memory>
+#include <cmath>
+#include <algorithm>
+
+#include <boost/iterator/zip_iterator.hpp>
+#include <boost/tuple/tuple.hpp> // boost::tuple works with boost::zip_iterator
+
+#include "euler_1d.h"
+#include "explicit_runge_kutta.h"
+#include "adaptive_mesh_1d.h"
+#include "text_writer.h"
+
+using mesh_type = rdg::adaptive_mesh_1d<double>;
+using operator_type = euler_1d<double, mesh_type>;
+
+// conservative variables at the nodes
+struct state
+{
+  std::vector<double> d; // density rho
+  std::vector<double> m; // momentum rhou
+  std::vector<double> e; // energy
+
+  void resize(std::size_t n) { d.resize(n); m.resize(n); e.resize(n); }
+
+  auto begin() { return boost::make_zip_iterator(boost::make_tuple(d.begin(), m.begin(), e.begin())); }
+
+  auto cbegin() const { return boost::make_zip_iterator(boost::make_tuple(d.cbegin(), m.cbegin(), e.cbegin())); }
+};
+
+// refine the cells where the density varies, within the cell or across its faces, and
+// coarsen where the solution is flat but away from the refined cells, so that the waves
+// stay in the refined region until the next adaptation
+std::vector<int> density_variation_flags(const mesh_type& mesh, int np, const std::vector<double>& d,
+                                         double refineAbove, double coarsenBelow)
+{
+  std::size_t n = mesh.num_cells();
+  auto variation = [&](std::size_t i)
+  {
+    std::size_t begin = i > 0 ? i * np - 1 : 0;
+    std::size_t end = i + 1 < n ? (i + 1) * np + 1 : n * np;
+    auto minmax = std::minmax_element(d.begin() + begin, d.begin() + end);
+    return (*minmax.second - *minmax.first) / *minmax.first;
+  };
+  std::vector<int> flags = rdg::mark_cells(n, variation, refineAbove, coarsenBelow);
+
+  // no coarsening within two cells of a refined one
+  std::vector<int> buffered(flags);
+  for (std::size_t i = 0; i < n; ++i)
+    if (flags[i] > 0)
+      for (std::size_t k = (i > 1 ? i - 2 : 0); k < std::min(i + 3, n); ++k)
+        buffered[k] = std::max(buffered[k], 0);
+  return buffered;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Program main
+////////////////////////////////////////////////////////////////////////////////
+int main(int argc, char **argv) {
+
+  int numRoots = 64;
+  int maxLevel = 4;
+  int order = 2;
+  if (argc > 2)
+  {
+    numRoots = std::atoi(argv[1]);
+    maxLevel = std::atoi(argv[2]);
+  }
+  if (argc > 3) order = std::atoi(argv[3]);
+  const int np = order + 1;
+  const double refineAbove = 1.e-2;
+  const double coarsenBelow = 1.e-3;
+  const int adaptInterval = 4; // time steps between two adaptations
+
+  // refine the initial mesh around the discontinuity of the initial conditions
+  mesh_type mesh(0., 1., numRoots, maxLevel);
+  std::unique_ptr<operator_type> op;
+  std::vector<double> x;
+  state u;
+  for (int level = 0; level <= maxLevel; ++level)
+  {
+    op = std::make_unique<operator_type>(mesh, order);
+    x.resize(op->num_nodes());
+    u.resize(op->num_nodes());
+    op->initialize_dofs(x.begin(), u.begin());
+    if (!mesh.adapt(density_variation_flags(mesh, np, u.d, refineAbove, coarsenBelow))) break;
+  }
+
+  // work space for the Runge-Kutta loop, resized with the mesh
+  state w[5];
+  state transferred;
+  auto resize_work = [&](std::size_t n) { for (auto& wk : w) wk.resize(n); };
+  resize_work(op->num_nodes());
+
+  // time advancing loop
+  int maxNumTS = 100000;
+  double T = 0.2;
+  double t = 0.0;
+  double dt = op->timestep_size(u.cbegin());
+  std::cout << "dt = " << dt << std::endl;
+
+  auto t0 = std::chrono::system_clock::now();
+  int numTS = 0;
+  std::size_t maxNumCells = mesh.num_cells();
+  double sumNumCells = 0.;
+  while (t < T && numTS < maxNumTS)
+  {
+    rdg::rk4(u.begin(), op->num_nodes(), t, dt, *op, w[0].begin(), w[1].begin(), w[2].begin(), w[3].begin(), w[4].begin());
+    t += dt;
+    numTS++;
+    sumNumCells += mesh.num_cells();
+
+    if (numTS % adaptInterval == 0 && mesh.adapt(density_variation_flags(mesh, np, u.d, refineAbove, coarsenBelow)))
+    {
+      op = std::make_unique<operator_type>(mesh, order);
+      transferred.resize(op->num_nodes());
+      mesh.transfer<decltype(u.cbegin()), decltype(transferred.begin()), operator_type::variable_type>(
+        np, u.cbegin(), transferred.begin());
+      std::swap(u, transferred);
+      resize_work(op->num_nodes());
+      maxNumCells = std::max(maxNumCells, mesh.num_cells());
+    }
+
+    dt = op->timestep_size(u.cbegin());
+    if ((t + dt) > T) dt = T - t;
+  }
+  auto t1 = std::chrono::system_clock::now();
+
+  std::size_t uniformNumCells = static_cast<std::size_t>(numRoots) << maxLevel;
+  std::cout << "number of time steps = " << numTS << std::endl;
+  std::cout << "number of cells: final = " << mesh.num_cells() << ", maximum = " << maxNumCells
+            << ", average = " << sumNumCells / numTS << ", uniform at the finest level = " << uniformNumCells << std::endl;
+  std::cout << "elapsed time = " << std::chrono::duration<double>(t1 - t0).count() << " s" << std::endl;
+
+  // output to visualize
+  x.resize(op->num_nodes());
+  state u0;
+  u0.resize(op->num_nodes());
+  op->initialize_dofs(x.begin(), u0.begin());
+  rdg::serial_space space;
+  std::size_t numNodes = op->num_nodes();
+  auto xs = [&](std::size_t i) { return x[i]; };
+  rdg::text_writer file("SodShockTubeProblem.txt", rdg::text_format{std::chars_format::general, std::numeric_limits<double>::digits10});
+  file.write_text("#         x         rho         level\n");
+  file.write_columns(space, numNodes, "  ", xs, [&](std::size_t i) { return u.d[i]; },
+                     [&](std::size_t i) { return mesh.level(i / np); });
+  file.write_text("\n#         x         u\n");
+  file.write_columns(space, numNodes, "  ", xs, [&](std::size_t i) { return u.m[i] / u.d[i]; });
+  file.write_text("\n#         x         p\n");
+  file.write_columns(space, numNodes, "  ", xs,
+                     [&](std::size_t i) { return (op->gamma() - 1.) * (u.e[i] - u.m[i] * u.m[i] / (2. * u.d[i])); });
+  file.close();
+
+  return 0;
+}
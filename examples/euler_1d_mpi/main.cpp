@@ -0,0 +1,191 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+ 
+#include <vector>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <cstdlib>
+
+#include <mpi.h>
+
+#include <boost/iterator/zip_iterator.hpp>
+#include <boost/tuple/tuple.hpp> // boost::tuple works with boost::zip_iterator
+
+#include "euler_1d.h"
+#include "explicit_runge_kutta.h"
+#include "mpi_halo_exchange_1d.h"
+#include "cell_partition.h"
+#include "vtu_writer.h"
+#include "text_writer.h"
+
+using halo_type = rdg::mpi_halo_exchange_1d<double, 3>;
+using operator_type = euler_1d<double, rdg::uniform_cartesian_mesh_1d<double>, halo_type>;
+
+// gathers the values of all ranks on rank 0 in the rank order
+std::vector<double> gather(const std::vector<double>& local, MPI_Comm comm)
+{
+  int rank, size;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+  int n = static_cast<int>(local.size());
+  std::vector<int> counts(size), displs(size, 0);
+  MPI_Gather(&n, 1, MPI_INT, counts.data(), 1, MPI_INT, 0, comm);
+  for (int r = 1; r < size; ++r) displs[r] = displs[r - 1] + counts[r - 1];
+  std::vector<double> global(rank == 0 ? displs.back() + counts.back() : 0);
+  MPI_Gatherv(local.data(), n, MPI_DOUBLE, global.data(), counts.data(), displs.data(), MPI_DOUBLE, 0, comm);
+  return global;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Program main
+////////////////////////////////////////////////////////////////////////////////
+int main(int argc, char **argv) {
+
+  MPI_Init(&argc, &argv);
+  int rank, size;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  // the number of cells is of the whole mesh (strong scaling) or of each rank (weak scaling)
+  std::size_t numCells = 1024;
+  int order = 2;
+  bool weak = false;
+  int maxNumTS = 100000;
+  if (argc > 2)
+  {
+    numCells = std::atoi(argv[1]);
+    order = std::atoi(argv[2]);
+  }
+  if (argc > 3) weak = std::string(argv[3]) == "weak";
+  if (argc > 4) maxNumTS = std::atoi(argv[4]);
+  if (weak) numCells *= size;
+
+  // each rank owns a contiguous range of the cells of the uniform mesh of [0, 1], its part
+  // of the partition of the cells in their order balanced in the flux differencing costs
+  std::vector<double> weights(numCells, rdg::flux_differencing_cost(order, 1));
+  rdg::cell_partition partition(rdg::cell_permutation::identity(numCells), weights, size);
+  std::size_t begin = partition.part_begin(rank), end = partition.part_end(rank);
+  if (rank == 0)
+  {
+    // each cell is adjacent to the previous and the next ones
+    std::vector<std::size_t> offsets(numCells + 1, 0), adjacency;
+    for (std::size_t c = 0; c < numCells; ++c)
+    {
+      if (c > 0) adjacency.push_back(c - 1);
+      if (c + 1 < numCells) adjacency.push_back(c + 1);
+      offsets[c + 1] = adjacency.size();
+    }
+    partition.print_statistics(std::cout, offsets, adjacency);
+  }
+  double h = 1. / static_cast<double>(numCells);
+  rdg::uniform_cartesian_mesh_1d<double> mesh(begin * h, end * h, end - begin);
+  halo_type halo(MPI_COMM_WORLD);
+  operator_type op(mesh, order);
+  op.set_halo(&halo);
+
+  // node positions and initial conditions
+  int numNodes = op.num_nodes();
+  std::vector<double> x(numNodes);
+  std::vector<double> d(numNodes); // density rho
+  std::vector<double> m(numNodes); // momentum rhou
+  std::vector<double> e(numNodes); // energy
+  auto varItr = boost::make_zip_iterator(boost::make_tuple(d.begin(), m.begin(), e.begin()));
+  op.initialize_dofs(x.begin(), varItr);
+
+  // allocate work space for the Runge-Kutta loop
+  std::vector<double> wk(15 * numNodes);
+  auto work = [&](int k)
+  {
+    auto it = wk.begin() + 3 * k * numNodes;
+    return boost::make_zip_iterator(boost::make_tuple(it, it + numNodes, it + 2 * numNodes));
+  };
+
+  // the same time step on all ranks
+  auto timestep_size = [&]()
+  {
+    double dt = op.timestep_size(varItr);
+    MPI_Allreduce(MPI_IN_PLACE, &dt, 1, MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD);
+    return dt;
+  };
+
+  // time advancing loop
+  double T = 0.2;
+  double t = 0.0;
+  double dt = timestep_size();
+
+  MPI_Barrier(MPI_COMM_WORLD);
+  double t0 = MPI_Wtime();
+  int numTS = 0;
+  while (t < T && numTS < maxNumTS)
+  {
+    rdg::rk4(varItr, numNodes, t, dt, op, work(0), work(1), work(2), work(3), work(4));
+    t += dt;
+    numTS++;
+
+    dt = timestep_size();
+    if ((t + dt) > T) dt = T - t;
+  }
+  double elapsed = MPI_Wtime() - t0;
+  MPI_Allreduce(MPI_IN_PLACE, &elapsed, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+
+  if (rank == 0)
+  {
+    double dofs = static_cast<double>(numCells) * (order + 1);
+    std::cout << "ranks = " << size << ", cells = " << numCells << ", order = " << order
+              << ", time steps = " << numTS << ", t = " << t << std::endl;
+    std::cout << "elapsed time = " << elapsed << " s, " << dofs * numTS / elapsed / 1.e6
+              << " million DOF updates per second" << std::endl;
+  }
+
+  // output to visualize: a .vtu piece per rank, written from the local buffers, and the
+  // .pvtu index of the pieces by rank 0
+  std::string piece = "SodShockTubeProblem_" + std::to_string(rank) + ".vtu";
+  rdg::write_vtu<double>(piece, op.layout(), 0, op.layout().num_cells(), x.data(),
+                         {{"rho", d.data()}, {"rhou", m.data()}, {"E", e.data()}});
+  if (rank == 0)
+  {
+    std::vector<std::string> pieces;
+    for (int r = 0; r < size; ++r) pieces.push_back("SodShockTubeProblem_" + std::to_string(r) + ".vtu");
+    rdg::write_pvtu<double>("SodShockTubeProblem.pvtu", pieces, {"rho", "rhou", "E"});
+  }
+
+  std::vector<double> xs = gather(x, MPI_COMM_WORLD);
+  std::vector<double> ds = gather(d, MPI_COMM_WORLD);
+  std::vector<double> ms = gather(m, MPI_COMM_WORLD);
+  std::vector<double> es = gather(e, MPI_COMM_WORLD);
+  if (rank == 0)
+  {
+    rdg::serial_space space;
+    auto xi = [&](std::size_t i) { return xs[i]; };
+    rdg::text_writer file("SodShockTubeProblem.txt", rdg::text_format{std::chars_format::general, std::numeric_limits<double>::digits10});
+    file.write_text("#         x         rho\n");
+    file.write_columns(space, xs.size(), "  ", xi, [&](std::size_t i) { return ds[i]; });
+    file.write_text("\n#         x         u\n");
+    file.write_columns(space, xs.size(), "  ", xi, [&](std::size_t i) { return ms[i] / ds[i]; });
+    file.write_text("\n#         x         p\n");
+    file.write_columns(space, xs.size(), "  ", xi,
+                       [&](std::size_t i) { return (op.gamma() - 1.) * (es[i] - ms[i] * ms[i] / (2. * ds[i])); });
+    file.close();
+  }
+
+  MPI_Finalize();
+  return 0;
+}
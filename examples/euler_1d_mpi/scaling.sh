@@ -0,0 +1,40 @@
+#!/bin/bash
+# Strong and weak scaling of euler_1d_mpi on a single box, e.g.,
+#   ./scaling.sh 8          # up to 8 ranks
+# Extra options of mpirun go in MPIRUN_FLAGS, e.g., MPIRUN_FLAGS="--oversubscribe" to
+# run more ranks than cores with Open MPI. The results of all runs must be the same as
+# the one of one rank, which is checked on the strong scaling runs.
+
+MAX_RANKS=${1:-4}
+CELLS=${CELLS:-4096}           # cells of the strong scaling runs
+CELLS_PER_RANK=${CELLS_PER_RANK:-1024}
+ORDER=${ORDER:-2}
+WEAK_STEPS=${WEAK_STEPS:-200}  # time steps of the weak scaling runs
+MPIRUN="mpirun ${MPIRUN_FLAGS}"
+
+set -e -o pipefail
+cd "$(dirname "$0")"
+make DEBUG=0 > /dev/null
+
+ranks=1
+while [ $ranks -le $MAX_RANKS ]; do
+  RANKS="$RANKS $ranks"
+  ranks=$((ranks * 2))
+done
+
+echo "strong scaling: $CELLS cells of order $ORDER"
+for np in $RANKS; do
+  $MPIRUN -np $np ./euler_1d_mpi $CELLS $ORDER strong | grep "elapsed" | sed "s/^/  $np ranks: /"
+  if [ $np -eq 1 ]; then
+    cp SodShockTubeProblem.txt reference.txt
+  elif ! cmp -s SodShockTubeProblem.txt reference.txt; then
+    echo "  $np ranks: the solution differs from the one of one rank"
+    exit 1
+  fi
+done
+rm -f reference.txt
+
+echo "weak scaling: $CELLS_PER_RANK cells of order $ORDER per rank, $WEAK_STEPS time steps"
+for np in $RANKS; do
+  $MPIRUN -np $np ./euler_1d_mpi $CELLS_PER_RANK $ORDER weak $WEAK_STEPS | grep "elapsed" | sed "s/^/  $np ranks: /"
+done
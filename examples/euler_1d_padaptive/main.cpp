@@ -0,0 +1,217 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+ 
+#include <vector>
+#include <iostream>
+#include <limits>
+#include <chrono>
+#include <memory>
+#include <cmath>
+#include <algorithm>
+
+#include <boost/iterator/zip_iterator.hpp>
+#include <boost/tuple/tuple.hpp> // boost::tuple works with boost::zip_iterator
+
+#include "euler_1d.h"
+#include "explicit_runge_kutta.h"
+#include "modal_basis.h"
+#include "variable_order_layout.h"
+#include "text_writer.h"
+
+using operator_type = euler_1d<double, rdg::uniform_cartesian_mesh_1d<double>, rdg::no_halo_1d, rdg::thread_pool_space>;
+
+// conservative variables at the nodes
+struct state
+{
+  std::vector<double> d; // density rho
+  std::vector<double> m; // momentum rhou
+  std::vector<double> e; // energy
+
+  void resize(std::size_t n) { d.resize(n); m.resize(n); e.resize(n); }
+
+  auto begin() { return boost::make_zip_iterator(boost::make_tuple(d.begin(), m.begin(), e.begin())); }
+
+  auto cbegin() const { return boost::make_zip_iterator(boost::make_tuple(d.cbegin(), m.cbegin(), e.cbegin())); }
+};
+
+// orders of the cells from the smoothness indicator of the density, compared with the
+// reference value s0 = -4 * log10(order) of resolved solutions: one lower where the
+// indicator is above s0 - 2, i.e., the modes barely decay, one higher where it is below
+// s0 - 4, and at most one above the target orders of the neighbors so that the waves do
+// not leave the low order cells before the next update
+std::vector<int> select_orders(const rdg::variable_order_layout& layout, const std::vector<double>& d,
+                               int minOrder, int maxOrder)
+{
+  std::size_t n = layout.num_cells();
+  std::vector<int> target(n);
+  for (std::size_t c = 0; c < n; ++c)
+  {
+    int p = layout.order(c);
+    double s = rdg::smoothness_indicator(p, d.data() + layout.offset(c));
+    double s0 = -4. * std::log10(static_cast<double>(p));
+    if (s > s0 - 2.) target[c] = std::max(p - 1, minOrder);
+    else if (s < s0 - 4.) target[c] = std::min(p + 1, maxOrder);
+    else target[c] = p;
+  }
+
+  std::vector<int> orders(target);
+  for (std::size_t c = 0; c < n; ++c)
+  {
+    if (c > 0) orders[c] = std::min(orders[c], target[c - 1] + 1);
+    if (c + 1 < n) orders[c] = std::min(orders[c], target[c + 1] + 1);
+  }
+  return orders;
+}
+
+// flux differencing work of an element loop, proportional to the number of two-point fluxes
+double work(const rdg::variable_order_layout& layout)
+{
+  double w = 0.;
+  for (std::size_t b = 0; b < layout.num_buckets(); ++b)
+    w += layout.bucket_size(b) * std::pow(layout.bucket_order(b) + 1., 2);
+  return w;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Program main
+////////////////////////////////////////////////////////////////////////////////
+int main(int argc, char **argv) {
+
+  int numCells = 256;
+  int minOrder = 1;
+  int maxOrder = 4;
+  int numThreads = 1;
+  if (argc > 1) numCells = std::atoi(argv[1]);
+  if (argc > 3)
+  {
+    minOrder = std::atoi(argv[2]);
+    maxOrder = std::atoi(argv[3]);
+  }
+  if (argc > 4) numThreads = std::atoi(argv[4]);
+  const int adaptInterval = 2; // time steps between two order updates
+
+  rdg::uniform_cartesian_mesh_1d<double> mesh(0., 1., numCells);
+
+  // the elements of various orders are balanced by work stealing
+  rdg::work_stealing_scheduler scheduler(numThreads);
+  rdg::thread_pool_space space(numThreads > 1 ? &scheduler : nullptr);
+
+  // lower the orders around the discontinuity of the initial conditions
+  std::unique_ptr<operator_type> op;
+  rdg::variable_order_layout layout(numCells, maxOrder);
+  std::vector<double> x;
+  state u;
+  for (int k = minOrder; k <= maxOrder; ++k)
+  {
+    op = std::make_unique<operator_type>(mesh, layout);
+    x.resize(op->num_nodes());
+    u.resize(op->num_nodes());
+    op->initialize_dofs(x.begin(), u.begin());
+    layout = rdg::variable_order_layout(select_orders(layout, u.d, minOrder, maxOrder));
+  }
+  op = std::make_unique<operator_type>(mesh, layout);
+  op->set_execution_space(space);
+  x.resize(op->num_nodes());
+  u.resize(op->num_nodes());
+  op->initialize_dofs(x.begin(), u.begin());
+
+  // work space for the Runge-Kutta loop, resized with the layout
+  state w[5];
+  state changed;
+  auto resize_work = [&](std::size_t n) { for (auto& wk : w) wk.resize(n); };
+  resize_work(op->num_nodes());
+
+  // time advancing loop
+  int maxNumTS = 100000;
+  double T = 0.2;
+  double t = 0.0;
+  double dt = op->timestep_size(u.cbegin());
+  std::cout << "dt = " << dt << std::endl;
+
+  auto t0 = std::chrono::system_clock::now();
+  int numTS = 0;
+  double sumDofs = 0., sumWork = 0.;
+  while (t < T && numTS < maxNumTS)
+  {
+    rdg::rk4(space, u.begin(), op->num_nodes(), t, dt, *op, rdg::no_stage_filter(), w[0].begin(), w[1].begin(), w[2].begin(), w[3].begin(), w[4].begin());
+    t += dt;
+    numTS++;
+    sumDofs += layout.num_dofs();
+    sumWork += work(layout);
+
+    if (numTS % adaptInterval == 0)
+    {
+      std::vector<int> orders = select_orders(layout, u.d, minOrder, maxOrder);
+      if (orders != layout.orders())
+      {
+        rdg::variable_order_layout next(orders);
+        changed.resize(next.num_dofs());
+        rdg::change_orders(layout, next, u.d.data(), changed.d.data());
+        rdg::change_orders(layout, next, u.m.data(), changed.m.data());
+        rdg::change_orders(layout, next, u.e.data(), changed.e.data());
+        std::swap(u, changed);
+        layout = next;
+        op = std::make_unique<operator_type>(mesh, layout);
+        op->set_execution_space(space);
+        resize_work(op->num_nodes());
+      }
+    }
+
+    dt = op->timestep_size(u.cbegin());
+    if ((t + dt) > T) dt = T - t;
+  }
+  auto t1 = std::chrono::system_clock::now();
+
+  rdg::variable_order_layout uniform(numCells, maxOrder);
+  std::cout << "number of time steps = " << numTS << std::endl;
+  std::cout << "average number of DOFs = " << sumDofs / numTS << " (uniform order " << maxOrder
+            << ": " << uniform.num_dofs() << ")" << std::endl;
+  std::cout << "average flux differencing work relative to the uniform order = "
+            << sumWork / numTS / work(uniform) << std::endl;
+  std::cout << "final cells per order:";
+  for (std::size_t b = 0; b < layout.num_buckets(); ++b)
+    std::cout << " " << layout.bucket_size(b) << " (order " << layout.bucket_order(b) << ")";
+  std::cout << std::endl;
+  std::cout << "elapsed time = " << std::chrono::duration<double>(t1 - t0).count() << " s with "
+            << numThreads << " thread(s)" << std::endl;
+
+  // output to visualize
+  x.resize(op->num_nodes());
+  state u0;
+  u0.resize(op->num_nodes());
+  op->initialize_dofs(x.begin(), u0.begin());
+  // the blocks of rows are formatted on the threads of the time loop
+  std::size_t numNodes = op->num_nodes();
+  const std::vector<std::size_t>& offsets = layout.offsets();
+  auto xs = [&](std::size_t i) { return x[i]; };
+  auto order = [&](std::size_t i)
+  { return layout.order(std::upper_bound(offsets.begin(), offsets.end(), i) - offsets.begin() - 1); };
+  rdg::text_writer file("SodShockTubeProblem.txt", rdg::text_format{std::chars_format::general, std::numeric_limits<double>::digits10});
+  file.write_text("#         x         rho         order\n");
+  file.write_columns(space, numNodes, "  ", xs, [&](std::size_t i) { return u.d[i]; }, order);
+  file.write_text("\n#         x         u\n");
+  file.write_columns(space, numNodes, "  ", xs, [&](std::size_t i) { return u.m[i] / u.d[i]; });
+  file.write_text("\n#         x         p\n");
+  file.write_columns(space, numNodes, "  ", xs,
+                     [&](std::size_t i) { return (op->gamma() - 1.) * (u.e[i] - u.m[i] * u.m[i] / (2. * u.d[i])); });
+  file.close();
+
+  return 0;
+}
@@ -25,6 +25,7 @@
 #include <cmath>
 #include <cassert>
 #include <limits>
+#include <algorithm>
 
 // use boost::tuple instead of std::tuple because boost::tuple
 // can work with boost::zip_iterator; standard library does not
@@ -33,31 +34,41 @@
 // operations on tuples
 #include "variable.h"
 
-#include "uniform_cartesian_mesh_1d.h"
-#include "mapping_segment.h"
-#include "reference_segment.h"
+#include "uniform_cartesian_mesh_2d.h"
+#include "reference_quadrilateral.h"
 #include "flux_euler_2d.h"
-#include "convective_flux_div_1d.h"
+#include "convective_flux_div_2d.h"
+#include "execution_space.h"
 
 
-// host code of the problem of euler equation in one dimensional space
-template<typename T>
+// host code of the problem of euler equation in two dimensional space: the isentropic
+// vortex of strength 5 advected by the free stream (1, 1) on the periodic square
+// [0, 10] x [0, 10], see the paper "Efficient Implementation of Weighted ENO Schemes"
+// by G.-S. Jiang and C.-W. Shu, 1996
+// SPACE - execution space of the face and element loops (see execution_space.h)
+template<typename T, typename SPACE = rdg::serial_space>
 class euler_2d
 {
 public:
-  euler_2d(std::size_t numCells, int order)
-    : m_numCells(numCells), m_order(order), m_mesh((T)(0), (T)(1), numCells) {}
+  euler_2d(std::size_t numCellsX, std::size_t numCellsY, int order)
+    : m_order(order),
+      m_mesh((T)(0), s_L, numCellsX, (T)(0), s_L, numCellsY, true, true) {}
   ~euler_2d(){}
 
   T gamma() const { return s_gamma; }
 
-  int num_nodes() const { return m_numCells * (m_order + 1); }
+  int num_nodes() const { return m_mesh.num_cells() * (m_order + 1) * (m_order + 1); }
 
-  // the layout of DOFs in memory are different for CPU execution and GPU execution;
-  // the first iterator sets the node positions and the second iterator sets the
+  // the face and element loops run on the execution space, whose grain cost is in face
+  // nodes, nodes, or two-point fluxes of the elements
+  void set_execution_space(const SPACE& space) { m_space = space; }
+
+  const SPACE& execution_space() const { return m_space; }
+
+  // the first two iterators set the node positions and the third iterator sets the
   // initial values of the DOFs
   template<typename OutputIterator1, typename OutputZipIterator2>
-  void initialize_dofs(OutputIterator1 it1, OutputZipIterator2 it2) const;
+  void initialize_dofs(OutputIterator1 itx, OutputIterator1 ity, OutputZipIterator2 it2) const;
 
   // suggested next timestep size
   // input is the solution at the current timestep
@@ -68,114 +79,186 @@ public:
   template<typename ConstZipItr, typename ZipItr>
   void operator()(ConstZipItr in_cbegin, std::size_t size, T t, ZipItr out_begin) const;
 
-  using variable_type = boost::tuple<T, T, T>;
+  // L2 norm of the error of the density at time t, by the LGL quadrature of the nodes
+  template<typename ConstItr, typename ConstZipItr>
+  T l2_error_density(T t, ConstItr x_cbegin, ConstItr y_cbegin, ConstZipItr cbegin) const;
+
+  using variable_type = boost::tuple<T, T, T, T>;
+
+  variable_type exact_solution(T x, T y, T t) const;
 
 private:
   template<typename ConstItr>
-  void numerical_fluxes(ConstItr cbegin, T t) const; // time t is used for boundary conditions
+  void numerical_fluxes(ConstItr cbegin, T t) const;
 
   // re-direct the search for the unary operator- to the rdg name space
   static variable_type negative(const variable_type& v) { return rdg::operator-(v); }
 
 private:
-  using mesh_type         = rdg::uniform_cartesian_mesh_1d<T>;
-  using mapping_type      = rdg::mapping_segment;
-  using reference_element = rdg::reference_segment<T>;
+  using mesh_type         = rdg::uniform_cartesian_mesh_2d<T>;
+  using reference_element = rdg::reference_quadrilateral<T>;
   using flux_calculator   = flux_euler_2d<T>;
 
   // numerical scheme data (could be constants if never change)
-  std::size_t m_numCells;
   int m_order;
 
   // problem definitions
   const mesh_type m_mesh;
+  static constexpr T s_L = static_cast<T>(10);
   const T s_gamma = static_cast<T>(1.4);
+  const T s_epsilon = static_cast<T>(5);
 
-  // work space for numerical fluxes
+  // work space for numerical fluxes, N of each face of the mesh
   mutable std::vector<variable_type> m_numericalFluxes;
+
+  // parallel execution
+  SPACE m_space;
 };
 
-template<typename T> template<typename OutputIterator1, typename OutputZipIterator2>
-void euler_2d<T>::initialize_dofs(OutputIterator1 it1, OutputZipIterator2 it2) const
+template<typename T, typename SPACE>
+typename euler_2d<T, SPACE>::variable_type euler_2d<T, SPACE>::exact_solution(T x, T y, T t) const
 {
-  reference_element refElem(m_order);
-  std::vector<T> pos;
-  refElem.node_positions(std::back_inserter(pos));
+  // the vortex center moves with the free stream (1, 1); shift to the nearest periodic image
+  T dx = x - (s_L / static_cast<T>(2) + t);
+  T dy = y - (s_L / static_cast<T>(2) + t);
+  dx -= s_L * std::round(dx / s_L);
+  dy -= s_L * std::round(dy / s_L);
+
+  const T pi = std::acos(static_cast<T>(-1));
+  T r2 = dx * dx + dy * dy;
+  T dT = - (s_gamma - static_cast<T>(1)) * s_epsilon * s_epsilon /
+           (static_cast<T>(8) * s_gamma * pi * pi) * std::exp(static_cast<T>(1) - r2);
+  T du = s_epsilon / (static_cast<T>(2) * pi) * std::exp((static_cast<T>(1) - r2) / static_cast<T>(2));
+
+  T rho = std::pow(static_cast<T>(1) + dT, static_cast<T>(1) / (s_gamma - static_cast<T>(1)));
+  T u = static_cast<T>(1) - du * dy;
+  T v = static_cast<T>(1) + du * dx;
+  T p = std::pow(rho, s_gamma);
 
   // conserved variables, not primary variables
-  for (std::size_t i = 0; i < m_numCells; ++i)
+  return boost::make_tuple(rho, rho * u, rho * v,
+                           p / (s_gamma - static_cast<T>(1)) + rho * (u * u + v * v) / static_cast<T>(2));
+}
+
+template<typename T, typename SPACE> template<typename OutputIterator1, typename OutputZipIterator2>
+void euler_2d<T, SPACE>::initialize_dofs(OutputIterator1 itx, OutputIterator1 ity, OutputZipIterator2 it2) const
+{
+  reference_element refElem(m_order);
+
+  for (std::size_t i = 0; i < m_mesh.num_cells(); ++i)
   {
-    auto cell= m_mesh.get_cell(i);
-    for (std::size_t j = 0; j < pos.size(); ++j)
+    auto cell = m_mesh.get_cell(i);
+    T x0 = std::get<0>(std::get<0>(cell)), y0 = std::get<1>(std::get<0>(cell));
+    for (std::size_t n = 0; n < refElem.num_nodes(); ++n)
     {
-      T x = mapping_type::r_to_x(std::get<0>(cell), std::get<1>(cell), pos[j]);
-      *it1++ = x;
-      *it2++ = x < 0.5 ?
-               boost::make_tuple(static_cast<T>(1), static_cast<T>(0), static_cast<T>(1) / (s_gamma - static_cast<T>(1))) :
-               boost::make_tuple(static_cast<T>(0.125), static_cast<T>(0), static_cast<T>(0.1) / (s_gamma - static_cast<T>(1)));
+      T x = x0 + (refElem.node_position_r(n) + static_cast<T>(1)) * m_mesh.delta_x() / static_cast<T>(2);
+      T y = y0 + (refElem.node_position_s(n) + static_cast<T>(1)) * m_mesh.delta_y() / static_cast<T>(2);
+      *itx++ = x;
+      *ity++ = y;
+      *it2++ = exact_solution(x, y, static_cast<T>(0));
     }
   }
 }
 
-template<typename T> template<typename InputZipIterator>
-T euler_2d<T>::timestep_size(InputZipIterator it) const
+template<typename T, typename SPACE> template<typename InputZipIterator>
+T euler_2d<T, SPACE>::timestep_size(InputZipIterator it) const
 {
-  T rho, rhou, E;
+  flux_calculator fluxCalculator(s_gamma);
 
-  T maxV = std::numeric_limits<T>::lowest();
-  for (std::size_t i = 0; i < num_nodes(); ++i)
+  // the wave speeds along x and y over the cell sizes add up
+  T maxV = rdg::parallel_reduce(m_space, num_nodes(), std::numeric_limits<T>::lowest(), [&](std::size_t i, T& partial)
   {
-    boost::tie(rho, rhou, E) = *it++;
-    T u = rhou / rho;
-    T p = (E - rhou * u / static_cast<T>(2)) * (s_gamma - static_cast<T>(1)); 
-    T v = std::abs(u) + std::sqrt(s_gamma * p / rho);
-    if (v > maxV) maxV = v;
-  }
+    variable_type var = *(it + i);
+    T v = fluxCalculator.max_wave_speed(var, 0) / m_mesh.delta_x() +
+          fluxCalculator.max_wave_speed(var, 1) / m_mesh.delta_y();
+    if (v > partial) partial = v;
+  }, [](T a, T b) { return std::max(a, b); });
 
-  return static_cast<T>(0.25) / (maxV * static_cast<T>(m_mesh.num_cells())) / static_cast<T>(m_order);
+  return static_cast<T>(0.25) / maxV / static_cast<T>(m_order);
 }
 
-template<typename T> template<typename ConstZipItr>
-void euler_2d<T>::numerical_fluxes(ConstZipItr cbegin, T t) const
+template<typename T, typename SPACE> template<typename ConstZipItr>
+void euler_2d<T, SPACE>::numerical_fluxes(ConstZipItr cbegin, T t) const
 {
   flux_calculator fluxCalculator(s_gamma);
+  reference_element refElem(m_order);
 
-  std::size_t numFluxes = m_numCells + 1;
+  std::size_t N = refElem.num_face_nodes();
+  std::size_t Np = refElem.num_nodes();
+  std::size_t numFluxes = m_mesh.num_faces() * N;
   if (m_numericalFluxes.size() < numFluxes) m_numericalFluxes.resize(numFluxes);
 
-  variable_type a, b;
-  int np = reference_element(m_order).num_nodes();
-  for (std::size_t i = 0; i < numFluxes; ++i)
+  rdg::parallel_for(m_space, m_mesh.num_faces(), [N](std::size_t) { return static_cast<T>(N); }, [&](std::size_t begin, std::size_t end)
   {
-    if (i > 0) a = *(cbegin + (i * np - 1));
-    // inflow boundary condition
-    else a = boost::make_tuple(static_cast<T>(1), static_cast<T>(0), static_cast<T>(1) / (s_gamma - static_cast<T>(1)));
-    if (i < numFluxes - 1) b = *(cbegin + (i * np));
-    // outflow boundary condition
-    else b = boost::make_tuple(T(0.125), static_cast<T>(0), T(0.1) / (s_gamma - static_cast<T>(1))); //*(cbegin + (i * np - 1));
-    m_numericalFluxes[i] = fluxCalculator.numerical_surface_flux(a, b, 1);
-  }
+    for (std::size_t f = begin; f < end; ++f)
+    {
+      auto cells = m_mesh.face_cells(f);
+      int dir = m_mesh.face_direction(f);
+
+      // the minus cell sees the face as its local face 1 (or 3) and the plus cell as its
+      // local face 0 (or 2); on a non-periodic boundary the interior state is extrapolated
+      std::size_t cm = std::get<0>(cells), cp = std::get<1>(cells);
+      if (cm == mesh_type::invalid_index) cm = cp;
+      if (cp == mesh_type::invalid_index) cp = cm;
+      const auto& nodes_minus = refElem.face_nodes(std::get<0>(cells) == cm ? 2 * dir + 1 : 2 * dir);
+      const auto& nodes_plus = refElem.face_nodes(std::get<1>(cells) == cp ? 2 * dir : 2 * dir + 1);
+
+      for (std::size_t a = 0; a < N; ++a)
+        m_numericalFluxes[f * N + a] = fluxCalculator.numerical_surface_flux(*(cbegin + (cm * Np + nodes_minus[a])),
+                                                                             *(cbegin + (cp * Np + nodes_plus[a])), dir);
+    }
+  });
 }
 
-template<typename T> template<typename ConstZipItr, typename ZipItr>
-void euler_2d<T>::operator()(ConstZipItr in_cbegin, std::size_t size, T t, ZipItr out_begin) const
+template<typename T, typename SPACE> template<typename ConstZipItr, typename ZipItr>
+void euler_2d<T, SPACE>::operator()(ConstZipItr in_cbegin, std::size_t size, T t, ZipItr out_begin) const
 {
   numerical_fluxes(in_cbegin, t);
 
-  reference_element refElem(m_order);
   flux_calculator fluxCalculator(s_gamma);
-  rdg::convective_flux_div_1d<reference_element, flux_calculator> divOp(refElem, fluxCalculator);
+  reference_element refElem(m_order);
 
-  int np = refElem.num_nodes();
-  std::vector<variable_type> cellOut(np);
-  for (std::size_t cell = 0; cell < m_numCells; ++cell)
+  // the cost of an element is about the number of its two-point fluxes, N along each of
+  // the 2N lines of its nodes; the divergence operator has work space, so one per range
+  std::size_t N = refElem.num_face_nodes();
+  std::size_t Np = refElem.num_nodes();
+  T cost = static_cast<T>(2 * Np * N);
+  rdg::parallel_for(m_space, m_mesh.num_cells(), [cost](std::size_t) { return cost; }, [&](std::size_t begin, std::size_t end)
   {
-    auto cellGeom = m_mesh.get_cell(cell);
-    T J = mapping_type::J(std::get<0>(cellGeom), std::get<1>(cellGeom));
-    divOp.apply(in_cbegin + np * cell, m_numericalFluxes.cbegin() + cell, J, cellOut.begin());
+    rdg::convective_flux_div_2d<reference_element, flux_calculator> divOp(refElem, fluxCalculator);
+    std::vector<variable_type> cellFluxes(4 * N);
+    std::vector<variable_type> cellOut(Np);
+    for (std::size_t cell = begin; cell < end; ++cell)
+    {
+      for (int f = 0; f < 4; ++f)
+      {
+        std::size_t face = m_mesh.cell_face(cell, f);
+        for (std::size_t a = 0; a < N; ++a) cellFluxes[f * N + a] = m_numericalFluxes[face * N + a];
+      }
 
-    for(int i = 0; i < np; ++i) *(out_begin + np * cell + i) = negative(cellOut[i]);
-  }
+      divOp.apply(in_cbegin + Np * cell, cellFluxes.cbegin(), m_mesh.dr_dx(cell), m_mesh.ds_dy(cell), cellOut.begin());
+
+      for(std::size_t i = 0; i < Np; ++i) *(out_begin + Np * cell + i) = negative(cellOut[i]);
+    }
+  });
+}
+
+template<typename T, typename SPACE> template<typename ConstItr, typename ConstZipItr>
+T euler_2d<T, SPACE>::l2_error_density(T t, ConstItr x_cbegin, ConstItr y_cbegin, ConstZipItr cbegin) const
+{
+  reference_element refElem(m_order);
+  std::size_t Np = refElem.num_nodes();
+
+  T err = rdg::parallel_reduce(m_space, m_mesh.num_cells(), static_cast<T>(0), [&](std::size_t i, T& partial)
+  {
+    for (std::size_t n = 0; n < Np; ++n)
+    {
+      T rho = boost::get<0>(variable_type(*(cbegin + (i * Np + n))));
+      T diff = rho - boost::get<0>(exact_solution(*(x_cbegin + (i * Np + n)), *(y_cbegin + (i * Np + n)), t));
+      partial += refElem.weight(n) * m_mesh.J(i) * diff * diff;
+    }
+  }, [](T a, T b) { return a + b; });
+  return std::sqrt(err);
 }
 
 #endif
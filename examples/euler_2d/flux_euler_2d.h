@@ -30,172 +30,113 @@
 #include "const_val.h"
 #include "logarithmic_mean.h"
 
+// fluxes of the euler equations in two dimensional space, of the conserved variables
+// (rho, rhou, rhov, E) along the axis dir, i.e., 0 for x and 1 for y
 template<typename T>
 class flux_euler_2d
 {
 public:
   using value_type = T;
-  using variable_type = boost::tuple<T, T, T>;
+  using variable_type = boost::tuple<T, T, T, T>;
 
   explicit flux_euler_2d(T gamma) : m_gamma(gamma) {}
 
-  variable_type physical_flux(const variable_type& var) const
+  variable_type physical_flux(const variable_type& var, int dir) const
   {
-    T rho, rhou, E;
-    boost::tie(rho, rhou, E) = var;
+    T rho, rhou, rhov, E;
+    boost::tie(rho, rhou, rhov, E) = var;
 
     T u = rhou / rho;
-    T p = (m_gamma - rdg::const_val<T, 1>) * (E - rhou * u / rdg::const_val<T, 2>);
+    T v = rhov / rho;
+    T p = (m_gamma - rdg::const_val<T, 1>) * (E - (rhou * u + rhov * v) / rdg::const_val<T, 2>);
 
-    return boost::make_tuple(rhou, rhou * u + p, (E + p) * u);
+    return dir == 0 ? boost::make_tuple(rhou, rhou * u + p, rhou * v, (E + p) * u) :
+                      boost::make_tuple(rhov, rhov * u, rhov * v + p, (E + p) * v);
   }
 
   variable_type numerical_volume_flux(const variable_type& var_minus,
-                                      const variable_type& var_plus) const;
+                                      const variable_type& var_plus, int dir) const;
 
+  // NOTE: the flux along the axis dir (not along the outward normal) where var_minus
+  // NOTE: is the state on the lower side of the face and var_plus the upper side
   variable_type numerical_surface_flux(const variable_type& var_minus,
-                                       const variable_type& var_plus, T sign_minus) const;
+                                       const variable_type& var_plus, int dir) const;
+
+  // maximum wave speed along the axis dir
+  T max_wave_speed(const variable_type& var, int dir) const
+  {
+    T rho, rhou, rhov, E;
+    boost::tie(rho, rhou, rhov, E) = var;
+
+    T u = rhou / rho;
+    T v = rhov / rho;
+    T p = (m_gamma - rdg::const_val<T, 1>) * (E - (rhou * u + rhov * v) / rdg::const_val<T, 2>);
+
+    return std::abs(dir == 0 ? u : v) + std::sqrt(std::abs(m_gamma * p / rho));
+  }
+
 private:
   T m_gamma;
 };
 
-// see the Chandrashekar flux in the paper "Split Form Nodal Discontinuous Galerkin
-// Schemes with Summation-By-Parts Property for the Compressible Euler Equations"
-// by G.J. Gassner, A.R. Winters, and D. Kopriva, 2016
+// see the Chandrashekar flux in the paper "Kinetic Energy Preserving and Entropy Stable
+// Finite Volume Schemes for Compressible Euler and Navier-Stokes Equations" by P.
+// Chandrashekar, 2013, and in the paper "Split Form Nodal Discontinuous Galerkin Schemes
+// with Summation-By-Parts Property for the Compressible Euler Equations" by G.J. Gassner,
+// A.R. Winters, and D. Kopriva, 2016
 template<typename T>
 typename flux_euler_2d<T>::variable_type flux_euler_2d<T>::numerical_volume_flux(
-  const variable_type& var_minus, const variable_type& var_plus) const
+  const variable_type& var_minus, const variable_type& var_plus, int dir) const
 {
-  T rho_minus, rhou_minus, E_minus, rho_plus, rhou_plus, E_plus;
-  boost::tie(rho_minus, rhou_minus, E_minus) = var_minus;
-  boost::tie(rho_plus, rhou_plus, E_plus) = var_plus;
-
-  // averages
-  T rho = rdg::logarithmic_mean(rho_minus, rho_plus);
+  T rho_minus, rhou_minus, rhov_minus, E_minus, rho_plus, rhou_plus, rhov_plus, E_plus;
+  boost::tie(rho_minus, rhou_minus, rhov_minus, E_minus) = var_minus;
+  boost::tie(rho_plus, rhou_plus, rhov_plus, E_plus) = var_plus;
 
   T u_minus = rhou_minus / rho_minus;
+  T v_minus = rhov_minus / rho_minus;
   T u_plus = rhou_plus / rho_plus;
-  T u = (u_minus + u_plus) / rdg::const_val<T, 2>;
+  T v_plus = rhov_plus / rho_plus;
 
-  T p_minus = (m_gamma - rdg::const_val<T, 1>) * (E_minus - rhou_minus * u_minus / rdg::const_val<T, 2>);
-  T p_plus = (m_gamma - rdg::const_val<T, 1>) * (E_plus - rhou_plus * u_plus / rdg::const_val<T, 2>);
+  T p_minus = (m_gamma - rdg::const_val<T, 1>) * (E_minus - (rhou_minus * u_minus + rhov_minus * v_minus) / rdg::const_val<T, 2>);
+  T p_plus = (m_gamma - rdg::const_val<T, 1>) * (E_plus - (rhou_plus * u_plus + rhov_plus * v_plus) / rdg::const_val<T, 2>);
   T beta_minus = rho_minus / (rdg::const_val<T, 2> * p_minus);
   T beta_plus = rho_plus / (rdg::const_val<T, 2> * p_plus);
-  T p = (rho_minus + rho_plus) / (rdg::const_val<T, 2> * (beta_minus + beta_plus));
-
-  T beta_inv = rdg::inverse_logarithmic_mean(beta_minus, beta_plus);
-  T H = beta_inv / (rdg::const_val<T, 2> * (m_gamma - rdg::const_val<T, 1>)) + p / rho + u * u / rdg::const_val<T, 2>;
-
-  return boost::make_tuple(rho * u, rho * u * u + p, rho * u * H);
-}
-
-// symmetric part plus stabilization part
-// NOTE: unit normal vectors of the faces of a 1d element
-// NOTE: degenerate to a sign, i.e., -1 or +1
-template<typename T>
-typename flux_euler_2d<T>::variable_type flux_euler_2d<T>::numerical_surface_flux(
-  const variable_type& var_minus, const variable_type& var_plus, T sign_minus) const
-{
-  T rho_minus, rhou_minus, E_minus, rho_plus, rhou_plus, E_plus;
-  boost::tie(rho_minus, rhou_minus, E_minus) = var_minus;
-  boost::tie(rho_plus, rhou_plus, E_plus) = var_plus;
 
-  T u_minus = rhou_minus / rho_minus;
-  T p_minus = (m_gamma - rdg::const_val<T, 1>) * (E_minus - rhou_minus * u_minus / rdg::const_val<T, 2>); 
-  T LF_minus = std::abs(u_minus) + std::sqrt(std::abs(m_gamma * p_minus / rho_minus));
-
-  T u_plus = rhou_plus / rho_plus;
-  T p_plus = (m_gamma - rdg::const_val<T, 1>) * (E_plus - rhou_plus * u_plus / rdg::const_val<T, 2>); 
-  T LF_plus = std::abs(u_plus) + std::sqrt(std::abs(m_gamma * p_plus / rho_plus));
-
-  // averages - symmetric part
+  // averages
   T rho = rdg::logarithmic_mean(rho_minus, rho_plus);
   T u = (u_minus + u_plus) / rdg::const_val<T, 2>;
-  T beta_minus = rho_minus / (rdg::const_val<T, 2> * p_minus);
-  T beta_plus = rho_plus / (rdg::const_val<T, 2> * p_plus);
+  T v = (v_minus + v_plus) / rdg::const_val<T, 2>;
   T p = (rho_minus + rho_plus) / (rdg::const_val<T, 2> * (beta_minus + beta_plus));
+  T vel2 = (u_minus * u_minus + v_minus * v_minus + u_plus * u_plus + v_plus * v_plus) / rdg::const_val<T, 2>;
   T beta_inv = rdg::inverse_logarithmic_mean(beta_minus, beta_plus);
-  T H = beta_inv / (rdg::const_val<T, 2> * (m_gamma - rdg::const_val<T, 1>)) + p / rho + u * u / rdg::const_val<T, 2>;
-
-  // jumps for the stabilization part
-  T jump_rho = sign_minus < 0 ? rho_plus - rho_minus : rho_minus - rho_plus;
-  T jump_rhou = sign_minus < 0 ? rhou_plus - rhou_minus : rhou_minus - rhou_plus;
-  T jump_E = sign_minus < 0 ? E_plus - E_minus : E_minus - E_plus;
-
-  // local Lax-Friedrichs flux
-  T LF = LF_minus > LF_plus ? LF_minus / rdg::const_val<T, 2> : LF_plus / rdg::const_val<T, 2>;
-  return boost::make_tuple(rho * u + LF * jump_rho,
-                           rho * u * u + p + LF * jump_rhou,
-                           rho * u * H + LF * jump_E);
-}
-
-/* NOTE: The following is KG flux implementation, which also works, but
-         the Chandrashekar flux implemented above can be entropy stable.
-
-// see the KG flux in the paper "Split Form Nodal Discontinuous Galerkin
-// Schemes with Summation-By-Parts Property for the Compressible Euler
-// Equations" by G.J. Gassner, A.R. Winters, and D. Kopriva, 2016
-template<typename T>
-typename flux_euler_2d<T>::variable_type flux_euler_2d<T>::numerical_volume_flux(
-  const variable_type& var_minus, const variable_type& var_plus) const
-{
-  T rho_minus, rhou_minus, E_minus, rho_plus, rhou_plus, E_plus;
-  boost::tie(rho_minus, rhou_minus, E_minus) = var_minus;
-  boost::tie(rho_plus, rhou_plus, E_plus) = var_plus;
-
-  // averages
-  T rho = (rho_minus + rho_plus) / rdg::const_val<T, 2>;
-
-  T u_minus = rhou_minus / rho_minus;
-  T u_plus = rhou_plus / rho_plus;
-  T u = (u_minus + u_plus) / rdg::const_val<T, 2>;
-
-  T p_minus = (m_gamma - rdg::const_val<T, 1>) * (E_minus - rhou_minus * u_minus / rdg::const_val<T, 2>);
-  T p_plus = (m_gamma - rdg::const_val<T, 1>) * (E_plus - rhou_plus * u_plus / rdg::const_val<T, 2>);
-  T p = (p_minus + p_plus) / rdg::const_val<T, 2>;
 
-  T e = (E_minus / rho_minus + E_plus / rho_plus) / rdg::const_val<T, 2>;
+  T f_rho = rho * (dir == 0 ? u : v);
+  T f_rhou = f_rho * u + (dir == 0 ? p : rdg::const_val<T, 0>);
+  T f_rhov = f_rho * v + (dir == 0 ? rdg::const_val<T, 0> : p);
+  T f_E = f_rho * (beta_inv / (rdg::const_val<T, 2> * (m_gamma - rdg::const_val<T, 1>)) - vel2 / rdg::const_val<T, 2>) +
+          u * f_rhou + v * f_rhov;
 
-  return boost::make_tuple(rho * u, rho * u * u + p, (rho * e + p) * u);
+  return boost::make_tuple(f_rho, f_rhou, f_rhov, f_E);
 }
 
-// symmetric part plus stabilization part
-// NOTE: unit normal vectors of the faces of a 1d element
-// NOTE: degenerate to a sign, i.e., -1 or +1
+// symmetric part plus stabilization part, i.e., the local Lax-Friedrichs flux
 template<typename T>
 typename flux_euler_2d<T>::variable_type flux_euler_2d<T>::numerical_surface_flux(
-  const variable_type& var_minus, const variable_type& var_plus, T sign_minus) const
+  const variable_type& var_minus, const variable_type& var_plus, int dir) const
 {
-  T rho_minus, rhou_minus, E_minus, rho_plus, rhou_plus, E_plus;
-  boost::tie(rho_minus, rhou_minus, E_minus) = var_minus;
-  boost::tie(rho_plus, rhou_plus, E_plus) = var_plus;
+  T rho_minus, rhou_minus, rhov_minus, E_minus, rho_plus, rhou_plus, rhov_plus, E_plus;
+  boost::tie(rho_minus, rhou_minus, rhov_minus, E_minus) = var_minus;
+  boost::tie(rho_plus, rhou_plus, rhov_plus, E_plus) = var_plus;
 
-  T u_minus = rhou_minus / rho_minus;
-  T p_minus = (m_gamma - rdg::const_val<T, 1>) * (E_minus - rhou_minus * u_minus / rdg::const_val<T, 2>); 
-  T LF_minus = std::abs(u_minus) + std::sqrt(std::abs(m_gamma * p_minus / rho_minus));
-
-  T u_plus = rhou_plus / rho_plus;
-  T p_plus = (m_gamma - rdg::const_val<T, 1>) * (E_plus - rhou_plus * u_plus / rdg::const_val<T, 2>); 
-  T LF_plus = std::abs(u_plus) + std::sqrt(std::abs(m_gamma * p_plus / rho_plus));
-
-  // averages - symmetric part
-  T rho = (rho_minus + rho_plus) / rdg::const_val<T, 2>;
-  T u = (u_minus + u_plus) / rdg::const_val<T, 2>;
-  T p = (p_minus + p_plus) / rdg::const_val<T, 2>;
-  T e = (E_minus / rho_minus + E_plus / rho_plus) / rdg::const_val<T, 2>;
-
-  // jumps for the stabilization part
-  T jump_rho = sign_minus < 0 ? rho_plus - rho_minus : rho_minus - rho_plus;
-  T jump_rhou = sign_minus < 0 ? rhou_plus - rhou_minus : rhou_minus - rhou_plus;
-  T jump_E = sign_minus < 0 ? E_plus - E_minus : E_minus - E_plus;
-
-  // local Lax-Friedrichs flux
+  T LF_minus = max_wave_speed(var_minus, dir);
+  T LF_plus = max_wave_speed(var_plus, dir);
   T LF = LF_minus > LF_plus ? LF_minus / rdg::const_val<T, 2> : LF_plus / rdg::const_val<T, 2>;
-  return boost::make_tuple(rho * u + LF * jump_rho,
-                           rho * u * u + p + LF * jump_rhou,
-                           (rho * e + p) * u + LF * jump_E);
-}
 
-*/
+  variable_type f = numerical_volume_flux(var_minus, var_plus, dir);
+  return boost::make_tuple(boost::get<0>(f) + LF * (rho_minus - rho_plus),
+                           boost::get<1>(f) + LF * (rhou_minus - rhou_plus),
+                           boost::get<2>(f) + LF * (rhov_minus - rhov_plus),
+                           boost::get<3>(f) + LF * (E_minus - E_plus));
+}
 
 #endif
@@ -20,7 +20,6 @@
  
 #include <vector>
 #include <iostream>
-#include <fstream>
 #include <limits>
 #include <chrono>
 
@@ -29,56 +28,73 @@
 
 #include "euler_2d.h"
 #include "explicit_runge_kutta.h"
+#include "work_stealing_scheduler.h"
+#include "vtu_writer.h"
+#include "text_writer.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 // Program main
 ////////////////////////////////////////////////////////////////////////////////
 int main(int argc, char **argv) {
 
-  int numCells = 1024;
-  int order = 2;
+  int numCells = 32; // in each direction
+  int order = 3;
+  double T = 1.0;
   if (argc > 1)
   {
     numCells = std::atoi(argv[1]);
     order = std::atoi(argv[2]);
   }
+  if (argc > 3) T = std::atof(argv[3]);
+  int numThreads = 1;
+  if (argc > 4) numThreads = std::atoi(argv[4]);
 
-  euler_2d<double> op(numCells, order);
+  // the face and element loops and the Runge-Kutta updates run on the thread pool
+  rdg::work_stealing_scheduler scheduler(numThreads);
+  rdg::thread_pool_space space(numThreads > 1 ? &scheduler : nullptr);
+  euler_2d<double, rdg::thread_pool_space> op(numCells, numCells, order);
+  op.set_execution_space(space);
 
   // node positions and initial conditions
   int numNodes = op.num_nodes();
   std::vector<double> x(numNodes);
+  std::vector<double> y(numNodes);
   std::vector<double> d(numNodes); // density rho
   std::vector<double> m(numNodes); // momentum rhou
+  std::vector<double> n(numNodes); // momentum rhov
   std::vector<double> e(numNodes); // energy
-  auto varItr = boost::make_zip_iterator(boost::make_tuple(d.begin(), m.begin(), e.begin()));
-  op.initialize_dofs(x.begin(), varItr);
+  auto varItr = boost::make_zip_iterator(boost::make_tuple(d.begin(), m.begin(), n.begin(), e.begin()));
+  op.initialize_dofs(x.begin(), y.begin(), varItr);
 
   // allocate work space for the Runge-Kutta loop
   std::vector<double> d1(numNodes);
   std::vector<double> m1(numNodes);
+  std::vector<double> n1(numNodes);
   std::vector<double> e1(numNodes);
-  auto var1Itr = boost::make_zip_iterator(boost::make_tuple(d1.begin(), m1.begin(), e1.begin()));
+  auto var1Itr = boost::make_zip_iterator(boost::make_tuple(d1.begin(), m1.begin(), n1.begin(), e1.begin()));
   std::vector<double> d2(numNodes);
   std::vector<double> m2(numNodes);
+  std::vector<double> n2(numNodes);
   std::vector<double> e2(numNodes);
-  auto var2Itr = boost::make_zip_iterator(boost::make_tuple(d2.begin(), m2.begin(), e2.begin()));
+  auto var2Itr = boost::make_zip_iterator(boost::make_tuple(d2.begin(), m2.begin(), n2.begin(), e2.begin()));
   std::vector<double> d3(numNodes);
   std::vector<double> m3(numNodes);
+  std::vector<double> n3(numNodes);
   std::vector<double> e3(numNodes);
-  auto var3Itr = boost::make_zip_iterator(boost::make_tuple(d3.begin(), m3.begin(), e3.begin()));
+  auto var3Itr = boost::make_zip_iterator(boost::make_tuple(d3.begin(), m3.begin(), n3.begin(), e3.begin()));
   std::vector<double> d4(numNodes);
   std::vector<double> m4(numNodes);
+  std::vector<double> n4(numNodes);
   std::vector<double> e4(numNodes);
-  auto var4Itr = boost::make_zip_iterator(boost::make_tuple(d4.begin(), m4.begin(), e4.begin()));
+  auto var4Itr = boost::make_zip_iterator(boost::make_tuple(d4.begin(), m4.begin(), n4.begin(), e4.begin()));
   std::vector<double> d5(numNodes);
   std::vector<double> m5(numNodes);
+  std::vector<double> n5(numNodes);
   std::vector<double> e5(numNodes);
-  auto var5Itr = boost::make_zip_iterator(boost::make_tuple(d5.begin(), m5.begin(), e5.begin()));
+  auto var5Itr = boost::make_zip_iterator(boost::make_tuple(d5.begin(), m5.begin(), n5.begin(), e5.begin()));
 
   // time advancing loop
-  int maxNumTS = 10000;
-  double T = 0.2;
+  int maxNumTS = 100000;
   double t = 0.0;
   double dt = op.timestep_size(varItr);
   std::cout << "dt = " << dt << std::endl;
@@ -87,35 +103,38 @@ int main(int argc, char **argv) {
   int numTS = 0;
   while (t < T && numTS < maxNumTS)
   {
-    rdg::rk4(varItr, numNodes, t, dt, op, var1Itr, var2Itr, var3Itr, var4Itr, var5Itr);
+    rdg::rk4(space, varItr, numNodes, t, dt, op, rdg::no_stage_filter(), var1Itr, var2Itr, var3Itr, var4Itr, var5Itr);
     t += dt;
     numTS++;
 
     dt = op.timestep_size(varItr);
     if ((t + dt) > T) dt = T - t;
-    std::cout << "t = " << t << ", next dt = " << dt << std::endl;
   }
   auto t1 = std::chrono::system_clock::now();
 
+  // throughput in DOF updates, i.e., evaluations of the discrete operator per node, per second
+  double ms = std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count();
+  std::cout << "number of time steps: " << numTS << std::endl;
+  std::cout << "time used: " << ms << " ms with " << numThreads << " thread(s)" << std::endl;
+  std::cout << "throughput: " << 4. * numTS * numNodes / (ms * 1.e3) << " million DOF updates per second" << std::endl;
+  std::cout << "L2 error norm of density: " << op.l2_error_density(t, x.cbegin(), y.cbegin(), varItr) << std::endl;
+
   // output to visualize
-  std::ofstream file;
-  file.open("IsentropicVortexProblem.txt");
-  file.precision(std::numeric_limits<double>::digits10);
-  file << "#         x         rho" << std::endl;
-  for(int i = 0; i < numNodes; ++i)
-    file << x[i] << "  " << d[i] << std::endl;
-  file << std::endl;
-  file << "#         x         u" << std::endl;
-  for(int i = 0; i < numNodes; ++i)
-    file << x[i] << "  " << m[i] / d[i] << std::endl;
-  file << std::endl;
-  file << "#         x         p" << std::endl;
-  for(int i = 0; i < numNodes; ++i)
-  {
-    double p = (op.gamma() - 1.) * (e[i] - m[i] * m[i] / (2. * d[i]));
-    file << x[i] << "  " << p << std::endl;
-  }
+  rdg::text_writer file("IsentropicVortexProblem.txt", rdg::text_format{std::chars_format::general, std::numeric_limits<double>::digits10});
+  file.write_text("#         x         y         rho         u         v         p\n");
+  file.write_columns(rdg::serial_space(), numNodes, "  ",
+                     [&](std::size_t i) { return x[i]; }, [&](std::size_t i) { return y[i]; },
+                     [&](std::size_t i) { return d[i]; }, [&](std::size_t i) { return m[i] / d[i]; },
+                     [&](std::size_t i) { return n[i] / d[i]; },
+                     [&](std::size_t i) { return (op.gamma() - 1.) * (e[i] - (m[i] * m[i] + n[i] * n[i]) / (2. * d[i])); });
   file.close();
 
+  // and for ParaView, with the elements as Lagrange quadrilaterals
+  std::size_t numElemNodes = (order + 1) * (order + 1);
+  rdg::write_vtu_pieces<rdg::serial_space, double>(rdg::serial_space(), "IsentropicVortexProblem", 1,
+    rdg::vtk_lagrange_cell::quadrilateral, numCells * numCells,
+    [order](std::size_t) { return order; }, [numElemNodes](std::size_t c) { return c * numElemNodes; },
+    {x.data(), y.data(), nullptr}, {{"rho", d.data()}, {"rhou", m.data()}, {"rhov", n.data()}, {"E", e.data()}});
+
   return 0;
 }
@@ -0,0 +1,372 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#ifndef ADAPTIVE_MESH_1D_H
+#define ADAPTIVE_MESH_1D_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <memory>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <limits>
+
+#include "const_val.h"
+#include "variable.h"
+#include "dense_matrix.h"
+#include "lagrange_basis.h"
+#include "lgl_gl_transfer.h"
+#include "mapping_segment.h"
+
+namespace rdg {
+
+// Operators of the solution transfer between a segment (parent) and its two halves
+// (children) for the nodal polynomials at the LGL points of n points. The prolongation
+// to child c, i.e., 0 for the left half and 1 for the right half, is the interpolation
+// of the parent polynomial at the child nodes, which is exact; the restriction is the
+// L2 projection of the piecewise polynomial of the two children onto the parent
+// polynomials, u_parent = R_0 * u_0 + R_1 * u_1 where R_c = M^{-1} * B_c, M is the exact
+// mass matrix and B_c(i, j) = int_{child c} l_i * l_j^c, both by GL quadrature of n
+// points, so that the mean is conserved. The operators are built once per (T, n) and
+// kept in a process-wide table.
+template<typename T>
+class binary_tree_transfer
+{
+public:
+  using matrix_type = dense_matrix<T, false>; // row major
+
+  // thread safe; the returned reference stays valid until the program exits
+  static const binary_tree_transfer& get(std::size_t n);
+
+  std::size_t num_points() const { return m_n; }
+
+  const matrix_type& prolongation(int c) const { return m_P[c]; }
+
+  const matrix_type& restriction(int c) const { return m_R[c]; }
+
+private:
+  explicit binary_tree_transfer(std::size_t n);
+
+private:
+  std::size_t m_n;
+  matrix_type m_P[2];
+  matrix_type m_R[2];
+};
+
+template<typename T>
+const binary_tree_transfer<T>& binary_tree_transfer<T>::get(std::size_t n)
+{
+  static std::mutex s_mutex;
+  static std::map<std::size_t, std::unique_ptr<const binary_tree_transfer>> s_transfers;
+
+  std::lock_guard<std::mutex> lock(s_mutex);
+  auto& transfer = s_transfers[n];
+  if (!transfer) transfer.reset(new binary_tree_transfer(n));
+  return *transfer;
+}
+
+template<typename T>
+binary_tree_transfer<T>::binary_tree_transfer(std::size_t n) : m_n(n)
+{
+  assert(n >= 2);
+
+  const auto& lglgl = lgl_gl_transfer<T>::get(n, n);
+  const auto& r = lglgl.lgl_points();
+  const auto& g = lglgl.gl_points();
+  const auto& w = lglgl.gl_weights();
+  lagrange_basis<T> basis(r.begin(), r.end());
+
+  // exact mass matrix V^T * W * V of the parent
+  const auto& V = lglgl.lgl_to_gl();
+  matrix_type M(n, n, const_val<T, 0>);
+  for (std::size_t i = 0; i < n; ++i)
+    for (std::size_t j = 0; j < n; ++j)
+      for (std::size_t q = 0; q < n; ++q) M(i, j) += V(q, i) * w[q] * V(q, j);
+  matrix_type invM = M.inverse();
+
+  for (int c = 0; c < 2; ++c)
+  {
+    // the point r of child c is at (r - 1) / 2 or (r + 1) / 2 of the parent
+    auto to_parent = [c](T x) { return (x + (c == 0 ? - const_val<T, 1> : const_val<T, 1>)) / const_val<T, 2>; };
+
+    std::vector<T> rp(n), gp(n);
+    std::transform(r.begin(), r.end(), rp.begin(), to_parent);
+    std::transform(g.begin(), g.end(), gp.begin(), to_parent);
+    m_P[c] = interpolation_matrix(basis, rp.begin(), rp.end());
+
+    // B_c(i, j) = 1/2 * sum_q w_q * l_i(parent point of g_q) * l_j(g_q)
+    matrix_type Pg = interpolation_matrix(basis, gp.begin(), gp.end());
+    matrix_type B(n, n, const_val<T, 0>);
+    for (std::size_t i = 0; i < n; ++i)
+      for (std::size_t j = 0; j < n; ++j)
+        for (std::size_t q = 0; q < n; ++q) B(i, j) += w[q] * Pg(q, i) * V(q, j) / const_val<T, 2>;
+    m_R[c] = invM * B;
+  }
+}
+
+// 1D mesh of the leaves of binary trees rooted at the num_roots equal cells of
+// [x0, x1], i.e., h-adaptive by refining a cell into its two halves and coarsening two
+// sibling cells into their parent, up to max_level refinements. The leaves are stored
+// contiguously from left to right together with their geometry, which are repacked by
+// adapt(), so the mesh has the interface of cartesian_mesh_1d and can be used in place
+// of it by the element and face loops.
+//
+// NOTE: In 1D a face between cells of different levels is a single point, so the 2:1
+// NOTE: hanging faces need no mortars: the numerical flux takes the traces of the two
+// NOTE: cells at the point as for any other face.
+template<typename T>
+class adaptive_mesh_1d
+{
+public:
+  using point_type = T;
+
+  adaptive_mesh_1d(T x0, T x1, std::size_t num_roots, int max_level)
+    : m_x0(x0), m_x1(x1), m_root_size((x1 - x0) / static_cast<T>(num_roots)), m_max_level(max_level),
+      m_level(num_roots, 0), m_index(num_roots)
+  {
+    assert(x0 < x1 && num_roots > 0 && max_level >= 0 && max_level < 62);
+    for (std::size_t i = 0; i < num_roots; ++i)
+    {
+      m_index[i] = i;
+      m_sources.emplace_back(i, 0);
+    }
+    compute_geometry();
+  }
+
+  std::size_t num_vertices() const { return num_cells() + 1; }
+
+  std::size_t num_cells() const { return m_level.size(); }
+
+  int max_level() const { return m_max_level; }
+
+  int level(std::size_t i) const { return m_level[i]; }
+
+  point_type get_vertex(std::size_t i) const { return i < num_cells() ? m_left[i] : m_x1; }
+
+  std::tuple<point_type, point_type> get_cell(std::size_t i) const
+  { return std::make_tuple(m_left[i], i + 1 < num_cells() ? m_left[i + 1] : m_x1); }
+
+  T J(std::size_t i) const { return m_J[i]; }
+
+  T inv_J(std::size_t i) const { return m_invJ[i]; }
+
+  T min_cell_size() const { return m_minSize; }
+
+  // contiguous arrays of the geometry of all cells
+  const T* J_data() const { return m_J.data(); }
+
+  const T* inv_J_data() const { return m_invJ.data(); }
+
+  // refines (flag > 0), coarsens (flag < 0), or keeps (flag == 0) each cell; the flags
+  // are adjusted so that the levels stay within [0, max_level], two siblings coarsen
+  // only if both are flagged, and the levels of neighbors differ by at most one (2:1
+  // balance); returns whether the mesh changed
+  bool adapt(const std::vector<int>& flags);
+
+  // data of np nodes per cell, e.g., the solution, from the mesh before the last
+  // adapt() to the current mesh (see binary_tree_transfer); the values can be variables
+  // as long as the operators of variable.h are defined, in which case V is given
+  // explicitly for zip iterators, e.g., the variable_type of the discrete operator
+  template<typename ConstItr, typename Itr,
+           typename V = typename std::iterator_traits<ConstItr>::value_type>
+  void transfer(std::size_t np, ConstItr in, Itr out) const;
+
+private:
+  void compute_geometry();
+
+  T cell_size(int level) const { return m_root_size / static_cast<T>(std::uint64_t(1) << level); }
+
+  // the sibling of leaf i if it is a leaf as well, otherwise num_cells()
+  std::size_t sibling(std::size_t i) const
+  {
+    if (m_level[i] == 0) return num_cells();
+    std::size_t j = m_index[i] % 2 == 0 ? i + 1 : i - 1;
+    if (j >= num_cells() || m_level[j] != m_level[i] || (m_index[j] ^ m_index[i]) != 1) return num_cells();
+    return j;
+  }
+
+private:
+  T   m_x0;
+  T   m_x1;
+  T   m_root_size;
+  int m_max_level;
+
+  // leaves from left to right: the level and the index among the cells of the level
+  std::vector<int>           m_level;
+  std::vector<std::uint64_t> m_index;
+
+  // the cell before the last adapt() and how the leaf comes from it: 0 kept, 1 (2) the
+  // left (right) half of it, or 3 the parent of it and the next cell
+  std::vector<std::pair<std::size_t, int>> m_sources;
+
+  // geometry
+  std::vector<T> m_left;
+  std::vector<T> m_J;
+  std::vector<T> m_invJ;
+  T              m_minSize;
+};
+
+template<typename T>
+bool adaptive_mesh_1d<T>::adapt(const std::vector<int>& flags)
+{
+  assert(flags.size() == num_cells());
+  const std::size_t n = num_cells();
+
+  // target levels
+  std::vector<int> target(n);
+  for (std::size_t i = 0; i < n; ++i)
+    target[i] = std::clamp(m_level[i] + (flags[i] > 0 ? 1 : (flags[i] < 0 ? -1 : 0)), 0, m_max_level);
+
+  // the adjustments only raise the target levels, so they terminate
+  bool changed = true;
+  while (changed)
+  {
+    changed = false;
+    for (std::size_t i = 0; i < n; ++i)
+      if (target[i] < m_level[i])
+      {
+        std::size_t j = sibling(i);
+        if (j == n || target[j] >= m_level[j]) { target[i] = m_level[i]; changed = true; }
+      }
+    for (std::size_t i = 0; i + 1 < n; ++i)
+    {
+      if (target[i] > target[i + 1] + 1) { target[i + 1]++; changed = true; }
+      if (target[i + 1] > target[i] + 1) { target[i]++; changed = true; }
+    }
+  }
+
+  // nothing changes, so the transfer from the mesh before is a copy
+  if (std::equal(target.begin(), target.end(), m_level.begin()))
+  {
+    m_sources.clear();
+    for (std::size_t i = 0; i < n; ++i) m_sources.emplace_back(i, 0);
+    return false;
+  }
+
+  // repack the leaves
+  std::vector<int> level;
+  std::vector<std::uint64_t> index;
+  m_sources.clear();
+  level.reserve(n + n / 2);
+  index.reserve(n + n / 2);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    if (target[i] > m_level[i])
+    {
+      for (int c = 0; c < 2; ++c)
+      {
+        level.push_back(m_level[i] + 1);
+        index.push_back(2 * m_index[i] + c);
+        m_sources.emplace_back(i, 1 + c);
+      }
+    }
+    else if (target[i] < m_level[i])
+    {
+      // the left sibling comes first
+      assert(m_index[i] % 2 == 0 && sibling(i) == i + 1);
+      level.push_back(m_level[i] - 1);
+      index.push_back(m_index[i] / 2);
+      m_sources.emplace_back(i, 3);
+      ++i;
+    }
+    else
+    {
+      level.push_back(m_level[i]);
+      index.push_back(m_index[i]);
+      m_sources.emplace_back(i, 0);
+    }
+  }
+  m_level.swap(level);
+  m_index.swap(index);
+
+  compute_geometry();
+  return true;
+}
+
+template<typename T> template<typename ConstItr, typename Itr, typename V>
+void adaptive_mesh_1d<T>::transfer(std::size_t np, ConstItr in, Itr out) const
+{
+  const auto& tr = binary_tree_transfer<T>::get(np);
+
+  for (std::size_t k = 0; k < num_cells(); ++k)
+  {
+    std::size_t i = m_sources[k].first;
+    int kind = m_sources[k].second;
+    for (std::size_t a = 0; a < np; ++a)
+    {
+      V v = initialize_variable_to_zero<V>();
+      if (kind == 0) v = V(*(in + (i * np + a)));
+      else if (kind < 3)
+        for (std::size_t b = 0; b < np; ++b) v += tr.prolongation(kind - 1)(a, b) * V(*(in + (i * np + b)));
+      else
+        for (std::size_t b = 0; b < np; ++b)
+        {
+          v += tr.restriction(0)(a, b) * V(*(in + (i * np + b)));
+          v += tr.restriction(1)(a, b) * V(*(in + ((i + 1) * np + b)));
+        }
+      *(out + (k * np + a)) = v;
+    }
+  }
+}
+
+template<typename T>
+void adaptive_mesh_1d<T>::compute_geometry()
+{
+  std::size_t n = num_cells();
+  m_left.resize(n);
+  m_J.resize(n);
+  m_invJ.resize(n);
+  m_minSize = std::numeric_limits<T>::max();
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    T h = cell_size(m_level[i]);
+    m_left[i] = m_x0 + static_cast<T>(m_index[i]) * h;
+    m_J[i] = mapping_segment::J(m_left[i], m_left[i] + h);
+    m_invJ[i] = const_val<T, 1> / m_J[i];
+    if (h < m_minSize) m_minSize = h;
+  }
+}
+
+// flags for adaptive_mesh_1d::adapt() from an indicator of the cells, e.g., of the jumps
+// or the smoothness of the solution: refine above refine_above, coarsen below
+// coarsen_below, and keep otherwise
+template<typename T, typename Indicator>
+std::vector<int> mark_cells(std::size_t num_cells, Indicator indicator, T refine_above, T coarsen_below)
+{
+  assert(coarsen_below <= refine_above);
+  std::vector<int> flags(num_cells, 0);
+  for (std::size_t i = 0; i < num_cells; ++i)
+  {
+    T v = indicator(i);
+    if (v > refine_above) flags[i] = 1;
+    else if (v < coarsen_below) flags[i] = -1;
+  }
+  return flags;
+}
+
+}
+
+#endif
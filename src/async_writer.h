@@ -0,0 +1,185 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#ifndef ASYNC_WRITER_H
+#define ASYNC_WRITER_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+namespace rdg {
+
+// Output of the solution on a dedicated writer thread: write() copies the columns, e.g.,
+// the node positions and the variables, into a free staging buffer and returns, and the
+// writer thread serializes the buffers in the order they were written by the given write
+// function while the time loop continues. There are num_buffers staging buffers (two,
+// i.e., double buffering, by default), reused without reallocation; if all of them are
+// queued or being serialized, i.e., the writer falls behind, write() blocks until one is
+// free (back pressure) instead of taking more memory.
+//
+// NOTE: An exception thrown by the write function, e.g., std::runtime_error for a file
+// NOTE: that cannot be opened, is rethrown by the next write() or flush().
+template<typename T>
+class async_writer
+{
+public:
+  struct snapshot
+  {
+    std::string                 name;     // e.g., the name of the file
+    T                           time = 0;
+    std::vector<std::vector<T>> columns;
+  };
+
+  explicit async_writer(std::function<void(const snapshot&)> write, std::size_t num_buffers = 2)
+    : m_write(std::move(write)), m_buffers(std::max<std::size_t>(num_buffers, 1))
+  {
+    for (auto& b : m_buffers) m_free.push_back(&b);
+    m_thread = std::thread([this]() { work(); });
+  }
+
+  // serializes the buffers still queued before it returns
+  ~async_writer()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_queued.notify_all();
+    m_thread.join();
+  }
+
+  async_writer(const async_writer&) = delete;
+  async_writer& operator=(const async_writer&) = delete;
+
+  // queues the snapshot of the columns [begin, begin + n) of the iterators
+  template<typename... ConstItr>
+  void write(const std::string& name, T time, std::size_t n, ConstItr... columns);
+
+  // waits until the queued snapshots are serialized
+  void flush()
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_freed.wait(lock, [this]() { return m_free.size() == m_buffers.size(); });
+    rethrow(lock);
+  }
+
+  // number of the write() calls blocked by the back pressure and the time they waited
+  std::size_t num_stalls() const { std::lock_guard<std::mutex> lock(m_mutex); return m_stalls; }
+  double stall_seconds() const { std::lock_guard<std::mutex> lock(m_mutex); return m_stall_seconds; }
+
+private:
+  void rethrow(std::unique_lock<std::mutex>& lock)
+  {
+    if (!m_error) return;
+    std::exception_ptr error = m_error;
+    m_error = nullptr;
+    lock.unlock();
+    std::rethrow_exception(error);
+  }
+
+  void work()
+  {
+    while (true)
+    {
+      snapshot* s;
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_queued.wait(lock, [this]() { return m_stop || !m_queue.empty(); });
+        if (m_queue.empty()) return;
+        s = m_queue.front();
+        m_queue.pop_front();
+      }
+
+      std::exception_ptr error;
+      try { m_write(*s); }
+      catch (...) { error = std::current_exception(); }
+
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (error && !m_error) m_error = error;
+        m_free.push_back(s);
+      }
+      m_freed.notify_all();
+    }
+  }
+
+private:
+  std::function<void(const snapshot&)> m_write;
+  std::vector<snapshot>                m_buffers;
+
+  // the staging buffers are either free or queued, or being serialized if in neither
+  mutable std::mutex      m_mutex;
+  std::condition_variable m_queued;
+  std::condition_variable m_freed;
+  std::deque<snapshot*>   m_free;
+  std::deque<snapshot*>   m_queue;
+  bool                    m_stop = false;
+  std::exception_ptr      m_error;
+
+  std::size_t m_stalls = 0;
+  double      m_stall_seconds = 0.;
+
+  std::thread m_thread;
+};
+
+template<typename T> template<typename... ConstItr>
+void async_writer<T>::write(const std::string& name, T time, std::size_t n, ConstItr... columns)
+{
+  snapshot* s;
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    rethrow(lock);
+    if (m_free.empty())
+    {
+      auto t0 = std::chrono::steady_clock::now();
+      m_freed.wait(lock, [this]() { return !m_free.empty(); });
+      m_stalls++;
+      m_stall_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    }
+    s = m_free.front();
+    m_free.pop_front();
+  }
+
+  // the copies run in the calling thread, outside of the lock
+  s->name = name;
+  s->time = time;
+  s->columns.resize(sizeof...(columns));
+  std::size_t k = 0;
+  ((s->columns[k].resize(n), std::copy(columns, columns + n, s->columns[k].begin()), ++k), ...);
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_queue.push_back(s);
+  }
+  m_queued.notify_one();
+}
+
+}
+
+#endif
@@ -0,0 +1,130 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#ifndef CARTESIAN_MESH_1D_H
+#define CARTESIAN_MESH_1D_H
+
+#include <cassert>
+#include <cstddef>
+#include <tuple>
+#include <vector>
+#include <limits>
+#include <cmath>
+
+#include "const_val.h"
+#include "mapping_segment.h"
+
+namespace rdg {
+
+// 1D mesh of arbitrary vertex coordinates, e.g., graded or clustered around shocks. It
+// has the same interface as uniform_cartesian_mesh_1d so that it can be used in place
+// of it. The geometry of the cells (J, 1/J, and the minimum cell size) is computed once
+// at construction and kept in contiguous arrays for the element loops to read.
+template<typename T>
+class cartesian_mesh_1d
+{
+public:
+  using point_type = T;
+
+  // the vertex coordinates must be strictly increasing
+  template<typename InputItr>
+  cartesian_mesh_1d(InputItr begin, InputItr end) : m_vertices(begin, end)
+  { compute_geometry(); }
+
+  // uniform mesh of n cells on [x0, x1]
+  cartesian_mesh_1d(T x0, T x1, std::size_t n)
+  {
+    assert(x0 < x1 && n > 0);
+    T delta = (x1 - x0) / static_cast<T>(n);
+    for (std::size_t i = 0; i < n; ++i) m_vertices.push_back(x0 + i * delta);
+    m_vertices.push_back(x1);
+    compute_geometry();
+  }
+
+  std::size_t num_vertices() const { return m_vertices.size(); }
+
+  std::size_t num_cells() const { return m_vertices.size() - 1; }
+
+  point_type get_vertex(std::size_t i) const { return m_vertices[i]; }
+
+  std::tuple<point_type, point_type> get_cell(std::size_t i) const
+  { return std::make_tuple(m_vertices[i], m_vertices[i + 1]); }
+
+  T J(std::size_t i) const { return m_J[i]; }
+
+  T inv_J(std::size_t i) const { return m_invJ[i]; }
+
+  T min_cell_size() const { return m_minSize; }
+
+  // contiguous arrays of the geometry of all cells
+  const T* J_data() const { return m_J.data(); }
+
+  const T* inv_J_data() const { return m_invJ.data(); }
+
+private:
+  void compute_geometry()
+  {
+    assert(m_vertices.size() > 1);
+
+    std::size_t n = num_cells();
+    m_J.resize(n);
+    m_invJ.resize(n);
+    m_minSize = std::numeric_limits<T>::max();
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      assert(m_vertices[i] < m_vertices[i + 1]);
+      m_J[i] = mapping_segment::J(m_vertices[i], m_vertices[i + 1]);
+      m_invJ[i] = const_val<T, 1> / m_J[i];
+      if (m_vertices[i + 1] - m_vertices[i] < m_minSize) m_minSize = m_vertices[i + 1] - m_vertices[i];
+    }
+  }
+
+private:
+  std::vector<T> m_vertices;
+  std::vector<T> m_J;
+  std::vector<T> m_invJ;
+  T              m_minSize;
+};
+
+// vertex coordinates of n cells on [x0, x1] clustered around xc, x0 < xc < x1, by the
+// sinh stretching x = x0 + (xc - x0) * (1 + sinh(beta * (xi - B)) / sinh(beta * B)) of
+// xi uniform in [0, 1], where B is such that xi = 1 maps to x1; beta > 0 controls the
+// clustering, i.e., the larger beta the finer the cells around xc
+template<typename T, typename OutputItr>
+void clustered_vertices(T x0, T x1, std::size_t n, T xc, T beta, OutputItr it)
+{
+  assert(x0 < xc && xc < x1 && n > 0 && beta > 0);
+
+  T a = (xc - x0) / (x1 - x0);
+  T B = std::log((const_val<T, 1> + (std::exp(beta) - const_val<T, 1>) * a) /
+                 (const_val<T, 1> + (std::exp(- beta) - const_val<T, 1>) * a)) / (const_val<T, 2> * beta);
+
+  *it++ = x0;
+  for (std::size_t i = 1; i < n; ++i)
+  {
+    T xi = static_cast<T>(i) / static_cast<T>(n);
+    *it++ = x0 + (xc - x0) * (const_val<T, 1> + std::sinh(beta * (xi - B)) / std::sinh(beta * B));
+  }
+  *it++ = x1;
+}
+
+}
+
+#endif
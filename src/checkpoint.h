@@ -0,0 +1,365 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <tuple>
+#include <fstream>
+#include <stdexcept>
+#include <algorithm>
+#include <initializer_list>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define RDG_CHECKPOINT_MMAP
+#endif
+
+#include "variable_order_layout.h"
+#include "float_codec.h"
+
+namespace rdg {
+
+// Binary checkpoints of the solution for restarts. A checkpoint file is
+//
+//   header        checkpoint_header, 128 bytes
+//   orders        int32 order of each cell
+//   vertices      num_cells + 1 scalars, the ends of the cells
+//   variables     num_variables arrays of num_dofs scalars, in the DOF order of the layout,
+//                 or their streams of the lossless float codec (see float_codec.h)
+//
+// where every section starts at a multiple of checkpoint_alignment bytes, so the arrays of
+// a mapped file can be used in place, and the file is padded to a multiple of it. The
+// checksum is the 64-bit FNV-1a hash of the 8-byte words of the file with the checksum
+// field zeroed. The data are in the byte order of the machine that wrote them, which is
+// recorded in the header, and a file of another byte order is rejected.
+constexpr std::uint32_t checkpoint_version   = 2; // 2 added the compression of the variables
+constexpr std::size_t   checkpoint_alignment = 64;
+
+enum class checkpoint_compression : std::uint32_t { none = 0, lossless = 1 };
+
+struct checkpoint_header
+{
+  char          magic[8];         // "RDGCKPT"
+  std::uint32_t version;
+  std::uint32_t byte_order;       // 0x01020304 as written
+  std::uint32_t scalar_size;      // sizeof of the scalar type
+  std::uint32_t num_variables;
+  std::uint64_t num_cells;
+  std::uint64_t num_dofs;
+  std::uint64_t step;
+  double        time;
+  double        dt;               // timestep size of the next step
+  std::uint64_t orders_offset;    // offsets of the sections in bytes
+  std::uint64_t vertices_offset;
+  std::uint64_t variables_offset;
+  std::uint64_t variable_stride;  // bytes from one variable array to the next; 0 if compressed
+  std::uint64_t file_size;
+  std::uint64_t checksum;
+  std::uint32_t compression;      // checkpoint_compression, 0 in version 1
+  std::uint32_t reserved[3];
+};
+static_assert(sizeof(checkpoint_header) == 128, "the checkpoint header must be 128 bytes");
+
+namespace detail {
+
+inline std::uint64_t align_checkpoint(std::uint64_t bytes)
+{ return (bytes + checkpoint_alignment - 1) / checkpoint_alignment * checkpoint_alignment; }
+
+// 64-bit FNV-1a of the 8-byte words of a byte stream, fed in pieces of any size
+class checkpoint_hash
+{
+public:
+  void update(const void* data, std::size_t n)
+  {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    while (n > 0 && m_pending > 0)
+    {
+      m_word[m_pending++] = *p++;
+      --n;
+      if (m_pending == 8) { mix(m_word); m_pending = 0; }
+    }
+    for (; n >= 8; p += 8, n -= 8) mix(p);
+    std::memcpy(m_word, p, n);
+    m_pending = n;
+  }
+
+  std::uint64_t value() const { assert(m_pending == 0); return m_hash; }
+
+private:
+  void mix(const unsigned char* bytes)
+  {
+    std::uint64_t w;
+    std::memcpy(&w, bytes, 8);
+    m_hash = (m_hash ^ w) * 0x100000001b3ull;
+  }
+
+  std::uint64_t m_hash = 0xcbf29ce484222325ull;
+  unsigned char m_word[8];
+  std::size_t   m_pending = 0;
+};
+
+}
+
+// writes the checkpoint of the variables, each an array of layout.num_dofs() scalars,
+// on the mesh, and returns its size in bytes; the file is written next to it first and
+// renamed when complete, so an interrupted run leaves the previous checkpoint intact;
+// the variables are compressed in blocks in parallel on the space, e.g., the one of the
+// solver, and the file is the same on any space
+template<typename T, typename MESH, typename Space = serial_space>
+std::uint64_t save_checkpoint(const std::string& filename, const MESH& mesh, const variable_order_layout& layout,
+                              std::uint64_t step, double time, double dt, std::initializer_list<const T*> variables,
+                              checkpoint_compression compression = checkpoint_compression::none,
+                              const Space& space = Space())
+{
+  assert(mesh.num_cells() == layout.num_cells());
+
+  const std::uint64_t numCells = layout.num_cells(), numDofs = layout.num_dofs();
+  checkpoint_header h{};
+  std::memcpy(h.magic, "RDGCKPT", 8);
+  h.version = checkpoint_version;
+  h.byte_order = 0x01020304;
+  h.scalar_size = sizeof(T);
+  h.num_variables = static_cast<std::uint32_t>(variables.size());
+  h.num_cells = numCells;
+  h.num_dofs = numDofs;
+  h.step = step;
+  h.time = time;
+  h.dt = dt;
+  h.orders_offset = detail::align_checkpoint(sizeof(checkpoint_header));
+  h.vertices_offset = detail::align_checkpoint(h.orders_offset + numCells * sizeof(std::int32_t));
+  h.variables_offset = detail::align_checkpoint(h.vertices_offset + (numCells + 1) * sizeof(T));
+  h.compression = static_cast<std::uint32_t>(compression);
+
+  // the streams of the compressed variables, each in a section of its own
+  std::vector<std::vector<std::uint8_t>> streams;
+  if (compression == checkpoint_compression::lossless)
+  {
+    for (const T* v : variables)
+    {
+      streams.emplace_back();
+      compress_floats(space, v, numDofs, streams.back());
+    }
+    h.variable_stride = 0;
+    h.file_size = h.variables_offset;
+    for (const auto& s : streams) h.file_size += detail::align_checkpoint(s.size());
+  }
+  else
+  {
+    h.variable_stride = detail::align_checkpoint(numDofs * sizeof(T));
+    h.file_size = h.variables_offset + h.variable_stride * variables.size();
+  }
+
+  std::vector<std::int32_t> orders(numCells);
+  std::vector<T> vertices(numCells + 1);
+  for (std::size_t i = 0; i < numCells; ++i)
+  {
+    orders[i] = layout.order(i);
+    auto cell = mesh.get_cell(i);
+    vertices[i] = std::get<0>(cell);
+    if (i + 1 == numCells) vertices[i + 1] = std::get<1>(cell);
+  }
+
+  std::string tmp = filename + ".tmp";
+  std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+  if (!file) throw std::runtime_error("cannot open " + tmp);
+
+  detail::checkpoint_hash hash;
+  std::uint64_t pos = 0;
+  const char zeros[checkpoint_alignment] = {};
+  auto put = [&](const void* data, std::uint64_t n)
+  {
+    file.write(static_cast<const char*>(data), n);
+    hash.update(data, n);
+    pos += n;
+  };
+  auto pad = [&](std::uint64_t to) { while (pos < to) put(zeros, std::min<std::uint64_t>(to - pos, checkpoint_alignment)); };
+
+  put(&h, sizeof(h));
+  pad(h.orders_offset);
+  put(orders.data(), numCells * sizeof(std::int32_t));
+  pad(h.vertices_offset);
+  put(vertices.data(), (numCells + 1) * sizeof(T));
+  pad(h.variables_offset);
+  if (compression == checkpoint_compression::lossless)
+    for (const auto& s : streams)
+    {
+      put(s.data(), s.size());
+      pad(detail::align_checkpoint(pos));
+    }
+  else
+    for (const T* v : variables)
+    {
+      std::uint64_t begin = pos;
+      put(v, numDofs * sizeof(T));
+      pad(begin + h.variable_stride);
+    }
+
+  h.checksum = hash.value();
+  file.seekp(0);
+  file.write(reinterpret_cast<const char*>(&h), sizeof(h));
+  file.close();
+  if (!file) throw std::runtime_error("cannot write " + tmp);
+  if (std::rename(tmp.c_str(), filename.c_str()) != 0) throw std::runtime_error("cannot rename " + tmp);
+  return h.file_size;
+}
+
+// A checkpoint mapped into memory for a restart: nothing is parsed or copied, the pages
+// are read as the arrays are used, and verify() checks the whole file against its checksum.
+// The variables of a compressed checkpoint are decompressed by read_variable().
+template<typename T>
+class mapped_checkpoint
+{
+public:
+  explicit mapped_checkpoint(const std::string& filename)
+  {
+#ifdef RDG_CHECKPOINT_MMAP
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("cannot open " + filename);
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(checkpoint_header)))
+    {
+      ::close(fd);
+      throw std::runtime_error("not a checkpoint: " + filename);
+    }
+    m_size = static_cast<std::size_t>(st.st_size);
+    void* p = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) throw std::runtime_error("cannot map " + filename);
+    m_data = static_cast<const char*>(p);
+#else
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file) throw std::runtime_error("cannot open " + filename);
+    m_size = static_cast<std::size_t>(file.tellg());
+    m_buffer.resize(m_size / sizeof(std::uint64_t) + 1);
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(m_buffer.data()), m_size);
+    if (!file || m_size < sizeof(checkpoint_header)) throw std::runtime_error("not a checkpoint: " + filename);
+    m_data = reinterpret_cast<const char*>(m_buffer.data());
+#endif
+
+    const checkpoint_header& h = header();
+    std::string error;
+    if (std::memcmp(h.magic, "RDGCKPT", 8) != 0) error = "not a checkpoint: ";
+    else if (h.version < 1 || h.version > checkpoint_version) error = "unsupported checkpoint version: ";
+    else if (h.byte_order != 0x01020304) error = "checkpoint of another byte order: ";
+    else if (h.scalar_size != sizeof(T)) error = "checkpoint of another scalar type: ";
+    else if (h.file_size != m_size) error = "truncated checkpoint: ";
+    if (!error.empty())
+    {
+      unmap();
+      throw std::runtime_error(error + filename);
+    }
+  }
+
+  ~mapped_checkpoint() { unmap(); }
+
+  mapped_checkpoint(const mapped_checkpoint&) = delete;
+  mapped_checkpoint& operator=(const mapped_checkpoint&) = delete;
+
+  const checkpoint_header& header() const { return *reinterpret_cast<const checkpoint_header*>(m_data); }
+
+  std::size_t num_cells() const { return header().num_cells; }
+  std::size_t num_dofs() const { return header().num_dofs; }
+  std::size_t num_variables() const { return header().num_variables; }
+  std::uint64_t step() const { return header().step; }
+  double time() const { return header().time; }
+  double dt() const { return header().dt; }
+
+  variable_order_layout layout() const
+  {
+    const std::int32_t* orders = reinterpret_cast<const std::int32_t*>(m_data + header().orders_offset);
+    return variable_order_layout(std::vector<int>(orders, orders + num_cells()));
+  }
+
+  // num_cells() + 1 ends of the cells
+  const T* vertices() const { return reinterpret_cast<const T*>(m_data + header().vertices_offset); }
+
+  checkpoint_compression compression() const
+  { return header().version < 2 ? checkpoint_compression::none : static_cast<checkpoint_compression>(header().compression); }
+
+  // num_dofs() values of the variable k, of a checkpoint that is not compressed
+  const T* variable(std::size_t k) const
+  {
+    assert(k < num_variables() && compression() == checkpoint_compression::none);
+    return reinterpret_cast<const T*>(m_data + header().variables_offset + k * header().variable_stride);
+  }
+
+  // copies or decompresses the num_dofs() values of the variable k to out, on the space
+  template<typename Space = serial_space>
+  void read_variable(std::size_t k, T* out, const Space& space = Space()) const
+  {
+    assert(k < num_variables());
+    if (compression() == checkpoint_compression::none)
+    {
+      const T* v = variable(k);
+      parallel_for(space, num_dofs(), [](std::size_t) { return 1.; }, [&](std::size_t begin, std::size_t end)
+      { std::memcpy(out + begin, v + begin, (end - begin) * sizeof(T)); });
+      return;
+    }
+
+    std::size_t pos = header().variables_offset;
+    for (std::size_t j = 0; j <= k; ++j)
+    {
+      std::size_t size = float_stream_size(reinterpret_cast<const std::uint8_t*>(m_data + pos), m_size - pos);
+      if (j == k) decompress_floats(space, reinterpret_cast<const std::uint8_t*>(m_data + pos), size, out, num_dofs());
+      pos += detail::align_checkpoint(size);
+    }
+  }
+
+  bool verify() const
+  {
+    checkpoint_header h = header();
+    h.checksum = 0;
+    detail::checkpoint_hash hash;
+    hash.update(&h, sizeof(h));
+    hash.update(m_data + sizeof(h), m_size - sizeof(h));
+    return hash.value() == header().checksum;
+  }
+
+private:
+  void unmap()
+  {
+#ifdef RDG_CHECKPOINT_MMAP
+    if (m_data) ::munmap(const_cast<char*>(m_data), m_size);
+#endif
+    m_data = nullptr;
+  }
+
+  const char* m_data = nullptr;
+  std::size_t m_size = 0;
+#ifndef RDG_CHECKPOINT_MMAP
+  std::vector<std::uint64_t> m_buffer;
+#endif
+};
+
+}
+
+#endif
@@ -23,11 +23,13 @@
 
 #include <cassert>
 #include <vector>
+#include <array>
 
 #include "const_val.h"
 #include "variable.h"
 #include "dense_matrix.h"
 #include "reference_segment.h"
+#include "reference_segment_traits.h"
 
 namespace rdg {
 
@@ -44,33 +46,48 @@ class convective_flux_div_1d                      // FLUX - flux calculators and
 public:
   using T = typename FLUX::value_type;
 
-  convective_flux_div_1d(const REFE& elem, const FLUX& flux) : m_ref_elem(&elem), m_flux_op(&flux) {}
+  // the derivative matrix and the mass matrix are computed once here, not for each element
+  convective_flux_div_1d(const REFE& elem, const FLUX& flux)
+    : m_ref_elem(&elem), m_flux_op(&flux), m_D(elem.derivative_matrix_wrt_r()), m_M(elem.mass_matrix()) {}
 
   template<typename ZipItr, typename FItr, typename Itr>
-  void apply(ZipItr ins, FItr surf_fluxes, T J, Itr outs);
+  void apply(ZipItr ins, FItr surf_fluxes, T J, Itr outs)
+  { apply_volume(ins, outs); apply_surface(ins, surf_fluxes, J, outs); }
+
+  // the two phases of apply(): the volume integration, which needs only the values of the
+  // element, and the surface integration lifting plus the division by J, which needs the
+  // numerical fluxes at the faces, i.e., the neighbors, and is applied to the result of
+  // the volume integration in outs; the latter can wait for the traces of the neighbors
+  // while the volume integrations of the elements run
+  template<typename ZipItr, typename Itr>
+  void apply_volume(ZipItr ins, Itr outs);
+
+  template<typename ZipItr, typename FItr, typename Itr>
+  void apply_surface(ZipItr ins, FItr surf_fluxes, T J, Itr outs);
 
 private:
   using V = typename FLUX::variable_type;
+  using matrix_type = typename REFE::matrix_type;
 
   const REFE*     m_ref_elem;
   const FLUX*     m_flux_op;
+  matrix_type     m_D;
+  matrix_type     m_M;
 };
 
 // NOTE: the implementation for 1D is different from 2D & 3D in the following:
 // NOTE: 1) the contravariant basis is a constant scalar and cancels with J (their product is one);
 // NOTE: 2) the face nodes are hard coded to be 0 and num_nodes() - 1; and
 // NOTE: 3) the face mass matrix degenerates to scalar 1
-template<typename REFE, typename FLUX> template<typename ZipItr, typename FItr, typename Itr>
-void convective_flux_div_1d<REFE, FLUX>::apply(ZipItr ins, FItr surf_fluxes, T J, Itr outs)
+template<typename REFE, typename FLUX> template<typename ZipItr, typename Itr>
+void convective_flux_div_1d<REFE, FLUX>::apply_volume(ZipItr ins, Itr outs)
 {
-  assert(J > 0);
-
   std::size_t N = m_ref_elem->num_nodes();
   std::vector<V> vol_fluxes(N * N);
 
   // volume integration
   // NOTE: numerical volume fluxes must be consistent and symmetric
-  auto D = m_ref_elem->derivative_matrix_wrt_r();
+  const auto& D = m_D;
   for(std::size_t i = 0; i < N; ++i)
   {
     for(std::size_t j = 0; j < i; ++j)
@@ -85,12 +102,90 @@ void convective_flux_div_1d<REFE, FLUX>::apply(ZipItr ins, FItr surf_fluxes, T J
     for(std::size_t j = 0; j < N; ++j)
       *(outs + i) += const_val<T, 2> * D(i, j) * vol_fluxes[i * N + j];
   }
+}
+
+template<typename REFE, typename FLUX> template<typename ZipItr, typename FItr, typename Itr>
+void convective_flux_div_1d<REFE, FLUX>::apply_surface(ZipItr ins, FItr surf_fluxes, T J, Itr outs)
+{
+  assert(J > 0);
+
+  std::size_t N = m_ref_elem->num_nodes();
+
+  // plus surface integration lifting
+  const auto& M = m_M;
+  *outs -= (*surf_fluxes - m_flux_op->physical_flux(*ins)) / M(0, 0);
+  surf_fluxes++;
+  *(outs + N - 1) -= (m_flux_op->physical_flux(*(ins + N - 1)) - *surf_fluxes) / M(N - 1, N - 1);
+
+  // divide by J
+  T invJ = const_val<T, 1> / J;
+  for(std::size_t i = 0; i < N; ++i) *(outs + i) *= invJ;
+}
+
+// The same calculations as convective_flux_div_1d but for a reference segment of the
+// order fixed at compile time: the nodes, weights, and derivative matrix come from the
+// constexpr tables of reference_segment_traits and the work space is on the stack, so
+// the loops have compile-time trip counts and the matrix entries can be inlined.
+template<int ORDER, typename FLUX>
+class fixed_order_convective_flux_div_1d
+{
+public:
+  using T = typename FLUX::value_type;
+  using traits = reference_segment_traits<T, ORDER>;
+
+  explicit fixed_order_convective_flux_div_1d(const FLUX& flux) : m_flux_op(&flux) {}
+
+  template<typename ZipItr, typename FItr, typename Itr>
+  void apply(ZipItr ins, FItr surf_fluxes, T J, Itr outs) const
+  { apply_volume(ins, outs); apply_surface(ins, surf_fluxes, J, outs); }
+
+  // the two phases of apply() as in convective_flux_div_1d
+  template<typename ZipItr, typename Itr>
+  void apply_volume(ZipItr ins, Itr outs) const;
+
+  template<typename ZipItr, typename FItr, typename Itr>
+  void apply_surface(ZipItr ins, FItr surf_fluxes, T J, Itr outs) const;
+
+private:
+  using V = typename FLUX::variable_type;
+
+  const FLUX*     m_flux_op;
+};
+
+template<int ORDER, typename FLUX> template<typename ZipItr, typename Itr>
+void fixed_order_convective_flux_div_1d<ORDER, FLUX>::apply_volume(ZipItr ins, Itr outs) const
+{
+  constexpr std::size_t N = traits::num_nodes();
+  std::array<V, N * N> vol_fluxes;
+
+  // volume integration
+  for(std::size_t i = 0; i < N; ++i)
+  {
+    for(std::size_t j = 0; j < i; ++j)
+      vol_fluxes[i * N + j] = vol_fluxes[j * N + i];
+
+    vol_fluxes[i * N + i] = m_flux_op->physical_flux(*(ins + i));
+
+    for(std::size_t j = i + 1; j < N; ++j)
+      vol_fluxes[i * N + j] = m_flux_op->numerical_volume_flux(*(ins + i), *(ins + j));
+
+    *(outs + i) = initialize_variable_to_zero<V>();
+    for(std::size_t j = 0; j < N; ++j)
+      *(outs + i) += (const_val<T, 2> * traits::derivative(i, j)) * vol_fluxes[i * N + j];
+  }
+}
+
+template<int ORDER, typename FLUX> template<typename ZipItr, typename FItr, typename Itr>
+void fixed_order_convective_flux_div_1d<ORDER, FLUX>::apply_surface(ZipItr ins, FItr surf_fluxes, T J, Itr outs) const
+{
+  assert(J > 0);
+
+  constexpr std::size_t N = traits::num_nodes();
 
   // plus surface integration lifting
-  auto M = m_ref_elem->mass_matrix();
-  *outs -= (*surf_fluxes - vol_fluxes[0]) / M(0, 0);
+  *outs -= (*surf_fluxes - m_flux_op->physical_flux(*ins)) / traits::weight(0);
   surf_fluxes++;
-  *(outs + N - 1) -= (vol_fluxes[N * N - 1] - *surf_fluxes) / M(N - 1, N - 1);
+  *(outs + N - 1) -= (m_flux_op->physical_flux(*(ins + N - 1)) - *surf_fluxes) / traits::weight(N - 1);
 
   // divide by J
   T invJ = const_val<T, 1> / J;
@@ -0,0 +1,151 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#ifndef CONVECTIVE_FLUX_DIV_2D
+#define CONVECTIVE_FLUX_DIV_2D 
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include "const_val.h"
+#include "variable.h"
+#include "reference_quadrilateral.h"
+
+namespace rdg {
+
+// element-wise calculations of divergence of convective flux in two dimensional space
+// on affine rectangular elements, i.e., elements of a cartesian mesh
+//
+// The flux differencing of convective_flux_div_1d is applied along each line of nodes
+// of the tensor-product reference quadrilateral, in r with the fluxes along x and in s
+// with the fluxes along y, which costs O(N^3) two-point fluxes instead of O(N^4).
+//
+// NOTE: FLUX provides physical_flux(var, dir) and numerical_volume_flux(var_minus,
+// NOTE: var_plus, dir) of the flux along the axis dir, i.e., 0 for x and 1 for y.
+// NOTE: The surface fluxes are the numerical fluxes along the axis normal to each face
+// NOTE: (not along the outward normal), N of each face of the element in the order of
+// NOTE: the faces and of the face nodes of the reference quadrilateral.
+template<typename REFE, typename FLUX> // REFE - reference_quadrilateral 
+class convective_flux_div_2d                      // FLUX - flux calculators and associated types
+{
+public:
+  using T = typename FLUX::value_type;
+
+  // the derivative matrix and the weights are computed once here, not for each element
+  convective_flux_div_2d(const REFE& elem, const FLUX& flux);
+
+  // dr_dx and ds_dy are the constant metric terms of the affine element
+  template<typename ZipItr, typename FItr, typename Itr>
+  void apply(ZipItr ins, FItr surf_fluxes, T dr_dx, T ds_dy, Itr outs);
+
+private:
+  using V = typename FLUX::variable_type;
+
+  // flux differencing along the lines of nodes i0 + stride * k, k = 0, ..., N - 1,
+  // plus the lifting of the surface fluxes at both ends of the line
+  template<typename FItr>
+  void apply_line(int dir, std::size_t i0, std::size_t stride, FItr surf_minus, FItr surf_plus,
+                  std::vector<V>& out);
+
+  const REFE*     m_ref_elem;
+  const FLUX*     m_flux_op;
+  std::size_t     m_N;
+  std::vector<T>  m_D2; // two times the 1D derivative matrix, row major
+  std::vector<T>  m_invW; // inverse of the 1D quadrature weights
+
+  // work space
+  std::vector<V>  m_u;
+  std::vector<V>  m_out_r;
+  std::vector<V>  m_out_s;
+};
+
+template<typename REFE, typename FLUX>
+convective_flux_div_2d<REFE, FLUX>::convective_flux_div_2d(const REFE& elem, const FLUX& flux)
+  : m_ref_elem(&elem), m_flux_op(&flux), m_N(elem.num_nodes_1d()),
+    m_D2(m_N * m_N), m_invW(m_N), m_u(elem.num_nodes()), m_out_r(elem.num_nodes()), m_out_s(elem.num_nodes())
+{
+  const auto& D = elem.derivative_matrix_1d();
+  auto M = elem.segment().mass_matrix();
+  for (std::size_t i = 0; i < m_N; ++i)
+  {
+    for (std::size_t j = 0; j < m_N; ++j) m_D2[i * m_N + j] = const_val<T, 2> * D(i, j);
+    m_invW[i] = const_val<T, 1> / M(i, i);
+  }
+}
+
+template<typename REFE, typename FLUX> template<typename FItr>
+void convective_flux_div_2d<REFE, FLUX>::apply_line(int dir, std::size_t i0, std::size_t stride,
+                                                    FItr surf_minus, FItr surf_plus, std::vector<V>& out)
+{
+  const std::size_t N = m_N;
+  V f_first, f_last;
+
+  // NOTE: numerical volume fluxes must be consistent and symmetric
+  for (std::size_t i = 0; i < N; ++i)
+  {
+    std::size_t ni = i0 + stride * i;
+    V fii = m_flux_op->physical_flux(m_u[ni], dir);
+    if (i == 0) f_first = fii;
+    if (i == N - 1) f_last = fii;
+    out[ni] += m_D2[i * N + i] * fii;
+
+    for (std::size_t k = i + 1; k < N; ++k)
+    {
+      std::size_t nk = i0 + stride * k;
+      V fik = m_flux_op->numerical_volume_flux(m_u[ni], m_u[nk], dir);
+      out[ni] += m_D2[i * N + k] * fik;
+      out[nk] += m_D2[k * N + i] * fik;
+    }
+  }
+
+  // plus surface integration lifting
+  out[i0] -= m_invW[0] * (*surf_minus - f_first);
+  out[i0 + stride * (N - 1)] -= m_invW[N - 1] * (f_last - *surf_plus);
+}
+
+template<typename REFE, typename FLUX> template<typename ZipItr, typename FItr, typename Itr>
+void convective_flux_div_2d<REFE, FLUX>::apply(ZipItr ins, FItr surf_fluxes, T dr_dx, T ds_dy, Itr outs)
+{
+  assert(dr_dx > 0 && ds_dy > 0);
+
+  const std::size_t N = m_N;
+  const std::size_t Np = N * N;
+  for (std::size_t n = 0; n < Np; ++n)
+  {
+    m_u[n] = *(ins + n);
+    m_out_r[n] = initialize_variable_to_zero<V>();
+    m_out_s[n] = initialize_variable_to_zero<V>();
+  }
+
+  // lines along r (fluxes along x) and along s (fluxes along y); the surface
+  // fluxes of the faces 0, 1, 2, and 3 start at 0, N, 2N, and 3N, respectively
+  for (std::size_t j = 0; j < N; ++j)
+    apply_line(0, N * j, 1, surf_fluxes + j, surf_fluxes + N + j, m_out_r);
+  for (std::size_t i = 0; i < N; ++i)
+    apply_line(1, i, N, surf_fluxes + 2 * N + i, surf_fluxes + 3 * N + i, m_out_s);
+
+  for (std::size_t n = 0; n < Np; ++n)
+    *(outs + n) = dr_dx * m_out_r[n] + ds_dy * m_out_s[n];
+}
+
+}
+
+#endif
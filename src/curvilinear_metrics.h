@@ -0,0 +1,316 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#ifndef CURVILINEAR_METRICS_H
+#define CURVILINEAR_METRICS_H
+
+#include <cassert>
+#include <cstddef>
+#include <cmath>
+#include <array>
+#include <vector>
+
+#include "const_val.h"
+#include "reference_quadrilateral.h"
+#include "reference_hexahedron.h"
+
+namespace rdg {
+
+// Metric terms of curvilinear quadrilaterals, i.e., of the polynomial mappings given by
+// the physical coordinates of the nodes of a reference_quadrilateral (isoparametric
+// geometry), computed once for all elements and stored in SoA arrays, element after
+// element, so that the flux kernels only read them:
+//
+//   J            = x_r y_s - x_s y_r
+//   J a^1        = ( y_s, -x_s)
+//   J a^2        = (-y_r,  x_r)
+//
+// and at the face nodes, in the order of the faces and face nodes of the reference
+// element, the outward unit normal n = +-J a^i / |J a^i| and the scaling |J a^i| of
+// the surface integrals. In 2D the discrete metric identities hold for any polynomial
+// mapping since the derivatives along r and s commute.
+template<typename T>
+class quadrilateral_metrics
+{
+public:
+  // x and y are the coordinates of the nodes of num_elems elements, element after element
+  template<typename ConstItr>
+  quadrilateral_metrics(const reference_quadrilateral<T>& elem, std::size_t num_elems, ConstItr x, ConstItr y);
+
+  std::size_t num_elements() const { return m_num_elems; }
+
+  std::size_t num_nodes() const { return m_Np; }
+
+  std::size_t num_face_nodes() const { return m_Nf; }
+
+  T J(std::size_t e, std::size_t n) const { return m_J[e * m_Np + n]; }
+
+  // component k of the contravariant vector J a^i
+  T Ja(int i, int k, std::size_t e, std::size_t n) const { return m_Ja[2 * i + k][e * m_Np + n]; }
+
+  // component k of the outward unit normal and the scaling at node a of face f
+  T normal(int k, std::size_t e, int f, std::size_t a) const { return m_normal[k][(e * 4 + f) * m_Nf + a]; }
+
+  T scaling(std::size_t e, int f, std::size_t a) const { return m_scaling[(e * 4 + f) * m_Nf + a]; }
+
+  // contiguous arrays of all elements
+  const T* J_data() const { return m_J.data(); }
+
+  const T* Ja_data(int i, int k) const { return m_Ja[2 * i + k].data(); }
+
+  const T* normal_data(int k) const { return m_normal[k].data(); }
+
+  const T* scaling_data() const { return m_scaling.data(); }
+
+private:
+  std::size_t                   m_num_elems;
+  std::size_t                   m_Np;
+  std::size_t                   m_Nf;
+  std::vector<T>                m_J;
+  std::array<std::vector<T>, 4> m_Ja;
+  std::array<std::vector<T>, 2> m_normal;
+  std::vector<T>                m_scaling;
+};
+
+template<typename T> template<typename ConstItr>
+quadrilateral_metrics<T>::quadrilateral_metrics(const reference_quadrilateral<T>& elem, std::size_t num_elems,
+                                                ConstItr x, ConstItr y)
+  : m_num_elems(num_elems), m_Np(elem.num_nodes()), m_Nf(elem.num_face_nodes()),
+    m_J(num_elems * m_Np), m_scaling(num_elems * 4 * m_Nf)
+{
+  for (auto& v : m_Ja) v.resize(num_elems * m_Np);
+  for (auto& v : m_normal) v.resize(num_elems * 4 * m_Nf);
+
+  std::vector<T> xr(m_Np), xs(m_Np), yr(m_Np), ys(m_Np);
+  for (std::size_t e = 0; e < num_elems; ++e)
+  {
+    std::size_t e0 = e * m_Np;
+    elem.derivative_r(x + e0, xr.begin());
+    elem.derivative_s(x + e0, xs.begin());
+    elem.derivative_r(y + e0, yr.begin());
+    elem.derivative_s(y + e0, ys.begin());
+
+    for (std::size_t n = 0; n < m_Np; ++n)
+    {
+      m_J[e0 + n] = xr[n] * ys[n] - xs[n] * yr[n];
+      assert(m_J[e0 + n] > 0);
+      m_Ja[0][e0 + n] = ys[n];
+      m_Ja[1][e0 + n] = - xs[n];
+      m_Ja[2][e0 + n] = - yr[n];
+      m_Ja[3][e0 + n] = xr[n];
+    }
+
+    // faces 0 and 1 are normal to J a^1 and faces 2 and 3 to J a^2
+    for (int f = 0; f < 4; ++f)
+    {
+      int i = f / 2;
+      T sign = f % 2 == 0 ? - const_val<T, 1> : const_val<T, 1>;
+      const auto& nodes = elem.face_nodes(f);
+      for (std::size_t a = 0; a < m_Nf; ++a)
+      {
+        std::size_t n = e0 + nodes[a], fa = (e * 4 + f) * m_Nf + a;
+        T v0 = m_Ja[2 * i][n], v1 = m_Ja[2 * i + 1][n];
+        T s = std::sqrt(v0 * v0 + v1 * v1);
+        m_scaling[fa] = s;
+        m_normal[0][fa] = sign * v0 / s;
+        m_normal[1][fa] = sign * v1 / s;
+      }
+    }
+  }
+}
+
+// Metric terms of curvilinear hexahedra, i.e., of the polynomial mappings given by the
+// physical coordinates of the nodes of a reference_hexahedron, stored as those of
+// quadrilateral_metrics. The contravariant vectors are computed in the conservative curl
+// form of the paper "Metric Identities and the Discontinuous Spectral Element Method on
+// Curvilinear Meshes" by D.A. Kopriva, 2006, i.e., for (n, m, l) cyclic,
+//
+//   (J a^1)_n = (X_l (X_m)_s)_t - (X_l (X_m)_t)_s
+//   (J a^2)_n = (X_l (X_m)_t)_r - (X_l (X_m)_r)_t
+//   (J a^3)_n = (X_l (X_m)_r)_s - (X_l (X_m)_s)_r
+//
+// with the products interpolated at the nodes, so that the discrete metric identities
+// sum_i D_i (J a^i)_n = 0 hold to round-off and the free-stream is preserved.
+template<typename T>
+class hexahedron_metrics
+{
+public:
+  // x, y, and z are the coordinates of the nodes of num_elems elements, element after element
+  template<typename ConstItr>
+  hexahedron_metrics(const reference_hexahedron<T>& elem, std::size_t num_elems, ConstItr x, ConstItr y, ConstItr z);
+
+  std::size_t num_elements() const { return m_num_elems; }
+
+  std::size_t num_nodes() const { return m_Np; }
+
+  std::size_t num_face_nodes() const { return m_Nf; }
+
+  T J(std::size_t e, std::size_t n) const { return m_J[e * m_Np + n]; }
+
+  // component k of the contravariant vector J a^i
+  T Ja(int i, int k, std::size_t e, std::size_t n) const { return m_Ja[3 * i + k][e * m_Np + n]; }
+
+  // component k of the outward unit normal and the scaling at node a of face f
+  T normal(int k, std::size_t e, int f, std::size_t a) const { return m_normal[k][(e * 6 + f) * m_Nf + a]; }
+
+  T scaling(std::size_t e, int f, std::size_t a) const { return m_scaling[(e * 6 + f) * m_Nf + a]; }
+
+  // contiguous arrays of all elements
+  const T* J_data() const { return m_J.data(); }
+
+  const T* Ja_data(int i, int k) const { return m_Ja[3 * i + k].data(); }
+
+  const T* normal_data(int k) const { return m_normal[k].data(); }
+
+  const T* scaling_data() const { return m_scaling.data(); }
+
+private:
+  std::size_t                   m_num_elems;
+  std::size_t                   m_Np;
+  std::size_t                   m_Nf;
+  std::vector<T>                m_J;
+  std::array<std::vector<T>, 9> m_Ja;
+  std::array<std::vector<T>, 3> m_normal;
+  std::vector<T>                m_scaling;
+};
+
+template<typename T> template<typename ConstItr>
+hexahedron_metrics<T>::hexahedron_metrics(const reference_hexahedron<T>& elem, std::size_t num_elems,
+                                          ConstItr x, ConstItr y, ConstItr z)
+  : m_num_elems(num_elems), m_Np(elem.num_nodes()), m_Nf(elem.num_face_nodes()),
+    m_J(num_elems * m_Np), m_scaling(num_elems * 6 * m_Nf)
+{
+  for (auto& v : m_Ja) v.resize(num_elems * m_Np);
+  for (auto& v : m_normal) v.resize(num_elems * 6 * m_Nf);
+
+  // X[m] and dX[m][d], the derivative of X[m] along the axis d
+  std::array<std::vector<T>, 3> X;
+  std::array<std::array<std::vector<T>, 3>, 3> dX;
+  std::vector<T> w(m_Np), dw(m_Np);
+  for (int m = 0; m < 3; ++m)
+  {
+    X[m].resize(m_Np);
+    for (int d = 0; d < 3; ++d) dX[m][d].resize(m_Np);
+  }
+
+  auto derivative = [&elem](int d, const std::vector<T>& in, std::vector<T>& out)
+  {
+    if (d == 0) elem.derivative_r(in.cbegin(), out.begin());
+    else if (d == 1) elem.derivative_s(in.cbegin(), out.begin());
+    else elem.derivative_t(in.cbegin(), out.begin());
+  };
+
+  for (std::size_t e = 0; e < num_elems; ++e)
+  {
+    std::size_t e0 = e * m_Np;
+    for (std::size_t n = 0; n < m_Np; ++n)
+    {
+      X[0][n] = *(x + (e0 + n));
+      X[1][n] = *(y + (e0 + n));
+      X[2][n] = *(z + (e0 + n));
+    }
+    for (int m = 0; m < 3; ++m)
+      for (int d = 0; d < 3; ++d) derivative(d, X[m], dX[m][d]);
+
+    // J = x_r . (x_s x x_t)
+    for (std::size_t n = 0; n < m_Np; ++n)
+    {
+      m_J[e0 + n] = dX[0][0][n] * (dX[1][1][n] * dX[2][2][n] - dX[2][1][n] * dX[1][2][n]) -
+                    dX[1][0][n] * (dX[0][1][n] * dX[2][2][n] - dX[2][1][n] * dX[0][2][n]) +
+                    dX[2][0][n] * (dX[0][1][n] * dX[1][2][n] - dX[1][1][n] * dX[0][2][n]);
+      assert(m_J[e0 + n] > 0);
+    }
+
+    // (J a^i)_n = (X_l (X_m)_{i+1})_{i+2} - (X_l (X_m)_{i+2})_{i+1}, i.e., the
+    // formulas above with the axes (i, i + 1, i + 2) cyclic as well
+    for (int i = 0; i < 3; ++i)
+    {
+      int d1 = (i + 1) % 3, d2 = (i + 2) % 3;
+      for (int c = 0; c < 3; ++c)
+      {
+        int m = (c + 1) % 3, l = (c + 2) % 3;
+        T* Ja = m_Ja[3 * i + c].data() + e0;
+
+        for (std::size_t n = 0; n < m_Np; ++n) w[n] = X[l][n] * dX[m][d1][n];
+        derivative(d2, w, dw);
+        for (std::size_t n = 0; n < m_Np; ++n) Ja[n] = dw[n];
+
+        for (std::size_t n = 0; n < m_Np; ++n) w[n] = X[l][n] * dX[m][d2][n];
+        derivative(d1, w, dw);
+        for (std::size_t n = 0; n < m_Np; ++n) Ja[n] -= dw[n];
+      }
+    }
+
+    // faces 2i and 2i + 1 are normal to J a^i
+    for (int f = 0; f < 6; ++f)
+    {
+      int i = f / 2;
+      T sign = f % 2 == 0 ? - const_val<T, 1> : const_val<T, 1>;
+      const auto& nodes = elem.face_nodes(f);
+      for (std::size_t a = 0; a < m_Nf; ++a)
+      {
+        std::size_t n = e0 + nodes[a], fa = (e * 6 + f) * m_Nf + a;
+        T v0 = m_Ja[3 * i][n], v1 = m_Ja[3 * i + 1][n], v2 = m_Ja[3 * i + 2][n];
+        T s = std::sqrt(v0 * v0 + v1 * v1 + v2 * v2);
+        m_scaling[fa] = s;
+        m_normal[0][fa] = sign * v0 / s;
+        m_normal[1][fa] = sign * v1 / s;
+        m_normal[2][fa] = sign * v2 / s;
+      }
+    }
+  }
+}
+
+// physical coordinates of the nodes of the reference hexahedron in the cells of an
+// unstructured_hex_mesh (or any mesh of the same interface) by the trilinear mapping of
+// the cell, followed by the transformation g(x, y, z) -> {x', y', z'} which curves the
+// elements, e.g., to fit a curved wall; g of identity gives straight-sided elements
+template<typename T, typename MESH, typename Transform>
+void hexahedron_nodes(const reference_hexahedron<T>& elem, const MESH& mesh, Transform g,
+                      std::vector<T>& x, std::vector<T>& y, std::vector<T>& z)
+{
+  std::size_t Np = elem.num_nodes();
+  x.resize(mesh.num_cells() * Np);
+  y.resize(mesh.num_cells() * Np);
+  z.resize(mesh.num_cells() * Np);
+  for (std::size_t c = 0; c < mesh.num_cells(); ++c)
+    for (std::size_t n = 0; n < Np; ++n)
+    {
+      T r = elem.node_position_r(n), s = elem.node_position_s(n), t = elem.node_position_t(n);
+      std::array<T, 3> p = {0, 0, 0};
+      for (int k = 0; k < 8; ++k)
+      {
+        // the corner (a, b, c) of the vertex a + 2 * b + 4 * c
+        T phi = (k % 2 ? const_val<T, 1> + r : const_val<T, 1> - r) *
+                (k / 2 % 2 ? const_val<T, 1> + s : const_val<T, 1> - s) *
+                (k / 4 ? const_val<T, 1> + t : const_val<T, 1> - t) / const_val<T, 8>;
+        auto v = mesh.get_vertex(mesh.cell_vertex(c, k));
+        for (int d = 0; d < 3; ++d) p[d] += phi * v[d];
+      }
+      std::array<T, 3> q = g(p[0], p[1], p[2]);
+      x[c * Np + n] = q[0];
+      y[c * Np + n] = q[1];
+      z[c * Np + n] = q[2];
+    }
+}
+
+}
+
+#endif
@@ -0,0 +1,60 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#ifndef DEFAULT_INIT_ALLOCATOR_H
+#define DEFAULT_INIT_ALLOCATOR_H
+
+#include <memory>
+#include <new>
+#include <utility>
+#include <type_traits>
+
+namespace rdg {
+
+// Allocator adaptor that default-initializes the elements constructed without arguments,
+// e.g., by std::vector<double, default_init_allocator<double>> v(n), i.e., leaves them
+// uninitialized instead of writing zeros. So the pages of a large vector are not touched
+// by the allocating thread, and the operating system places each page on the NUMA node
+// of the thread that writes it first, e.g., by the first_touch() of the operator with the
+// partition of its element loop.
+template<typename T, typename A = std::allocator<T>>
+class default_init_allocator : public A
+{
+  using traits = std::allocator_traits<A>;
+
+public:
+  template<typename U>
+  struct rebind
+  { using other = default_init_allocator<U, typename traits::template rebind_alloc<U>>; };
+
+  using A::A;
+
+  template<typename U>
+  void construct(U* ptr) noexcept(std::is_nothrow_default_constructible_v<U>)
+  { ::new(static_cast<void*>(ptr)) U; }
+
+  template<typename U, typename... Args>
+  void construct(U* ptr, Args&&... args)
+  { traits::construct(static_cast<A&>(*this), ptr, std::forward<Args>(args)...); }
+};
+
+}
+
+#endif
@@ -22,6 +22,7 @@
 #define DENSE_MATRIX_H
 
 #include <memory>
+#include <iterator>
 #include <cstddef>
 #include <type_traits>
 #include <initializer_list>
@@ -211,12 +212,174 @@ private:
   allocatorage m_allocatorage;
 };
 
+template<typename T, bool CM = false, typename Alloc = std::allocator<T>>
+class dense_matrix;
+
+// Non-owning view of a dense matrix stored in an existing buffer. The element (i, j)
+// is located at data + offset + i * stride + j for row major (CM = false) storage, or
+// at data + offset + j * stride + i for column major (CM = true) storage. The stride
+// can be larger than the number of columns (rows) so that a view can refer to a
+// sub-block of a larger matrix, or to a slice of a solution array, without copying.
+//
+// A view of const T is read only; const_dense_matrix_view is provided for convenience.
+// Views are cheap to copy and never allocate, except transpose() which, like the one
+// of dense_matrix, returns an owning matrix. Use transposed_view() for zero-copy.
+template<typename T, bool CM = false>
+class dense_matrix_view
+{
+public:
+  using value_type      = std::remove_const_t<T>;
+  using pointer         = T*;
+  using reference       = T&;
+  using const_reference = const value_type&;
+  using size_type       = std::size_t;
+
+public:
+  dense_matrix_view() noexcept : m_start(), m_size_row(), m_size_col(), m_stride() {}
+
+  // view of the packed (stride = size_col for row major, size_row for column major) matrix at data
+  dense_matrix_view(pointer data, size_type size_row, size_type size_col) noexcept
+  : m_start(data), m_size_row(size_row), m_size_col(size_col), m_stride(CM ? size_row : size_col) {}
+
+  dense_matrix_view(pointer data, size_type offset, size_type size_row, size_type size_col, size_type stride) noexcept
+  : m_start(data + offset), m_size_row(size_row), m_size_col(size_col), m_stride(stride)
+  { assert(CM ? stride >= size_row : stride >= size_col); }
+
+  // conversion from a mutable view to a read only view
+  template<typename U, typename = std::enable_if_t<std::is_same_v<const U, T> && !std::is_same_v<U, T>>>
+  dense_matrix_view(const dense_matrix_view<U, CM>& other) noexcept
+  : m_start(other.data()), m_size_row(other.size_row()), m_size_col(other.size_col()), m_stride(other.stride()) {}
+
+  pointer data() const noexcept { return m_start; }
+
+  size_type size_row() const noexcept { return m_size_row; }
+
+  size_type size_col() const noexcept { return m_size_col; }
+
+  size_type stride() const noexcept { return m_stride; }
+
+  reference operator()(size_type i, size_type j) const
+  {
+    assert(i < m_size_row && j < m_size_col);
+    if constexpr(CM) return *(m_start + j * m_stride + i);
+    else return *(m_start + i * m_stride + j);
+  }
+
+  // view of the sub-block of size_row x size_col starting at (i, j)
+  dense_matrix_view submatrix(size_type i, size_type j, size_type size_row, size_type size_col) const
+  {
+    assert(i + size_row <= m_size_row && j + size_col <= m_size_col);
+    if constexpr(CM) return dense_matrix_view(m_start, j * m_stride + i, size_row, size_col, m_stride);
+    else return dense_matrix_view(m_start, i * m_stride + j, size_row, size_col, m_stride);
+  }
+
+  // the same memory seen as the transpose, i.e., with the storage order flipped
+  dense_matrix_view<T, !CM> transposed_view() const noexcept
+  { return dense_matrix_view<T, !CM>(m_start, 0, m_size_col, m_size_row, m_stride); }
+
+  dense_matrix<value_type, CM> transpose() const;
+
+  template<typename InputItr, typename InOutItr>
+  void gemv(value_type alpha, InputItr in_first, value_type beta, InOutItr inout_first) const;
+
+private:
+  pointer   m_start;
+  size_type m_size_row;
+  size_type m_size_col;
+  size_type m_stride;
+};
+
+template<typename T, bool CM = false>
+using const_dense_matrix_view = dense_matrix_view<const T, CM>;
+
+// y = alpha * A * x + beta * y
+//
+// NOTE: x and y may be iterators of variables (e.g., boost::tuple) as long as the
+// NOTE: operators of scalar * variable and variable + variable are defined
+template<typename T, bool CM> template<typename InputItr, typename InOutItr>
+void dense_matrix_view<T, CM>::gemv(value_type alpha, InputItr in_first, value_type beta, InOutItr inout_first) const
+{
+  if constexpr(CM)
+  {
+    for (size_type i = 0; i < m_size_row; ++i)
+    {
+      auto y = beta * (*inout_first);
+      InputItr x = in_first;
+      for (pointer q = m_start + i; q < m_start + i + m_size_col * m_stride; ++x, q += m_stride)
+        y += alpha * (*q) * (*x);
+      *inout_first++ = y;
+    }
+  }
+  else
+  {
+    for (pointer p = m_start; p < m_start + m_size_row * m_stride; p += m_stride)
+    {
+      auto y = beta * (*inout_first);
+      InputItr x = in_first;
+      for (pointer q = p; q < p + m_size_col; ++x, ++q)
+        y += alpha * (*q) * (*x);
+      *inout_first++ = y;
+    }
+  }
+}
+
+// C = alpha * A * B + beta * C, where the three matrices may have any storage orders;
+// C must not overlap with A or B. When beta is zero, C is not read (so it may hold
+// uninitialized values).
+template<typename TA, bool CMA, typename TB, bool CMB, typename TC, bool CMC>
+void gemm(TC alpha, const dense_matrix_view<TA, CMA>& A, const dense_matrix_view<TB, CMB>& B,
+          TC beta, const dense_matrix_view<TC, CMC>& C)
+{
+  using size_type = std::size_t;
+
+  assert(A.size_col() == B.size_row());
+  assert(A.size_row() == C.size_row() && B.size_col() == C.size_col());
+
+  for (size_type j = 0; j < C.size_col(); ++j)
+    for (size_type i = 0; i < C.size_row(); ++i)
+      C(i, j) = beta == const_val<TC, 0> ? const_val<TC, 0> : beta * C(i, j);
+
+  // the innermost loop runs along the contiguous direction of C
+  if constexpr(CMC)
+  {
+    for (size_type j = 0; j < C.size_col(); ++j)
+      for (size_type k = 0; k < A.size_col(); ++k)
+      {
+        TC b = alpha * B(k, j);
+        for (size_type i = 0; i < C.size_row(); ++i)
+          C(i, j) += A(i, k) * b;
+      }
+  }
+  else
+  {
+    for (size_type i = 0; i < C.size_row(); ++i)
+      for (size_type k = 0; k < A.size_col(); ++k)
+      {
+        TC a = alpha * A(i, k);
+        for (size_type j = 0; j < C.size_col(); ++j)
+          C(i, j) += a * B(k, j);
+      }
+  }
+}
+
+// view of the nodal values of num_elems consecutive elements, n nodes each, in a per-component
+// (SoA) solution array such as the std::vector's used by the examples, as an n x num_elems column
+// major matrix; e.g., gemm(1, D, make_elements_view(u, 0, K, n), 0, make_elements_view(du, 0, K, n))
+// differentiates K elements at once, in place of the solution data
+template<typename Container>
+auto make_elements_view(Container& c, std::size_t first_elem, std::size_t num_elems, std::size_t n)
+{
+  using T = std::remove_pointer_t<decltype(std::data(c))>;
+  assert((first_elem + num_elems) * n <= std::size(c));
+  return dense_matrix_view<T, true>(std::data(c), first_elem * n, n, num_elems, n);
+}
+
 // T: the number type; CM: column major storage when true, otherwise row major.
 //
 // Note that the resize() function will always result in memory re-allocation
 // if the new size is different from the current size, due to the n_storage
 // memory management used.
-template<typename T, bool CM = false, typename Alloc = std::allocator<T>>
+template<typename T, bool CM, typename Alloc>
 class dense_matrix : private n_storage<T, Alloc>
 {
 public:
@@ -364,6 +527,11 @@ public:
     else return *(Base::start() + i * m_stride + j);
   }
 
+  // non-owning views of the whole matrix
+  dense_matrix_view<T, CM> view() { return dense_matrix_view<T, CM>(data(), size_row(), size_col()); }
+
+  const_dense_matrix_view<T, CM> view() const { return const_dense_matrix_view<T, CM>(data(), size_row(), size_col()); }
+
   dense_matrix transpose() const;
   
   dense_matrix inverse() const;
@@ -391,23 +559,7 @@ public:
     assert(m1.size_col() == m2.size_row());
 
     dense_matrix prod(m1.size_row(), m2.size_col());
-    pointer d = prod.start();
-
-    if constexpr(CM)
-    {
-      dense_matrix tmp = m1.transpose();
-      for (const_pointer p = tmp.start(); p < tmp.start() + tmp.size(); p += tmp.m_stride)
-        for (const_pointer q = m2.start(); q < m2.start() + m2.size(); q += m2.m_stride)
-          *d++ = std::inner_product(p, p + tmp.m_stride, q, value_type());
-    }
-    else
-    {
-      dense_matrix tmp = m2.transpose();
-      for (const_pointer p = m1.start(); p < m1.start() + m1.size(); p += m1.m_stride)
-        for (const_pointer q = tmp.start(); q < tmp.start() + tmp.size(); q += tmp.m_stride)
-          *d++ = std::inner_product(p, p + m1.m_stride, q, value_type());
-    }
-
+    gemm(const_val<value_type, 1>, m1.view(), m2.view(), const_val<value_type, 0>, prod.view());
     return prod;
   }
 
@@ -460,30 +612,7 @@ private:
 
 template<typename T, bool CM, typename Alloc> template<typename InputItr, typename InOutItr>
 void dense_matrix<T, CM, Alloc>::gemv(value_type alpha, InputItr in_first, value_type beta, InOutItr inout_first) const
-{
-  if constexpr(CM)
-  {
-    for (const_pointer p = Base::start(); p < Base::start() + m_stride; ++p)  
-    {
-      auto y = beta * (*inout_first);
-      InputItr x = in_first; 
-      for (const_pointer q = p; q < Base::start() + Base::size(); ++x, q += m_stride)
-        y += alpha * (*q) * (*x);
-      *inout_first++ = y;
-    }
-  }
-  else
-  {
-    for (const_pointer p = Base::start(); p < Base::start() + Base::size(); p += m_stride)  
-    {
-      auto y = beta * (*inout_first);
-      InputItr x = in_first; 
-      for (const_pointer q = p; q < p + m_stride; ++x, ++q)
-        y += alpha * (*q) * (*x);
-      *inout_first++ = y;
-    }
-  }
-}
+{ view().gemv(alpha, in_first, beta, inout_first); }
 
 template<typename T, bool CM, typename Alloc>
 dense_matrix<T, CM, Alloc> dense_matrix<T, CM, Alloc>::transpose() const
@@ -496,6 +625,16 @@ dense_matrix<T, CM, Alloc> dense_matrix<T, CM, Alloc>::transpose() const
   return trans;
 }
 
+template<typename T, bool CM>
+dense_matrix<typename dense_matrix_view<T, CM>::value_type, CM> dense_matrix_view<T, CM>::transpose() const
+{
+  dense_matrix<value_type, CM> trans(m_size_col, m_size_row);
+  for (size_type i = 0; i < m_size_row; ++i)
+    for (size_type j = 0; j < m_size_col; ++j)
+      trans(j, i) = this->operator()(i, j);
+  return trans;
+}
+
 // the Gauss-Jordan method
 template<typename T, bool CM, typename Alloc>
 dense_matrix<T, CM, Alloc> dense_matrix<T, CM, Alloc>::inverse() const
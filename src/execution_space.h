@@ -0,0 +1,233 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#ifndef EXECUTION_SPACE_H
+#define EXECUTION_SPACE_H
+
+#include <cstddef>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <mutex>
+
+#include "work_stealing_scheduler.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace rdg {
+
+// Execution spaces run the loops of the kernels, so that one kernel source, written on
+// the parallel_for, parallel_reduce and team_for below, runs serially, on a pool of
+// threads, or on OpenMP. A space provides
+//
+//   unsigned concurrency() const;
+//   void run(std::size_t n, Cost cost, F&& f) const;        // f(begin, end) on ranges of [0, n)
+//   void run_static(std::size_t n, Cost cost, F&& f) const; // the same ranges on the same threads
+//
+// where the ranges are of about the grain cost of the space given the cost hints cost(i),
+// and run_static() runs them on the threads they are dealt to in run(), e.g., to first
+// touch the buffers the loop works on.
+
+// runs the loops in the calling thread, as one range
+class serial_space
+{
+public:
+  unsigned concurrency() const { return 1; }
+
+  template<typename Cost, typename F>
+  void run(std::size_t n, Cost, F&& f) const { if (n > 0) f(std::size_t(0), n); }
+
+  template<typename Cost, typename F>
+  void run_static(std::size_t n, Cost cost, F&& f) const { run(n, cost, f); }
+};
+
+// runs the loops on a work_stealing_scheduler, or serially if there is none
+class thread_pool_space
+{
+public:
+  explicit thread_pool_space(work_stealing_scheduler* scheduler = nullptr, double grain_cost = 2048.)
+    : m_scheduler(scheduler), m_grain_cost(grain_cost) {}
+
+  unsigned concurrency() const { return m_scheduler ? m_scheduler->num_threads() : 1; }
+
+  template<typename Cost, typename F>
+  void run(std::size_t n, Cost cost, F&& f) const
+  {
+    if (m_scheduler) m_scheduler->parallel_for(n, cost, m_grain_cost, f);
+    else if (n > 0) f(std::size_t(0), n);
+  }
+
+  template<typename Cost, typename F>
+  void run_static(std::size_t n, Cost cost, F&& f) const
+  {
+    if (m_scheduler) m_scheduler->parallel_for_static(n, cost, m_grain_cost, f);
+    else if (n > 0) f(std::size_t(0), n);
+  }
+
+private:
+  work_stealing_scheduler* m_scheduler;
+  double                   m_grain_cost;
+};
+
+#ifdef _OPENMP
+// runs the loops in OpenMP parallel regions: the ranges are dealt to the threads in
+// contiguous blocks of about equal costs, as by the work_stealing_scheduler, and each
+// thread runs its block, i.e., the loops are static and run_static() is run()
+class openmp_space
+{
+public:
+  explicit openmp_space(double grain_cost = 2048.) : m_grain_cost(grain_cost) {}
+
+  unsigned concurrency() const { return static_cast<unsigned>(omp_get_max_threads()); }
+
+  template<typename Cost, typename F>
+  void run(std::size_t n, Cost cost, F&& f) const;
+
+  template<typename Cost, typename F>
+  void run_static(std::size_t n, Cost cost, F&& f) const { run(n, cost, f); }
+
+private:
+  double m_grain_cost;
+};
+
+template<typename Cost, typename F>
+void openmp_space::run(std::size_t n, Cost cost, F&& f) const
+{
+  if (n == 0) return;
+  if (omp_get_max_threads() == 1 || omp_in_parallel())
+  {
+    f(std::size_t(0), n);
+    return;
+  }
+
+  // the ranges and their prefix costs
+  std::vector<std::pair<std::size_t, std::size_t>> ranges;
+  std::vector<double> prefix(1, 0.);
+  double sum = 0.;
+  for (std::size_t i = 0, begin = 0; i < n; ++i)
+  {
+    sum += cost(i);
+    if (sum - prefix.back() >= m_grain_cost || i + 1 == n)
+    {
+      ranges.emplace_back(begin, i + 1);
+      prefix.push_back(sum);
+      begin = i + 1;
+    }
+  }
+
+  #pragma omp parallel
+  {
+    const std::size_t me = omp_get_thread_num(), nt = omp_get_num_threads();
+    for (std::size_t k = 0, id = 0; k < ranges.size(); ++k)
+    {
+      while (id + 1 < nt && prefix[k] >= sum * (id + 1) / nt) ++id;
+      if (id == me) f(ranges[k].first, ranges[k].second);
+      else if (id > me) break;
+    }
+  }
+}
+#endif
+
+namespace detail {
+
+inline double unit_cost(std::size_t) { return 1.; }
+
+}
+
+// f(i) for i in [0, n)
+template<typename Space, typename F>
+void parallel_for(const Space& space, std::size_t n, F&& f)
+{
+  space.run(n, detail::unit_cost, [&f](std::size_t begin, std::size_t end)
+  { for (std::size_t i = begin; i < end; ++i) f(i); });
+}
+
+// f(begin, end) on the ranges of [0, n) given the cost hints cost(i)
+template<typename Space, typename Cost, typename F>
+void parallel_for(const Space& space, std::size_t n, Cost cost, F&& f)
+{ space.run(n, cost, f); }
+
+// f(begin, end) on the same ranges and threads as parallel_for(space, n, cost, f)
+template<typename Space, typename Cost, typename F>
+void parallel_for_static(const Space& space, std::size_t n, Cost cost, F&& f)
+{ space.run_static(n, cost, f); }
+
+// the reduction by join of f(i, partial) for i in [0, n): every range accumulates its own
+// partial from init, which must be the identity of join, and the partials are joined in
+// the order of the ranges, so the result does not depend on the threads that ran them
+template<typename Space, typename R, typename F, typename Join>
+R parallel_reduce(const Space& space, std::size_t n, R init, F&& f, Join join)
+{
+  std::mutex mutex;
+  std::vector<std::pair<std::size_t, R>> partials;
+  space.run(n, detail::unit_cost, [&](std::size_t begin, std::size_t end)
+  {
+    R partial = init;
+    for (std::size_t i = begin; i < end; ++i) f(i, partial);
+    std::lock_guard<std::mutex> lock(mutex);
+    partials.emplace_back(begin, partial);
+  });
+
+  std::sort(partials.begin(), partials.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+  R result = init;
+  for (const auto& p : partials) result = join(result, p.second);
+  return result;
+}
+
+// a team of a team_for loop, which works on a league of consecutive elements; the teams
+// are single threads here, so the loops over the nodes of the elements are vectorized
+// rather than split among threads
+class team_member
+{
+public:
+  team_member(std::size_t begin, std::size_t end) : m_begin(begin), m_end(end) {}
+
+  // the elements of the league
+  std::size_t league_begin() const { return m_begin; }
+  std::size_t league_end() const { return m_end; }
+
+  // g(j) for j in [0, m), e.g., the nodes of an element
+  template<typename G>
+  void vector_for(std::size_t m, G&& g) const
+  {
+#ifdef _OPENMP
+    #pragma omp simd
+#endif
+    for (std::size_t j = 0; j < m; ++j) g(j);
+  }
+
+private:
+  std::size_t m_begin;
+  std::size_t m_end;
+};
+
+// f(team) on the leagues of the elements [0, n) given their cost hints cost(i)
+template<typename Space, typename Cost, typename F>
+void team_for(const Space& space, std::size_t n, Cost cost, F&& f)
+{
+  space.run(n, cost, [&f](std::size_t begin, std::size_t end)
+  { f(team_member(begin, end)); });
+}
+
+}
+
+#endif
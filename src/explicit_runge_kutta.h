@@ -25,47 +25,98 @@
 #include <cstddef>
 
 #include "const_val.h"
+#include "execution_space.h"
 
 namespace rdg {
 
 // axpy
+//
+// The memory-bound loops of the updates run in static ranges of equal numbers of entries,
+// not stolen between the threads, so each entry is streamed by the same thread every time.
 
 // NOTE: De-referencing boost::zip_iterator does not directly give boost::tuple;
 // NOTE: instead, it gives a boost internal representation. So we need to explicitly
 // NOTE: convert to the specific variable_type/boost::tuple, for which we have
 // NOTE: operators like +, -, *, /, +=, *=, ..., etc., overloaded (in variable.h).
-template <typename T, typename Itr, typename VART = typename Itr::value_type>
-void axpy_n(T a, Itr x_cbegin, std::size_t x_size, Itr y_cbegin, Itr out_begin)
+template <typename Space, typename T, typename Itr, typename VART = typename Itr::value_type>
+void axpy_n(const Space& space, T a, Itr x_cbegin, std::size_t x_size, Itr y_cbegin, Itr out_begin)
 {
   assert(x_cbegin != y_cbegin);
   assert(out_begin != x_cbegin && out_begin != y_cbegin);
 
-  for (std::size_t i = 0; i < x_size; ++i) *out_begin++ = a * VART(*x_cbegin++) + VART(*y_cbegin++);
+  parallel_for_static(space, x_size, detail::unit_cost, [&](std::size_t begin, std::size_t end)
+  {
+    for (std::size_t i = begin; i < end; ++i)
+      *(out_begin + i) = a * VART(*(x_cbegin + i)) + VART(*(y_cbegin + i));
+  });
+}
+
+template <typename T, typename Itr, typename VART = typename Itr::value_type>
+void axpy_n(T a, Itr x_cbegin, std::size_t x_size, Itr y_cbegin, Itr out_begin)
+{ axpy_n<serial_space, T, Itr, VART>(serial_space(), a, x_cbegin, x_size, y_cbegin, out_begin); }
+
+// sets [out_begin, out_begin + size) to the value in the same ranges on the same threads
+// as axpy_n, so that the pages of the work space of the Runge-Kutta schemes allocated by
+// rdg::default_init_allocator are first touched by the threads that stream them
+template <typename Space, typename Itr, typename V>
+void first_touch_n(const Space& space, Itr out_begin, std::size_t size, const V& value)
+{
+  parallel_for_static(space, size, detail::unit_cost, [&](std::size_t begin, std::size_t end)
+  { for (std::size_t i = begin; i < end; ++i) *(out_begin + i) = value; });
 }
 
+// no-op stage filter of the Runge-Kutta schemes
+struct no_stage_filter
+{
+  template<typename Itr>
+  void operator()(Itr, std::size_t) const {}
+};
+
 // fourth-order explicit Runge-Kutta scheme
-template <typename Itr, typename T, typename DiscreteOp>
-void rk4(Itr inout, std::size_t size, T t, T dt, const DiscreteOp& op, Itr wk0, Itr wk1, Itr wk2, Itr wk3, Itr wk4)
+//
+// The stage filter, e.g., a spectral_filter (see modal_basis.h) wrapped as
+// filter(itr, size), is applied in place to every intermediate stage solution
+// before the discrete operator is evaluated on it and to the final solution.
+//
+// The updates of the stages run on the execution space (see execution_space.h), which
+// is usually the one the discrete operator runs its loops on.
+template <typename Space, typename Itr, typename T, typename DiscreteOp, typename StageFilter>
+void rk4(const Space& space, Itr inout, std::size_t size, T t, T dt, const DiscreteOp& op, const StageFilter& filter,
+         Itr wk0, Itr wk1, Itr wk2, Itr wk3, Itr wk4)
 {
+  using V = typename DiscreteOp::variable_type;
   T half = const_val<T, 1> / const_val<T, 2>;
 
   op(inout, size, t, wk1);
 
-  axpy_n<T, Itr, typename DiscreteOp::variable_type>(half * dt, wk1, size, inout, wk0);
+  axpy_n<Space, T, Itr, V>(space, half * dt, wk1, size, inout, wk0);
+  filter(wk0, size);
   op(wk0, size, t + half * dt, wk2);
 
-  axpy_n<T, Itr, typename DiscreteOp::variable_type>(half * dt, wk2, size, inout, wk0);
+  axpy_n<Space, T, Itr, V>(space, half * dt, wk2, size, inout, wk0);
+  filter(wk0, size);
   op(wk0, size, t + half * dt, wk3);
 
-  axpy_n<T, Itr, typename DiscreteOp::variable_type>(dt, wk3, size, inout, wk0);
+  axpy_n<Space, T, Itr, V>(space, dt, wk3, size, inout, wk0);
+  filter(wk0, size);
   op(wk0, size, t + dt, wk4);
 
-  axpy_n<T, Itr, typename DiscreteOp::variable_type>(const_val<T, 2>, wk2, size, wk1, wk0);
-  axpy_n<T, Itr, typename DiscreteOp::variable_type>(const_val<T, 2>, wk3, size, wk4, wk1);
-  axpy_n<T, Itr, typename DiscreteOp::variable_type>(dt / const_val<T, 6>, wk0, size, inout, wk2);
-  axpy_n<T, Itr, typename DiscreteOp::variable_type>(dt / const_val<T, 6>, wk1, size, wk2, inout);
+  axpy_n<Space, T, Itr, V>(space, const_val<T, 2>, wk2, size, wk1, wk0);
+  axpy_n<Space, T, Itr, V>(space, const_val<T, 2>, wk3, size, wk4, wk1);
+  axpy_n<Space, T, Itr, V>(space, dt / const_val<T, 6>, wk0, size, inout, wk2);
+  axpy_n<Space, T, Itr, V>(space, dt / const_val<T, 6>, wk1, size, wk2, inout);
+  filter(inout, size);
 }
 
+template <typename Itr, typename T, typename DiscreteOp, typename StageFilter>
+void rk4(Itr inout, std::size_t size, T t, T dt, const DiscreteOp& op, const StageFilter& filter,
+         Itr wk0, Itr wk1, Itr wk2, Itr wk3, Itr wk4)
+{ rk4(serial_space(), inout, size, t, dt, op, filter, wk0, wk1, wk2, wk3, wk4); }
+
+template <typename Itr, typename T, typename DiscreteOp>
+void rk4(Itr inout, std::size_t size, T t, T dt, const DiscreteOp& op, Itr wk0, Itr wk1, Itr wk2, Itr wk3, Itr wk4)
+{ rk4(serial_space(), inout, size, t, dt, op, no_stage_filter(), wk0, wk1, wk2, wk3, wk4); }
+
 }
 
 #endif
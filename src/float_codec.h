@@ -0,0 +1,364 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#ifndef FLOAT_CODEC_H
+#define FLOAT_CODEC_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include <type_traits>
+#include <stdexcept>
+#include <atomic>
+
+#include "execution_space.h"
+
+namespace rdg {
+
+// Compression of arrays of floating-point values, e.g., the solution at the nodes for
+// checkpoints and snapshots. The nodes of an element are consecutive and the solution is
+// smooth within the elements, so each value is predicted from the previous nodes, either
+// as the previous value or by the linear extrapolation of the previous two, whichever is
+// closer, and only the bytes of the residual below its leading zero bytes are stored
+// (see M. Burtscher and P. Ratanaworabhan, FPC, IEEE Trans. Comput. 58, 2009):
+//
+// lossless - the residual is the XOR of the bits of the value and of its prediction, so
+//            the values come back bit for bit, NaNs and infinities included;
+// lossy    - the values are quantized to multiples of 2 * error_bound, and the residual
+//            is the difference of the quantized value and of its prediction, so every
+//            value comes back within error_bound; the values that cannot be, e.g., NaNs,
+//            are stored as they are.
+//
+// Every value has a 4-bit header, the predictor and the number of the bytes stored, and
+// the values are cut into blocks that are compressed independently, in parallel on the
+// execution space. A stream is
+//
+//   header       float_codec_header, 32 bytes
+//   block ends   uint64 end of each block, in bytes from the start of the blocks
+//   blocks       the headers of the values of a block, two per byte, then their bytes
+struct float_codec_options
+{
+  bool        lossy = false;
+  double      error_bound = 0.;      // of the lossy mode, absolute
+  std::size_t block_size = 1 << 16;  // number of values of a block
+};
+
+struct float_codec_header
+{
+  char          magic[4];     // "RDGF"
+  std::uint8_t  lossy;
+  std::uint8_t  scalar_size;
+  std::uint8_t  reserved[2];
+  std::uint64_t num_values;
+  std::uint64_t block_size;
+  double        error_bound;
+};
+static_assert(sizeof(float_codec_header) == 32, "the float codec header must be 32 bytes");
+
+namespace detail {
+
+template<typename T>
+using float_bits_t = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+
+template<typename U>
+int leading_zero_bytes(U r)
+{
+  if (r == 0) return sizeof(U);
+#if defined(__GNUC__)
+  return (sizeof(U) == 8 ? __builtin_clzll(r) : __builtin_clz(static_cast<unsigned>(r))) / 8;
+#else
+  int n = 0;
+  for (U mask = U(0xff) << (8 * (sizeof(U) - 1)); (r & mask) == 0; mask >>= 8) ++n;
+  return n;
+#endif
+}
+
+// the 3-bit code of the number of the leading zero bytes of a residual; for 8-byte words,
+// 4 leading zero bytes are rare and stored as 3 to fit the 9 counts in 8 codes
+template<typename U>
+int zero_bytes_code(int& lz)
+{
+  if (sizeof(U) == 8)
+  {
+    if (lz == 4) lz = 3;
+    return lz > 4 ? lz - 1 : lz;
+  }
+  return lz;
+}
+
+template<typename U>
+int zero_bytes_of_code(int code) { return sizeof(U) == 8 && code >= 4 ? code + 1 : code; }
+
+// appends the low bytes of r, knowing that the buffer has sizeof(U) bytes of slack
+template<typename U>
+std::uint8_t* put_bytes(std::uint8_t* p, U r, int n)
+{
+  std::memcpy(p, &r, sizeof(U)); // little-endian: the low bytes come first
+  return p + n;
+}
+
+template<typename U>
+U get_bytes(const std::uint8_t*& p, const std::uint8_t* end, int n)
+{
+  if (end - p < n) throw std::runtime_error("corrupt float codec stream");
+  U r = 0;
+  std::memcpy(&r, p, n);
+  p += n;
+  return r;
+}
+
+inline bool little_endian_machine()
+{
+  const std::uint16_t one = 1;
+  return *reinterpret_cast<const unsigned char*>(&one) == 1;
+}
+
+// compresses m values into out, which has room for the worst case; returns the bytes used
+template<typename T>
+std::size_t compress_block(const T* in, std::size_t m, const float_codec_options& options, std::uint8_t* out)
+{
+  using U = float_bits_t<T>;
+  std::uint8_t* nibbles = out;
+  std::memset(nibbles, 0, (m + 1) / 2);
+  std::uint8_t* p = out + (m + 1) / 2;
+
+  if (!options.lossy)
+  {
+    T a = 0, b = 0; // previous two values
+    for (std::size_t i = 0; i < m; ++i)
+    {
+      U x, pa, pb;
+      T linear = 2 * a - b;
+      std::memcpy(&x, in + i, sizeof(U));
+      std::memcpy(&pa, &a, sizeof(U));
+      std::memcpy(&pb, &linear, sizeof(U));
+      U ra = x ^ pa, rb = x ^ pb;
+      int la = leading_zero_bytes(ra), lb = leading_zero_bytes(rb);
+      int predictor = lb > la ? 1 : 0;
+      U r = predictor ? rb : ra;
+      int lz = predictor ? lb : la;
+      int code = zero_bytes_code<U>(lz);
+      nibbles[i / 2] |= static_cast<std::uint8_t>((predictor << 3 | code) << (4 * (i % 2)));
+      p = put_bytes(p, r, sizeof(U) - lz);
+      b = a;
+      a = in[i];
+    }
+  }
+  else
+  {
+    // code 0 of predictor 0 stores the value as it is, and the quantized value is then 0
+    // the predictions wrap around in unsigned arithmetic, as the decoder's do
+    const double step = 2. * options.error_bound;
+    std::uint64_t a = 0, b = 0;
+    for (std::size_t i = 0; i < m; ++i)
+    {
+      double v = static_cast<double>(in[i]) / step;
+      std::int64_t q = 0;
+      bool exact = std::abs(v) < 4.e18;
+      if (exact)
+      {
+        q = std::llround(v);
+        exact = std::abs(static_cast<T>(q * step) - in[i]) <= options.error_bound;
+      }
+
+      int predictor = 0, code = 0, lz = 0;
+      std::uint64_t r = 0;
+      if (exact)
+      {
+        std::uint64_t ra = static_cast<std::uint64_t>(q) - a, rb = static_cast<std::uint64_t>(q) - (2 * a - b);
+        ra = (ra << 1) ^ (0 - (ra >> 63)); // zigzag: small magnitudes of either sign have leading zeros
+        rb = (rb << 1) ^ (0 - (rb >> 63));
+        int la = leading_zero_bytes(ra), lb = leading_zero_bytes(rb);
+        predictor = lb > la ? 1 : 0;
+        r = predictor ? rb : ra;
+        lz = predictor ? lb : la;
+        code = zero_bytes_code<std::uint64_t>(lz);
+        if (predictor == 0 && code == 0) exact = false;
+      }
+      if (exact) p = put_bytes(p, r, 8 - lz);
+      else
+      {
+        predictor = 0;
+        code = 0;
+        q = 0;
+        U x;
+        std::memcpy(&x, in + i, sizeof(U));
+        p = put_bytes(p, x, sizeof(U));
+      }
+      nibbles[i / 2] |= static_cast<std::uint8_t>((predictor << 3 | code) << (4 * (i % 2)));
+      b = a;
+      a = static_cast<std::uint64_t>(q);
+    }
+  }
+  return static_cast<std::size_t>(p - out);
+}
+
+template<typename T>
+void decompress_block(const std::uint8_t* in, const std::uint8_t* end, std::size_t m, const float_codec_header& h, T* out)
+{
+  using U = float_bits_t<T>;
+  const std::uint8_t* nibbles = in;
+  const std::uint8_t* p = in + (m + 1) / 2;
+  if (p > end) throw std::runtime_error("corrupt float codec stream");
+
+  if (!h.lossy)
+  {
+    T a = 0, b = 0;
+    for (std::size_t i = 0; i < m; ++i)
+    {
+      int nibble = (nibbles[i / 2] >> (4 * (i % 2))) & 0xf;
+      int lz = zero_bytes_of_code<U>(nibble & 7);
+      U r = get_bytes<U>(p, end, sizeof(U) - lz), pred;
+      T predicted = (nibble & 8) ? 2 * a - b : a;
+      std::memcpy(&pred, &predicted, sizeof(U));
+      U x = r ^ pred;
+      std::memcpy(out + i, &x, sizeof(U));
+      b = a;
+      a = out[i];
+    }
+  }
+  else
+  {
+    const double step = 2. * h.error_bound;
+    std::uint64_t a = 0, b = 0;
+    for (std::size_t i = 0; i < m; ++i)
+    {
+      int nibble = (nibbles[i / 2] >> (4 * (i % 2))) & 0xf;
+      std::uint64_t q = 0;
+      if (nibble == 0)
+      {
+        U x = get_bytes<U>(p, end, sizeof(U));
+        std::memcpy(out + i, &x, sizeof(U));
+      }
+      else
+      {
+        int lz = zero_bytes_of_code<std::uint64_t>(nibble & 7);
+        std::uint64_t r = get_bytes<std::uint64_t>(p, end, 8 - lz);
+        q = ((nibble & 8) ? 2 * a - b : a) + ((r >> 1) ^ (0 - (r & 1)));
+        out[i] = static_cast<T>(static_cast<std::int64_t>(q) * step);
+      }
+      b = a;
+      a = q;
+    }
+  }
+}
+
+}
+
+// compresses the n values into out, which is resized to the size of the stream
+template<typename Space, typename T>
+void compress_floats(const Space& space, const T* in, std::size_t n, std::vector<std::uint8_t>& out,
+                     const float_codec_options& options = float_codec_options())
+{
+  static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>, "float or double values");
+  assert(detail::little_endian_machine());
+  assert(!options.lossy || options.error_bound > 0.);
+  assert(options.block_size > 0);
+
+  const std::size_t numBlocks = (n + options.block_size - 1) / options.block_size;
+  const std::size_t worst = (options.block_size + 1) / 2 + (options.block_size + 1) * sizeof(std::uint64_t);
+  const std::size_t data = sizeof(float_codec_header) + numBlocks * sizeof(std::uint64_t);
+  out.resize(data + numBlocks * worst);
+
+  float_codec_header h{};
+  std::memcpy(h.magic, "RDGF", 4);
+  h.lossy = options.lossy;
+  h.scalar_size = sizeof(T);
+  h.num_values = n;
+  h.block_size = options.block_size;
+  h.error_bound = options.error_bound;
+  std::memcpy(out.data(), &h, sizeof(h));
+
+  // the blocks are compressed into slots of the worst-case size, then packed
+  std::vector<std::size_t> sizes(numBlocks);
+  parallel_for(space, numBlocks, [&](std::size_t) { return static_cast<double>(options.block_size); },
+    [&](std::size_t begin, std::size_t end)
+  {
+    for (std::size_t k = begin; k < end; ++k)
+    {
+      std::size_t first = k * options.block_size, m = std::min(options.block_size, n - first);
+      sizes[k] = detail::compress_block(in + first, m, options, out.data() + data + k * worst);
+    }
+  });
+
+  std::uint64_t pos = 0;
+  for (std::size_t k = 0; k < numBlocks; ++k)
+  {
+    if (pos != k * worst) std::memmove(out.data() + data + pos, out.data() + data + k * worst, sizes[k]);
+    pos += sizes[k];
+    std::memcpy(out.data() + sizeof(h) + k * sizeof(std::uint64_t), &pos, sizeof(pos));
+  }
+  out.resize(data + pos);
+}
+
+// size in bytes of the stream at in, of at most bytes bytes
+inline std::size_t float_stream_size(const std::uint8_t* in, std::size_t bytes)
+{
+  float_codec_header h;
+  if (bytes < sizeof(h)) throw std::runtime_error("corrupt float codec stream");
+  std::memcpy(&h, in, sizeof(h));
+  if (std::memcmp(h.magic, "RDGF", 4) != 0 || h.block_size == 0) throw std::runtime_error("not a float codec stream");
+  std::size_t numBlocks = (h.num_values + h.block_size - 1) / h.block_size;
+  std::size_t data = sizeof(h) + numBlocks * sizeof(std::uint64_t);
+  if (bytes < data) throw std::runtime_error("corrupt float codec stream");
+  std::uint64_t end = 0;
+  if (numBlocks > 0) std::memcpy(&end, in + data - sizeof(end), sizeof(end));
+  if (bytes - data < end) throw std::runtime_error("corrupt float codec stream");
+  return data + end;
+}
+
+// decompresses the n values of the stream at in, of at most bytes bytes, into out
+template<typename Space, typename T>
+void decompress_floats(const Space& space, const std::uint8_t* in, std::size_t bytes, T* out, std::size_t n)
+{
+  std::size_t size = float_stream_size(in, bytes);
+  float_codec_header h;
+  std::memcpy(&h, in, sizeof(h));
+  if (h.scalar_size != sizeof(T) || h.num_values != n) throw std::runtime_error("float codec stream of other values");
+
+  const std::size_t numBlocks = (n + h.block_size - 1) / h.block_size;
+  const std::uint8_t* blocks = in + sizeof(h) + numBlocks * sizeof(std::uint64_t);
+  const std::uint8_t* ends = in + sizeof(h);
+  const std::uint8_t* streamEnd = in + size;
+
+  std::atomic<bool> corrupt{false};
+  parallel_for(space, numBlocks, [&](std::size_t) { return static_cast<double>(h.block_size); },
+    [&](std::size_t begin, std::size_t end)
+  {
+    for (std::size_t k = begin; k < end; ++k)
+    {
+      std::uint64_t first = 0, last;
+      if (k > 0) std::memcpy(&first, ends + (k - 1) * sizeof(std::uint64_t), sizeof(first));
+      std::memcpy(&last, ends + k * sizeof(std::uint64_t), sizeof(last));
+      std::size_t m = std::min<std::size_t>(h.block_size, n - k * h.block_size);
+      if (first > last || blocks + last > streamEnd) { corrupt = true; continue; }
+      try { detail::decompress_block(blocks + first, blocks + last, m, h, out + k * h.block_size); }
+      catch (const std::runtime_error&) { corrupt = true; }
+    }
+  });
+  if (corrupt) throw std::runtime_error("corrupt float codec stream");
+}
+
+}
+
+#endif
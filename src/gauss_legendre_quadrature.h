@@ -0,0 +1,130 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#ifndef GAUSS_LEGENDRE_QUADRATURE_H
+#define GAUSS_LEGENDRE_QUADRATURE_H
+
+#include <iterator>
+#include <memory>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <limits>
+
+#include <cmath>
+#include <cassert>
+
+#include "const_val.h"
+#include "legendre_polynomials.h"
+#include "gauss_lobatto_quadrature.h" // output_iterator_traits
+
+namespace rdg {
+
+// Gauss-Legendre points and weights of arbitrary number of points, computed once per
+// (T, npts) and kept in a process-wide table for the life time of the program.
+//
+// The points are the roots of P_N, N = npts, found by Newton iterations starting from
+// the asymptotic approximations cos(pi * (4i - 1) / (4N + 2)); the weights are
+// 2 / ((1 - x^2) * P'_N(x)^2). Only half of the points are computed and the other half
+// are mirrored so that the symmetry is exact.
+template<typename T>
+class gauss_legendre_table
+{
+public:
+  // thread safe; the returned reference stays valid until the program exits
+  static const gauss_legendre_table& get(std::size_t npts);
+
+  std::size_t num_points() const { return m_points.size(); }
+
+  const std::vector<T>& points() const { return m_points; }
+
+  const std::vector<T>& weights() const { return m_weights; }
+
+private:
+  explicit gauss_legendre_table(std::size_t npts);
+
+private:
+  std::vector<T> m_points;
+  std::vector<T> m_weights;
+};
+
+template<typename T>
+const gauss_legendre_table<T>& gauss_legendre_table<T>::get(std::size_t npts)
+{
+  static std::mutex s_mutex;
+  static std::map<std::size_t, std::unique_ptr<const gauss_legendre_table>> s_tables;
+
+  std::lock_guard<std::mutex> lock(s_mutex);
+  auto& table = s_tables[npts];
+  if (!table) table.reset(new gauss_legendre_table(npts));
+  return *table;
+}
+
+template<typename T>
+gauss_legendre_table<T>::gauss_legendre_table(std::size_t npts) : m_points(npts), m_weights(npts)
+{
+  assert(npts >= 1);
+
+  const std::size_t N = npts;
+  const T pi = std::acos(- const_val<T, 1>);
+  const T tol = const_val<T, 4> * std::numeric_limits<T>::epsilon();
+
+  for (std::size_t j = 0; j < (N + 1) / 2; ++j)
+  {
+    T x = - std::cos(pi * static_cast<T>(4 * j + 3) / static_cast<T>(4 * N + 2));
+    if (2 * j + 1 != N)
+    {
+      for (int iter = 0; iter < 100; ++iter)
+      {
+        T dx = legendre_polynomial_value(N, x) / legendre_polynomial_derivative(N, x);
+        x -= dx;
+        if (std::abs(dx) <= tol) break;
+      }
+    }
+    else x = const_val<T, 0>;
+
+    T dp = legendre_polynomial_derivative(N, x);
+    m_points[j] = x;
+    m_points[N - 1 - j] = - x;
+    m_weights[j] = m_weights[N - 1 - j] = const_val<T, 2> / ((const_val<T, 1> - x * x) * dp * dp);
+  }
+}
+
+// Gauss-Legendre quadrature of npts points, exact for polynomials of degree up to 2 * npts - 1
+template<typename OutputIteratorP, typename OutputIteratorW>
+void gauss_legendre_quadrature(std::size_t npts, OutputIteratorP it_p, OutputIteratorW it_w)
+{
+  assert(npts >= 1);
+
+  using P = typename output_iterator_traits<OutputIteratorP>::value_type;
+  using W = typename output_iterator_traits<OutputIteratorW>::value_type;
+
+  const auto& points = gauss_legendre_table<P>::get(npts).points();
+  const auto& weights = gauss_legendre_table<W>::get(npts).weights();
+  for (std::size_t i = 0; i < npts; ++i)
+  {
+    *it_p++ = points[i];
+    *it_w++ = weights[i];
+  }
+}
+
+}
+
+#endif
@@ -23,11 +23,16 @@
 
 #include <iterator>
 #include <memory>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <limits>
 
 #include <cmath>
 #include <cassert>
 
 #include "const_val.h"
+#include "legendre_polynomials.h"
 
 namespace rdg {
 
@@ -60,7 +65,85 @@ struct output_iterator_traits<std::ostreambuf_iterator<charT, traits>>
 : std::iterator<std::output_iterator_tag, charT> {};
 
 
-// TODO: implement the Golub-Welsch algorithm to cover arbitrary order
+// Gauss-Lobatto points and weights of arbitrary number of points, computed once per
+// (T, npts) and kept in a process-wide table for the life time of the program.
+//
+// The interior points are the roots of P'_N, N = npts - 1, found by Newton iterations
+// on the Legendre polynomial derivatives starting from the Chebyshev-Gauss-Lobatto
+// points; the weights are 2 / (N * (N + 1) * P_N(x)^2). Only half of the points are
+// computed and the other half are mirrored so that the symmetry is exact.
+template<typename T>
+class gauss_lobatto_table
+{
+public:
+  // thread safe; the returned reference stays valid until the program exits
+  static const gauss_lobatto_table& get(std::size_t npts);
+
+  std::size_t num_points() const { return m_points.size(); }
+
+  const std::vector<T>& points() const { return m_points; }
+
+  const std::vector<T>& weights() const { return m_weights; }
+
+private:
+  explicit gauss_lobatto_table(std::size_t npts);
+
+private:
+  std::vector<T> m_points;
+  std::vector<T> m_weights;
+};
+
+template<typename T>
+const gauss_lobatto_table<T>& gauss_lobatto_table<T>::get(std::size_t npts)
+{
+  static std::mutex s_mutex;
+  static std::map<std::size_t, std::unique_ptr<const gauss_lobatto_table>> s_tables;
+
+  std::lock_guard<std::mutex> lock(s_mutex);
+  auto& table = s_tables[npts];
+  if (!table) table.reset(new gauss_lobatto_table(npts));
+  return *table;
+}
+
+template<typename T>
+gauss_lobatto_table<T>::gauss_lobatto_table(std::size_t npts) : m_points(npts), m_weights(npts)
+{
+  assert(npts >= 2);
+
+  const std::size_t N = npts - 1;
+  const T NN1 = static_cast<T>(N * (N + 1));
+  const T pi = std::acos(- const_val<T, 1>);
+  const T tol = const_val<T, 4> * std::numeric_limits<T>::epsilon();
+
+  m_points[0] = - const_val<T, 1>;
+  m_points[N] = const_val<T, 1>;
+  m_weights[0] = m_weights[N] = const_val<T, 2> / NN1;
+
+  for (std::size_t j = 1; j <= N / 2; ++j)
+  {
+    T x = - std::cos(pi * static_cast<T>(j) / static_cast<T>(N));
+    if (2 * j != N)
+    {
+      for (int iter = 0; iter < 100; ++iter)
+      {
+        // P''_N from the Legendre differential equation
+        T dp = legendre_polynomial_derivative(N, x);
+        T ddp = (const_val<T, 2> * x * dp - NN1 * legendre_polynomial_value(N, x)) / (const_val<T, 1> - x * x);
+        T dx = dp / ddp;
+        x -= dx;
+        if (std::abs(dx) <= tol) break;
+      }
+    }
+    else x = const_val<T, 0>;
+
+    T p = legendre_polynomial_value(N, x);
+    m_points[j] = x;
+    m_points[N - j] = - x;
+    m_weights[j] = m_weights[N - j] = const_val<T, 2> / (NN1 * p * p);
+  }
+}
+
+// closed-form values for up to 7 points and the values of gauss_lobatto_table otherwise
 template<typename OutputIteratorP, typename OutputIteratorW>
 void gauss_lobatto_quadrature(std::size_t npts, OutputIteratorP it_p, OutputIteratorW it_w)
 {
@@ -138,7 +221,16 @@ void gauss_lobatto_quadrature(std::size_t npts, OutputIteratorP it_p, OutputIter
       *it_w++ = const_val<W, 1> / const_val<W, 21>;
       return;
     default:
-      throw "gauss-lobatto quadrature order 8 and above are not implemented!";
+      {
+        const auto& points = gauss_lobatto_table<P>::get(npts).points();
+        const auto& weights = gauss_lobatto_table<W>::get(npts).weights();
+        for (std::size_t i = 0; i < npts; ++i)
+        {
+          *it_p++ = points[i];
+          *it_w++ = weights[i];
+        }
+      }
+      return;
   }
 }
 
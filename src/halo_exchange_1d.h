@@ -0,0 +1,50 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#ifndef HALO_EXCHANGE_1D_H
+#define HALO_EXCHANGE_1D_H
+
+namespace rdg {
+
+// The halo exchange of a 1D operator on a contiguous range of the cells of a larger mesh,
+// e.g., the range of a rank of a distributed run (see mpi_halo_exchange_1d.h): the traces
+// at the first and the last nodes of the range go to the owners of the neighboring
+// ranges, and their traces come back as the states beyond the ends of the range, which
+// replace the boundary conditions of the faces at the ends. The exchange is split into
+// start(first, last), which posts the messages, and finish(left, right), which waits for
+// them, so that the work independent of the neighbors can run in between. has_left() and
+// has_right() tell whether there are such neighbors. This one has none, i.e., the range
+// is the whole mesh.
+struct no_halo_1d
+{
+  bool has_left() const { return false; }
+
+  bool has_right() const { return false; }
+
+  template<typename V>
+  void start(const V& first, const V& last) {}
+
+  template<typename V>
+  void finish(V& left, V& right) {}
+};
+
+}
+
+#endif
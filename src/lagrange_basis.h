@@ -24,9 +24,11 @@
 #include <cstddef> // size_t
 #include <vector>
 #include <algorithm>
+#include <iterator>
 #include <cassert>
 
 #include "const_val.h"
+#include "dense_matrix.h"
 
 namespace rdg {
 
@@ -111,7 +113,114 @@ public:
     return coeff * value(i, x);
   }
 
+  // Batch evaluations at many points by the barycentric formula of the second form:
+  // values(begin, end)(i, q) is the ith basis polynomial at the qth point of [begin, end),
+  // and derivatives(begin, end)(i, q) its first derivative. Points coinciding with nodes
+  // are handled exactly, i.e., they give the Kronecker delta and the nodal derivatives.
+  template<typename InputItr>
+  dense_matrix<T, false> values(InputItr begin, InputItr end) const
+  {
+    dense_matrix<T, false> result(nodes.size(), std::distance(begin, end));
+    values(begin, end, result.view());
+    return result;
+  }
+
+  template<typename InputItr>
+  dense_matrix<T, false> derivatives(InputItr begin, InputItr end) const
+  {
+    dense_matrix<T, false> result(nodes.size(), std::distance(begin, end));
+    derivatives(begin, end, result.view());
+    return result;
+  }
+
+  // the same as above but writing to the given num_nodes() x M (row major) view
+  template<typename InputItr>
+  void values(InputItr begin, InputItr end, const dense_matrix_view<T, false>& result) const
+  { evaluate<false>(begin, end, result); }
+
+  template<typename InputItr>
+  void derivatives(InputItr begin, InputItr end, const dense_matrix_view<T, false>& result) const
+  { evaluate<true>(begin, end, result); }
+
 private:
+  // NOTE: The loops over the points are written with no branches and no dependencies
+  // NOTE: between the points so that the compiler vectorizes them: for the points that
+  // NOTE: coincide with a node, the division by zero is replaced by a division by one,
+  // NOTE: and the results at these points are overwritten at the end.
+  template<bool DERIVATIVE, typename InputItr>
+  void evaluate(InputItr begin, InputItr end, const dense_matrix_view<T, false>& result) const
+  {
+    const std::vector<T> xs(begin, end);
+    const std::size_t N = nodes.size();
+    const std::size_t M = xs.size();
+    if (M == 0) return; // no points, and a dense_matrix of no columns has no rows either
+    assert(result.size_row() == N && result.size_col() == M);
+
+    // s(x) = sum_k w_k / (x - x_k) and, for derivatives, sp(x) = sum_k w_k / (x - x_k)^2
+    // and the index of the node the point coincides with (N if none)
+    std::vector<T> s(M, const_val<T, 0>);
+    std::vector<T> sp(DERIVATIVE ? M : 0, const_val<T, 0>);
+    std::vector<std::size_t> hits(M, N);
+    const T* x = xs.data();
+    for (std::size_t k = 0; k < N; ++k)
+    {
+      const T xk = nodes[k];
+      const T wk = weights[k];
+      T* sq = s.data();
+      T* spq = sp.data();
+      std::size_t* hq = hits.data();
+      for (std::size_t q = 0; q < M; ++q)
+      {
+        T d = x[q] - xk;
+        T r = const_val<T, 1> / (d == const_val<T, 0> ? const_val<T, 1> : d);
+        hq[q] = d == const_val<T, 0> ? k : hq[q];
+        sq[q] += wk * r;
+        if constexpr(DERIVATIVE) spq[q] += wk * r * r;
+      }
+    }
+
+    // l_i(x) = (w_i / (x - x_i)) / s(x) and l_i'(x) = l_i(x) * (sp(x) / s(x) - 1 / (x - x_i))
+    for (std::size_t q = 0; q < M; ++q) s[q] = const_val<T, 1> / s[q];
+    if constexpr(DERIVATIVE) for (std::size_t q = 0; q < M; ++q) sp[q] *= s[q];
+    for (std::size_t i = 0; i < N; ++i)
+    {
+      const T xi = nodes[i];
+      const T wi = weights[i];
+      const T* invs = s.data();
+      const T* ratio = sp.data();
+      T* row = &result(i, 0);
+      for (std::size_t q = 0; q < M; ++q)
+      {
+        T d = x[q] - xi;
+        T r = const_val<T, 1> / (d == const_val<T, 0> ? const_val<T, 1> : d);
+        T l = wi * r * invs[q];
+        if constexpr(DERIVATIVE) row[q] = l * (ratio[q] - r);
+        else row[q] = l;
+      }
+    }
+
+    // exact values at the points coinciding with nodes
+    for (std::size_t q = 0; q < M; ++q)
+    {
+      std::size_t j = hits[q];
+      if (j == N) continue;
+
+      if constexpr(DERIVATIVE)
+      {
+        T diag = const_val<T, 0>;
+        for (std::size_t i = 0; i < N; ++i)
+          if (i != j)
+          {
+            result(i, q) = weights[i] / weights[j] / (nodes[j] - nodes[i]);
+            diag -= result(i, q);
+          }
+        result(j, q) = diag;
+      }
+      else
+        for (std::size_t i = 0; i < N; ++i) result(i, q) = i == j ? const_val<T, 1> : const_val<T, 0>;
+    }
+  }
+
   void compute_barycentric_weights()
   {
     weights.resize(nodes.size());
@@ -0,0 +1,145 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#ifndef LGL_GL_TRANSFER_H
+#define LGL_GL_TRANSFER_H
+
+#include <cstddef> // size_t
+#include <vector>
+#include <map>
+#include <mutex>
+#include <memory>
+#include <utility>
+#include <iterator>
+#include <cassert>
+
+#include "const_val.h"
+#include "dense_matrix.h"
+#include "lagrange_basis.h"
+#include "gauss_lobatto_quadrature.h"
+#include "gauss_legendre_quadrature.h"
+
+namespace rdg {
+
+// interpolation matrix I of the given nodal basis to the points [begin, end), i.e.,
+// I(q, j) = l_j(x_q), so that I * u gives the values at the points of the polynomial
+// whose nodal values are u
+template<typename T, typename InputItr>
+dense_matrix<T, false> interpolation_matrix(const lagrange_basis<T>& basis, InputItr begin, InputItr end)
+{
+  dense_matrix<T, false> result(std::distance(begin, end), basis.num_nodes());
+  for (std::size_t q = 0; begin != end; ++q, ++begin)
+    for (std::size_t j = 0; j < basis.num_nodes(); ++j)
+      result(q, j) = basis.value(j, *begin);
+  return result;
+}
+
+// Operators between the Legendre-Gauss-Lobatto (LGL) points of n_lgl points, i.e., the
+// collocation points of reference_segment, and the Legendre-Gauss (GL) points of n_gl
+// points, which are used for over-integration and exact integration of error norms.
+// The operators are built once per (T, n_lgl, n_gl) and kept in a process-wide table.
+//
+// lgl_to_gl() is the interpolation of the LGL nodal polynomial to the GL points. When
+// n_gl <= n_lgl, gl_to_lgl() is the interpolation of the GL nodal polynomial to the LGL
+// points, which is exact; otherwise, it is the L2 projection of the GL nodal polynomial
+// onto the polynomials of degree n_lgl - 1, M^{-1} * V^T * W, where V = lgl_to_gl(),
+// W = diag(GL weights), and M = V^T * W * V is the exact mass matrix of the LGL basis.
+template<typename T>
+class lgl_gl_transfer
+{
+public:
+  using matrix_type = dense_matrix<T, false>; // row major
+
+  // thread safe; the returned reference stays valid until the program exits
+  static const lgl_gl_transfer& get(std::size_t n_lgl, std::size_t n_gl);
+
+  std::size_t num_lgl_points() const { return m_lgl_points.size(); }
+
+  std::size_t num_gl_points() const { return m_gl_points.size(); }
+
+  const std::vector<T>& lgl_points() const { return m_lgl_points; }
+
+  const std::vector<T>& gl_points() const { return m_gl_points; }
+
+  const std::vector<T>& gl_weights() const { return m_gl_weights; }
+
+  const matrix_type& lgl_to_gl() const { return m_lgl_to_gl; }
+
+  const matrix_type& gl_to_lgl() const { return m_gl_to_lgl; }
+
+private:
+  lgl_gl_transfer(std::size_t n_lgl, std::size_t n_gl);
+
+private:
+  std::vector<T> m_lgl_points;
+  std::vector<T> m_gl_points;
+  std::vector<T> m_gl_weights;
+  matrix_type    m_lgl_to_gl;
+  matrix_type    m_gl_to_lgl;
+};
+
+template<typename T>
+const lgl_gl_transfer<T>& lgl_gl_transfer<T>::get(std::size_t n_lgl, std::size_t n_gl)
+{
+  static std::mutex s_mutex;
+  static std::map<std::pair<std::size_t, std::size_t>, std::unique_ptr<const lgl_gl_transfer>> s_transfers;
+
+  std::lock_guard<std::mutex> lock(s_mutex);
+  auto& transfer = s_transfers[std::make_pair(n_lgl, n_gl)];
+  if (!transfer) transfer.reset(new lgl_gl_transfer(n_lgl, n_gl));
+  return *transfer;
+}
+
+template<typename T>
+lgl_gl_transfer<T>::lgl_gl_transfer(std::size_t n_lgl, std::size_t n_gl)
+{
+  assert(n_lgl >= 2 && n_gl >= 1);
+
+  std::vector<T> lgl_weights;
+  gauss_lobatto_quadrature(n_lgl, std::back_inserter(m_lgl_points), std::back_inserter(lgl_weights));
+  gauss_legendre_quadrature(n_gl, std::back_inserter(m_gl_points), std::back_inserter(m_gl_weights));
+
+  lagrange_basis<T> lgl_basis(m_lgl_points.begin(), m_lgl_points.end());
+  m_lgl_to_gl = interpolation_matrix(lgl_basis, m_gl_points.begin(), m_gl_points.end());
+
+  if (n_gl <= n_lgl)
+  {
+    lagrange_basis<T> gl_basis;
+    if (n_gl == 1) m_gl_to_lgl = matrix_type(n_lgl, 1, const_val<T, 1>); // constant
+    else
+    {
+      gl_basis.set_nodes(m_gl_points.begin(), m_gl_points.end());
+      m_gl_to_lgl = interpolation_matrix(gl_basis, m_lgl_points.begin(), m_lgl_points.end());
+    }
+  }
+  else
+  {
+    // V^T * W and the mass matrix V^T * W * V, exact as 2 * (n_lgl - 1) < 2 * n_gl - 1
+    matrix_type VtW = m_lgl_to_gl.transpose();
+    for (std::size_t i = 0; i < n_lgl; ++i)
+      for (std::size_t q = 0; q < n_gl; ++q)
+        VtW(i, q) *= m_gl_weights[q];
+    m_gl_to_lgl = (VtW * m_lgl_to_gl).inverse() * VtW;
+  }
+}
+
+}
+
+#endif
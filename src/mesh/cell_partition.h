@@ -0,0 +1,141 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#ifndef CELL_PARTITION_H
+#define CELL_PARTITION_H
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include <ostream>
+
+#include "cell_reordering.h"
+
+namespace rdg {
+
+// estimated cost of a cell of the given order in dim dimensional space for the flux
+// differencing schemes, i.e., proportional to the number of two-point fluxes
+inline double flux_differencing_cost(int order, int dim)
+{
+  double n = order + 1;
+  double cost = n;
+  for (int d = 0; d < dim; ++d) cost *= n;
+  return cost * dim;
+}
+
+// Partition of the cells into contiguous chunks along a space-filling curve (or any
+// locality-preserving order, see cell_reordering.h) of balanced total weights, e.g.,
+// the costs of the cells of various orders. Part p owns the cells of the positions
+// part_begin(p), ..., part_end(p) - 1 in the order, which serve directly as the ranges
+// of a threaded element loop over the reordered cells, and part(c) is the part of the
+// cell c of the original numbering, which assigns the cells to the ranks of a
+// distributed run.
+class cell_partition
+{
+public:
+  template<typename W>
+  cell_partition(const cell_permutation& order, const std::vector<W>& weights, int num_parts);
+
+  int num_parts() const { return static_cast<int>(m_offsets.size()) - 1; }
+
+  std::size_t num_cells() const { return m_part.size(); }
+
+  int part(std::size_t c) const { return m_part[c]; }
+
+  const std::vector<int>& parts() const { return m_part; }
+
+  std::size_t part_begin(int p) const { return m_offsets[p]; }
+
+  std::size_t part_end(int p) const { return m_offsets[p + 1]; }
+
+  const std::vector<std::size_t>& offsets() const { return m_offsets; }
+
+  double part_weight(int p) const { return m_weights[p]; }
+
+  // the maximum over the average of the part weights, 1 being perfectly balanced
+  double imbalance() const
+  {
+    double total = std::accumulate(m_weights.begin(), m_weights.end(), 0.);
+    return total > 0. ? *std::max_element(m_weights.begin(), m_weights.end()) * num_parts() / total : 1.;
+  }
+
+  // number of the edges of the cell graph, given in the CSR format of cell_adjacency
+  // and of the original numbering, between different parts, i.e., of the faces to
+  // exchange in a distributed run
+  std::size_t edge_cut(const std::vector<std::size_t>& offsets, const std::vector<std::size_t>& adjacency) const
+  {
+    assert(offsets.size() == num_cells() + 1);
+    std::size_t cut = 0;
+    for (std::size_t c = 0; c < num_cells(); ++c)
+      for (std::size_t k = offsets[c]; k < offsets[c + 1]; ++k)
+        if (adjacency[k] > c && m_part[adjacency[k]] != m_part[c]) cut++;
+    return cut;
+  }
+
+  void print_statistics(std::ostream& out, const std::vector<std::size_t>& offsets,
+                        const std::vector<std::size_t>& adjacency) const
+  {
+    out << num_parts() << " parts of " << num_cells() << " cells: imbalance " << imbalance()
+        << ", edge-cut " << edge_cut(offsets, adjacency) << std::endl;
+  }
+
+private:
+  std::vector<int>          m_part;
+  std::vector<std::size_t>  m_offsets;
+  std::vector<double>       m_weights;
+};
+
+// the part boundaries are where the prefix sums of the weights along the order cross
+// the multiples of the average part weight, moved to the nearer cell boundary
+template<typename W>
+cell_partition::cell_partition(const cell_permutation& order, const std::vector<W>& weights, int num_parts)
+  : m_part(order.size()), m_offsets(num_parts + 1, 0), m_weights(num_parts, 0.)
+{
+  assert(num_parts > 0 && weights.size() == order.size());
+  const std::size_t n = order.size();
+
+  std::vector<double> prefix(n + 1, 0.);
+  for (std::size_t i = 0; i < n; ++i) prefix[i + 1] = prefix[i] + static_cast<double>(weights[order.new_to_old(i)]);
+
+  for (int p = 1; p < num_parts; ++p)
+  {
+    double target = prefix[n] * p / num_parts;
+    std::size_t i = std::lower_bound(prefix.begin(), prefix.end(), target) - prefix.begin();
+    if (i > 0 && target - prefix[i - 1] < prefix[i] - target) --i;
+
+    // keep the parts non-empty as long as there are enough cells
+    std::size_t lo = m_offsets[p - 1] + (n >= static_cast<std::size_t>(num_parts) ? 1 : 0);
+    std::size_t hi = n >= static_cast<std::size_t>(num_parts) ? n - (num_parts - p) : n;
+    m_offsets[p] = std::min(std::max(i, lo), hi);
+  }
+  m_offsets[num_parts] = n;
+
+  for (int p = 0; p < num_parts; ++p)
+  {
+    for (std::size_t i = m_offsets[p]; i < m_offsets[p + 1]; ++i) m_part[order.new_to_old(i)] = p;
+    m_weights[p] = prefix[m_offsets[p + 1]] - prefix[m_offsets[p]];
+  }
+}
+
+}
+
+#endif
@@ -0,0 +1,309 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#ifndef CELL_REORDERING_H
+#define CELL_REORDERING_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <queue>
+#include <numeric>
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "unstructured_hex_mesh.h"
+
+namespace rdg {
+
+// Permutation of the cells of a mesh, given by the old index of each new cell. The
+// same permutation is applied to every array of per-cell data, i.e., the DOFs of the
+// solution and the geometric data, as blocks of a fixed size per cell, and its inverse
+// brings the data back to the original order, e.g., for output.
+class cell_permutation
+{
+public:
+  explicit cell_permutation(std::vector<std::size_t> new_to_old)
+    : m_new_to_old(std::move(new_to_old)), m_old_to_new(m_new_to_old.size())
+  {
+    for (std::size_t i = 0; i < m_new_to_old.size(); ++i)
+    {
+      assert(m_new_to_old[i] < m_new_to_old.size());
+      m_old_to_new[m_new_to_old[i]] = i;
+    }
+  }
+
+  // the cells in their original order, e.g., those of a structured mesh
+  static cell_permutation identity(std::size_t n)
+  {
+    std::vector<std::size_t> new_to_old(n);
+    std::iota(new_to_old.begin(), new_to_old.end(), 0);
+    return cell_permutation(std::move(new_to_old));
+  }
+
+  std::size_t size() const { return m_new_to_old.size(); }
+
+  std::size_t new_to_old(std::size_t i) const { return m_new_to_old[i]; }
+
+  std::size_t old_to_new(std::size_t i) const { return m_old_to_new[i]; }
+
+  cell_permutation inverse() const { return cell_permutation(m_old_to_new); }
+
+  // out, in the new order, of the blocks of block_size entries per cell of in in the old order
+  template<typename InputItr, typename OutputItr>
+  void apply(InputItr in, std::size_t block_size, OutputItr out) const
+  {
+    for (std::size_t i = 0; i < size(); ++i)
+      for (std::size_t k = 0; k < block_size; ++k)
+        *(out + (i * block_size + k)) = *(in + (m_new_to_old[i] * block_size + k));
+  }
+
+  // the reverse of apply
+  template<typename InputItr, typename OutputItr>
+  void apply_inverse(InputItr in, std::size_t block_size, OutputItr out) const
+  {
+    for (std::size_t i = 0; i < size(); ++i)
+      for (std::size_t k = 0; k < block_size; ++k)
+        *(out + (m_new_to_old[i] * block_size + k)) = *(in + (i * block_size + k));
+  }
+
+private:
+  std::vector<std::size_t> m_new_to_old;
+  std::vector<std::size_t> m_old_to_new;
+};
+
+namespace sfc_detail {
+
+// bits of 0 <= v < 2^21 spread to every third bit
+inline std::uint64_t spread_by_3(std::uint64_t v)
+{
+  v &= 0x1fffff;
+  v = (v | v << 32) & 0x1f00000000ffffULL;
+  v = (v | v << 16) & 0x1f0000ff0000ffULL;
+  v = (v | v << 8) & 0x100f00f00f00f00fULL;
+  v = (v | v << 4) & 0x10c30c30c30c30c3ULL;
+  v = (v | v << 2) & 0x1249249249249249ULL;
+  return v;
+}
+
+constexpr int key_bits = 21;
+
+// coordinates scaled to the integers of key_bits bits in the bounding box of the points
+template<typename T>
+std::vector<std::uint32_t> quantize(const std::vector<T>& coords)
+{
+  std::vector<std::uint32_t> q(coords.size(), 0);
+  if (coords.empty()) return q;
+  auto mm = std::minmax_element(coords.begin(), coords.end());
+  T lo = *mm.first, range = *mm.second - *mm.first;
+  if (!(range > 0)) return q;
+  const T scale = static_cast<T>((1u << key_bits) - 1) / range;
+  for (std::size_t i = 0; i < coords.size(); ++i)
+    q[i] = static_cast<std::uint32_t>((coords[i] - lo) * scale);
+  return q;
+}
+
+// order of the cells by their keys; ties keep the original order
+inline cell_permutation sort_by_keys(const std::vector<std::uint64_t>& keys)
+{
+  std::vector<std::size_t> perm(keys.size());
+  std::iota(perm.begin(), perm.end(), 0);
+  std::stable_sort(perm.begin(), perm.end(), [&keys](std::size_t a, std::size_t b) { return keys[a] < keys[b]; });
+  return cell_permutation(std::move(perm));
+}
+
+}
+
+// key of the Morton, i.e., Z-order, curve
+inline std::uint64_t morton_key(std::uint32_t x, std::uint32_t y, std::uint32_t z)
+{
+  using namespace sfc_detail;
+  return spread_by_3(x) | spread_by_3(y) << 1 | spread_by_3(z) << 2;
+}
+
+// key of the Hilbert curve of key_bits bits per coordinate, see the paper "Programming
+// the Hilbert Curve" by J. Skilling, AIP Conference Proceedings, Vol. 707, 2004
+inline std::uint64_t hilbert_key(std::uint32_t x, std::uint32_t y, std::uint32_t z)
+{
+  constexpr int bits = sfc_detail::key_bits;
+  std::uint32_t X[3] = {x, y, z};
+  const std::uint32_t M = 1u << (bits - 1);
+
+  // inverse undo excess work
+  for (std::uint32_t Q = M; Q > 1; Q >>= 1)
+  {
+    std::uint32_t P = Q - 1;
+    for (int i = 0; i < 3; ++i)
+      if (X[i] & Q) X[0] ^= P;
+      else
+      {
+        std::uint32_t t = (X[0] ^ X[i]) & P;
+        X[0] ^= t;
+        X[i] ^= t;
+      }
+  }
+
+  // Gray encode
+  for (int i = 1; i < 3; ++i) X[i] ^= X[i - 1];
+  std::uint32_t t = 0;
+  for (std::uint32_t Q = M; Q > 1; Q >>= 1)
+    if (X[2] & Q) t ^= Q - 1;
+  for (int i = 0; i < 3; ++i) X[i] ^= t;
+
+  // interleave the transposed coordinates, the most significant bits first
+  std::uint64_t key = 0;
+  for (int b = bits - 1; b >= 0; --b)
+    for (int i = 0; i < 3; ++i) key = key << 1 | ((X[i] >> b) & 1u);
+  return key;
+}
+
+// cells ordered along the Morton or the Hilbert curve through their centroids (for 2D
+// meshes pass z of the same value for all cells)
+template<typename T>
+cell_permutation morton_order(const std::vector<T>& xc, const std::vector<T>& yc, const std::vector<T>& zc)
+{
+  assert(xc.size() == yc.size() && xc.size() == zc.size());
+  auto qx = sfc_detail::quantize(xc), qy = sfc_detail::quantize(yc), qz = sfc_detail::quantize(zc);
+  std::vector<std::uint64_t> keys(xc.size());
+  for (std::size_t i = 0; i < keys.size(); ++i) keys[i] = morton_key(qx[i], qy[i], qz[i]);
+  return sfc_detail::sort_by_keys(keys);
+}
+
+template<typename T>
+cell_permutation hilbert_order(const std::vector<T>& xc, const std::vector<T>& yc, const std::vector<T>& zc)
+{
+  assert(xc.size() == yc.size() && xc.size() == zc.size());
+  auto qx = sfc_detail::quantize(xc), qy = sfc_detail::quantize(yc), qz = sfc_detail::quantize(zc);
+  std::vector<std::uint64_t> keys(xc.size());
+  for (std::size_t i = 0; i < keys.size(); ++i) keys[i] = hilbert_key(qx[i], qy[i], qz[i]);
+  return sfc_detail::sort_by_keys(keys);
+}
+
+// reverse Cuthill-McKee ordering of the graph of the cells given in CSR format, i.e.,
+// the neighbors of cell c are adjacency[offsets[c]], ..., adjacency[offsets[c + 1] - 1];
+// each connected component starts from a cell of the minimum degree
+inline cell_permutation rcm_order(const std::vector<std::size_t>& offsets, const std::vector<std::size_t>& adjacency)
+{
+  assert(!offsets.empty());
+  const std::size_t n = offsets.size() - 1;
+  auto degree = [&offsets](std::size_t c) { return offsets[c + 1] - offsets[c]; };
+
+  std::vector<std::size_t> by_degree(n);
+  std::iota(by_degree.begin(), by_degree.end(), 0);
+  std::stable_sort(by_degree.begin(), by_degree.end(), [&](std::size_t a, std::size_t b) { return degree(a) < degree(b); });
+
+  std::vector<std::size_t> order;
+  order.reserve(n);
+  std::vector<bool> visited(n, false);
+  std::vector<std::size_t> next;
+  for (std::size_t start : by_degree)
+  {
+    if (visited[start]) continue;
+    visited[start] = true;
+    std::size_t head = order.size();
+    order.push_back(start);
+    while (head < order.size())
+    {
+      std::size_t c = order[head++];
+      next.clear();
+      for (std::size_t k = offsets[c]; k < offsets[c + 1]; ++k)
+        if (!visited[adjacency[k]])
+        {
+          visited[adjacency[k]] = true;
+          next.push_back(adjacency[k]);
+        }
+      std::stable_sort(next.begin(), next.end(), [&](std::size_t a, std::size_t b) { return degree(a) < degree(b); });
+      order.insert(order.end(), next.begin(), next.end());
+    }
+  }
+
+  std::reverse(order.begin(), order.end());
+  return cell_permutation(std::move(order));
+}
+
+// centroids of the cells, i.e., the averages of their vertices
+template<typename T>
+void cell_centroids(const unstructured_hex_mesh<T>& mesh, std::vector<T>& xc, std::vector<T>& yc, std::vector<T>& zc)
+{
+  using mesh_type = unstructured_hex_mesh<T>;
+  xc.assign(mesh.num_cells(), T(0));
+  yc.assign(mesh.num_cells(), T(0));
+  zc.assign(mesh.num_cells(), T(0));
+  for (std::size_t c = 0; c < mesh.num_cells(); ++c)
+  {
+    for (int k = 0; k < mesh_type::num_cell_vertices(); ++k)
+    {
+      auto p = mesh.get_vertex(mesh.cell_vertex(c, k));
+      xc[c] += p[0];
+      yc[c] += p[1];
+      zc[c] += p[2];
+    }
+    xc[c] /= static_cast<T>(mesh_type::num_cell_vertices());
+    yc[c] /= static_cast<T>(mesh_type::num_cell_vertices());
+    zc[c] /= static_cast<T>(mesh_type::num_cell_vertices());
+  }
+}
+
+// face-neighbor graph of the cells in CSR format, for rcm_order
+template<typename T>
+void cell_adjacency(const unstructured_hex_mesh<T>& mesh, std::vector<std::size_t>& offsets, std::vector<std::size_t>& adjacency)
+{
+  using mesh_type = unstructured_hex_mesh<T>;
+  offsets.assign(1, 0);
+  adjacency.clear();
+  adjacency.reserve(mesh.num_cells() * mesh_type::num_cell_faces());
+  for (std::size_t c = 0; c < mesh.num_cells(); ++c)
+  {
+    for (int f = 0; f < mesh_type::num_cell_faces(); ++f)
+      if (mesh.neighbor(c, f) != mesh_type::invalid_index) adjacency.push_back(mesh.neighbor(c, f));
+    offsets.push_back(adjacency.size());
+  }
+}
+
+// the mesh of the cells in the new order; the faces are renumbered in the new order of
+// the cells as well, so that the face loops follow the cell order
+template<typename T>
+unstructured_hex_mesh<T> permute_cells(const unstructured_hex_mesh<T>& mesh, const cell_permutation& perm)
+{
+  using mesh_type = unstructured_hex_mesh<T>;
+  assert(perm.size() == mesh.num_cells());
+
+  std::vector<T> x(mesh.num_vertices()), y(mesh.num_vertices()), z(mesh.num_vertices());
+  for (std::size_t i = 0; i < mesh.num_vertices(); ++i)
+  {
+    auto p = mesh.get_vertex(i);
+    x[i] = p[0];
+    y[i] = p[1];
+    z[i] = p[2];
+  }
+
+  std::vector<std::size_t> cell_vertices(mesh.num_cells() * mesh_type::num_cell_vertices());
+  for (std::size_t i = 0; i < mesh.num_cells(); ++i)
+    for (int k = 0; k < mesh_type::num_cell_vertices(); ++k)
+      cell_vertices[i * mesh_type::num_cell_vertices() + k] = mesh.cell_vertex(perm.new_to_old(i), k);
+
+  return mesh_type(std::move(x), std::move(y), std::move(z), std::move(cell_vertices));
+}
+
+}
+
+#endif
@@ -0,0 +1,252 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#ifndef GMSH_READER_H
+#define GMSH_READER_H
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "unstructured_hex_mesh.h"
+
+namespace rdg {
+
+namespace gmsh_detail {
+
+// number of nodes of the Gmsh element types, 0 for the types not listed
+inline int num_element_nodes(int type)
+{
+  switch (type)
+  {
+    case 1: return 2;    case 2: return 3;    case 3: return 4;    case 4: return 4;
+    case 5: return 8;    case 6: return 6;    case 7: return 5;    case 8: return 3;
+    case 9: return 6;    case 10: return 9;   case 11: return 10;  case 12: return 27;
+    case 13: return 18;  case 14: return 14;  case 15: return 1;   case 16: return 8;
+    case 17: return 20;  case 18: return 15;  case 19: return 13;  case 20: return 9;
+    case 21: return 10;  case 26: return 4;   case 27: return 5;   case 28: return 6;
+    case 29: return 20;  case 36: return 16;  case 37: return 25;  case 92: return 64;
+    case 93: return 125;
+    default: return 0;
+  }
+}
+
+// hexahedra of any order, whose first 8 nodes are the corners
+inline bool is_hexahedron(int type) { return type == 5 || type == 12 || type == 17 || type == 92 || type == 93; }
+
+// the Gmsh corners of a hexahedron are numbered counterclockwise at the bottom and
+// then at the top; this maps to the tensor-product order of unstructured_hex_mesh
+constexpr int hex_corner_order[8] = {0, 1, 3, 2, 4, 5, 7, 6};
+
+template<typename V>
+V read_binary(std::istream& in)
+{
+  V v;
+  in.read(reinterpret_cast<char*>(&v), sizeof(V));
+  return v;
+}
+
+inline void skip_section(std::istream& in, const std::string& name)
+{
+  std::string end = "$End" + name.substr(1), line;
+  while (std::getline(in, line))
+    if (line.compare(0, end.size(), end) == 0) return;
+  throw std::runtime_error("gmsh reader: missing " + end);
+}
+
+inline void expect_end(std::istream& in, const std::string& end)
+{
+  std::string line;
+  while (std::getline(in, line) && line.find_first_not_of(" \r\n\t") == std::string::npos) {}
+  if (line.compare(0, end.size(), end) != 0) throw std::runtime_error("gmsh reader: missing " + end);
+}
+
+}
+
+// Reads the hexahedra of a Gmsh mesh file of format version 4.1, ASCII or binary, and
+// builds the connectivity of an unstructured_hex_mesh. The elements of other types,
+// e.g., the quadrilaterals of the boundary, are skipped, and so are the sections other
+// than $MeshFormat, $Nodes, and $Elements; high-order hexahedra contribute their corners.
+// NOTE: the vertices are numbered in the order of the nodes in the file, not by their tags
+template<typename T>
+unstructured_hex_mesh<T> read_gmsh(const std::string& filename)
+{
+  using namespace gmsh_detail;
+
+  std::ifstream in(filename, std::ios::binary);
+  if (!in) throw std::runtime_error("gmsh reader: cannot open " + filename);
+
+  bool binary = false;
+  bool swap = false;
+  std::vector<T> x, y, z;
+  std::vector<std::size_t> tag_to_vertex;
+  std::vector<std::size_t> cell_vertices;
+  bool has_nodes = false, has_elements = false;
+
+  std::string line;
+  while (std::getline(in, line))
+  {
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    if (line.empty()) continue;
+
+    if (line == "$MeshFormat")
+    {
+      double version;
+      int file_type, data_size;
+      std::getline(in, line);
+      std::istringstream(line) >> version >> file_type >> data_size;
+      if (version < 4.1 || version >= 5.) throw std::runtime_error("gmsh reader: only the format version 4.1 is supported");
+      if (data_size != sizeof(std::size_t)) throw std::runtime_error("gmsh reader: unsupported data size");
+      binary = file_type == 1;
+      if (binary)
+      {
+        int one = read_binary<int>(in);
+        swap = one != 1;
+        if (swap) throw std::runtime_error("gmsh reader: binary files of other endianness are not supported");
+        std::getline(in, line);
+      }
+      expect_end(in, "$EndMeshFormat");
+    }
+    else if (line == "$Nodes")
+    {
+      std::size_t num_blocks, num_nodes, min_tag, max_tag;
+      if (binary)
+      {
+        num_blocks = read_binary<std::size_t>(in);
+        num_nodes = read_binary<std::size_t>(in);
+        min_tag = read_binary<std::size_t>(in);
+        max_tag = read_binary<std::size_t>(in);
+      }
+      else in >> num_blocks >> num_nodes >> min_tag >> max_tag;
+
+      x.reserve(num_nodes);
+      y.reserve(num_nodes);
+      z.reserve(num_nodes);
+      tag_to_vertex.assign(max_tag + 1, unstructured_hex_mesh<T>::invalid_index);
+
+      std::vector<std::size_t> tags;
+      std::vector<double> coords;
+      for (std::size_t b = 0; b < num_blocks; ++b)
+      {
+        int dim, entity, parametric;
+        std::size_t n;
+        if (binary)
+        {
+          dim = read_binary<int>(in);
+          entity = read_binary<int>(in);
+          parametric = read_binary<int>(in);
+          n = read_binary<std::size_t>(in);
+        }
+        else in >> dim >> entity >> parametric >> n;
+
+        // x, y, z, plus u (, v, w) of the parametric nodes
+        int nc = 3 + (parametric ? dim : 0);
+        tags.resize(n);
+        coords.resize(n * nc);
+        if (binary)
+        {
+          in.read(reinterpret_cast<char*>(tags.data()), n * sizeof(std::size_t));
+          in.read(reinterpret_cast<char*>(coords.data()), n * nc * sizeof(double));
+        }
+        else
+        {
+          for (std::size_t i = 0; i < n; ++i) in >> tags[i];
+          for (std::size_t i = 0; i < n * nc; ++i) in >> coords[i];
+        }
+        if (!in) throw std::runtime_error("gmsh reader: corrupted $Nodes section");
+
+        for (std::size_t i = 0; i < n; ++i)
+        {
+          if (tags[i] > max_tag) throw std::runtime_error("gmsh reader: node tag out of range");
+          tag_to_vertex[tags[i]] = x.size();
+          x.push_back(static_cast<T>(coords[i * nc]));
+          y.push_back(static_cast<T>(coords[i * nc + 1]));
+          z.push_back(static_cast<T>(coords[i * nc + 2]));
+        }
+      }
+      expect_end(in, "$EndNodes");
+      has_nodes = true;
+    }
+    else if (line == "$Elements")
+    {
+      if (!has_nodes) throw std::runtime_error("gmsh reader: $Elements before $Nodes");
+
+      std::size_t num_blocks, num_elements, min_tag, max_tag;
+      if (binary)
+      {
+        num_blocks = read_binary<std::size_t>(in);
+        num_elements = read_binary<std::size_t>(in);
+        min_tag = read_binary<std::size_t>(in);
+        max_tag = read_binary<std::size_t>(in);
+      }
+      else in >> num_blocks >> num_elements >> min_tag >> max_tag;
+
+      std::vector<std::size_t> data;
+      for (std::size_t b = 0; b < num_blocks; ++b)
+      {
+        int dim, entity, type;
+        std::size_t n;
+        if (binary)
+        {
+          dim = read_binary<int>(in);
+          entity = read_binary<int>(in);
+          type = read_binary<int>(in);
+          n = read_binary<std::size_t>(in);
+        }
+        else in >> dim >> entity >> type >> n;
+
+        int nn = num_element_nodes(type);
+        if (nn == 0) throw std::runtime_error("gmsh reader: unsupported element type " + std::to_string(type));
+
+        // the element tag followed by the node tags of each element
+        data.resize(n * (nn + 1));
+        if (binary) in.read(reinterpret_cast<char*>(data.data()), data.size() * sizeof(std::size_t));
+        else for (std::size_t i = 0; i < data.size(); ++i) in >> data[i];
+        if (!in) throw std::runtime_error("gmsh reader: corrupted $Elements section");
+
+        if (!is_hexahedron(type)) continue;
+        cell_vertices.reserve(cell_vertices.size() + n * 8);
+        for (std::size_t e = 0; e < n; ++e)
+          for (int k = 0; k < 8; ++k)
+          {
+            std::size_t tag = data[e * (nn + 1) + 1 + hex_corner_order[k]];
+            if (tag >= tag_to_vertex.size() || tag_to_vertex[tag] == unstructured_hex_mesh<T>::invalid_index)
+              throw std::runtime_error("gmsh reader: element references an unknown node");
+            cell_vertices.push_back(tag_to_vertex[tag]);
+          }
+      }
+      expect_end(in, "$EndElements");
+      has_elements = true;
+    }
+    else if (line[0] == '$') skip_section(in, line);
+  }
+
+  if (!has_elements) throw std::runtime_error("gmsh reader: no $Elements section in " + filename);
+
+  return unstructured_hex_mesh<T>(std::move(x), std::move(y), std::move(z), std::move(cell_vertices));
+}
+
+}
+
+#endif
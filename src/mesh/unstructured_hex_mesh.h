@@ -0,0 +1,259 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#ifndef UNSTRUCTURED_HEX_MESH_H
+#define UNSTRUCTURED_HEX_MESH_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <tuple>
+#include <limits>
+#include <utility>
+#include <algorithm>
+
+namespace rdg {
+
+// Unstructured mesh of linear hexahedra. The 8 vertices of a cell are stored in the
+// tensor-product order of the corners of the reference hexahedron, i.e., the corner
+// (a, b, c) in {0, 1}^3 is the vertex a + 2 * b + 4 * c of the cell, and the local faces
+// are numbered as those of reference_hexahedron, i.e., 0: r = -1, 1: r = 1, 2: s = -1,
+// 3: s = 1, 4: t = -1, and 5: t = 1.
+//
+// The element -> face -> neighbor connectivity is stored in CSR arrays indexed by the
+// offsets of the cells, i.e., the entries of the local face f of cell c are at
+// face_offsets()[c] + f. The first cell of a face found in the cell order is its owner
+// (minus side); the other cell, if any, is its neighbor (plus side). The orientation
+// code of a local face describes the parameterization of the face, as seen from the
+// cell, relative to that seen from the owner, see face_node_map().
+template<typename T>
+class unstructured_hex_mesh
+{
+public:
+  using point_type = std::array<T, 3>;
+
+  static constexpr std::size_t invalid_index = std::numeric_limits<std::size_t>::max();
+
+  static constexpr int num_cell_vertices() { return 8; }
+
+  static constexpr int num_cell_faces() { return 6; }
+
+  // cell_vertices are 8 vertex indices per cell in the order described above
+  unstructured_hex_mesh(std::vector<T> x, std::vector<T> y, std::vector<T> z,
+                        std::vector<std::size_t> cell_vertices)
+    : m_x(std::move(x)), m_y(std::move(y)), m_z(std::move(z)), m_cell_vertices(std::move(cell_vertices))
+  {
+    assert(m_x.size() == m_y.size() && m_x.size() == m_z.size());
+    assert(m_cell_vertices.size() % num_cell_vertices() == 0);
+    build_connectivity();
+  }
+
+  std::size_t num_vertices() const { return m_x.size(); }
+
+  std::size_t num_cells() const { return m_cell_vertices.size() / num_cell_vertices(); }
+
+  std::size_t num_faces() const { return m_face_cells.size() / 2; }
+
+  std::size_t num_boundary_faces() const { return m_num_boundary_faces; }
+
+  point_type get_vertex(std::size_t i) const { return {m_x[i], m_y[i], m_z[i]}; }
+
+  std::size_t cell_vertex(std::size_t c, int k) const { return m_cell_vertices[c * num_cell_vertices() + k]; }
+
+  // vertices of the local face f of cell c, in the cyclic order of the corners (0, 0),
+  // (1, 0), (1, 1), and (0, 1) of the face parameterization of reference_hexahedron
+  std::array<std::size_t, 4> face_vertices(std::size_t c, int f) const
+  {
+    const auto& lv = s_face_corners[f];
+    return {cell_vertex(c, lv[0]), cell_vertex(c, lv[1]), cell_vertex(c, lv[2]), cell_vertex(c, lv[3])};
+  }
+
+  // CSR connectivity
+  const std::vector<std::size_t>& face_offsets() const { return m_face_offsets; }
+
+  std::size_t cell_face(std::size_t c, int f) const { return m_faces[m_face_offsets[c] + f]; }
+
+  // the cell across the local face f of cell c, or invalid_index on a boundary
+  std::size_t neighbor(std::size_t c, int f) const { return m_neighbors[m_face_offsets[c] + f]; }
+
+  // the local face of the neighbor across the local face f of cell c
+  int neighbor_face(std::size_t c, int f) const { return m_neighbor_faces[m_face_offsets[c] + f]; }
+
+  int face_orientation(std::size_t c, int f) const { return m_orientations[m_face_offsets[c] + f]; }
+
+  // owner and neighbor (or invalid_index) of face i
+  std::tuple<std::size_t, std::size_t> face_cells(std::size_t i) const
+  { return std::make_tuple(m_face_cells[2 * i], m_face_cells[2 * i + 1]); }
+
+  // the point (a, b), 0 <= a, b < n, of the parameterization of a face with the given
+  // orientation code is the point returned of the parameterization seen from the owner
+  static std::tuple<int, int> face_node_map(int orientation, int n, int a, int b)
+  {
+    assert(orientation >= 0 && orientation < 8);
+    static constexpr int corner[4][2] = {{0, 0}, {1, 0}, {1, 1}, {0, 1}};
+    int r = orientation % 4;
+    bool flip = orientation >= 4;
+    int k1 = flip ? (r + 3) % 4 : (r + 1) % 4;
+    int k3 = flip ? (r + 1) % 4 : (r + 3) % 4;
+    int m = n - 1;
+    return std::make_tuple(m * corner[r][0] + a * (corner[k1][0] - corner[r][0]) + b * (corner[k3][0] - corner[r][0]),
+                           m * corner[r][1] + a * (corner[k1][1] - corner[r][1]) + b * (corner[k3][1] - corner[r][1]));
+  }
+
+private:
+  void build_connectivity();
+
+  // orientation code of the face of corners q relative to the same face of corners p:
+  // q[0] == p[r] and q[1] == p[r + 1] (code r) or q[1] == p[r - 1] (code r + 4)
+  static int orientation_code(const std::array<std::size_t, 4>& p, const std::array<std::size_t, 4>& q)
+  {
+    int r = 0;
+    while (r < 4 && p[r] != q[0]) ++r;
+    assert(r < 4);
+    return q[1] == p[(r + 1) % 4] ? r : r + 4;
+  }
+
+  // symmetric in the vertices, i.e., the same for any order of the corners of a face
+  static std::uint64_t hash(const std::array<std::size_t, 4>& key)
+  {
+    std::uint64_t sum = 0, prod = 1;
+    for (std::size_t v : key)
+    {
+      // splitmix64 of the vertex
+      std::uint64_t z = static_cast<std::uint64_t>(v) + 0x9e3779b97f4a7c15ULL;
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+      z ^= z >> 31;
+      sum += z;
+      prod *= z | 1;
+    }
+    std::uint64_t h = (sum ^ (prod >> 29)) * 0x9e3779b97f4a7c15ULL;
+    return h ^ (h >> 32);
+  }
+
+  static bool same_face(std::array<std::size_t, 4> a, std::array<std::size_t, 4> b)
+  {
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+    return a == b;
+  }
+
+  static constexpr int s_face_corners[6][4] = {{0, 2, 6, 4}, {1, 3, 7, 5}, {0, 1, 5, 4},
+                                               {2, 3, 7, 6}, {0, 1, 3, 2}, {4, 5, 7, 6}};
+
+private:
+  // vertex coordinates
+  std::vector<T> m_x;
+  std::vector<T> m_y;
+  std::vector<T> m_z;
+
+  std::vector<std::size_t> m_cell_vertices;
+
+  // CSR arrays of the local faces of the cells
+  std::vector<std::size_t>  m_face_offsets;
+  std::vector<std::size_t>  m_faces;
+  std::vector<std::size_t>  m_neighbors;
+  std::vector<std::int8_t>  m_neighbor_faces;
+  std::vector<std::int8_t>  m_orientations;
+
+  // owner and neighbor of each face
+  std::vector<std::size_t>  m_face_cells;
+  std::size_t               m_num_boundary_faces;
+};
+
+// Faces are matched by an open-addressing hash table of the local faces keyed by their
+// vertices regardless of their order: the table stores part of the hash and the index of the local face,
+// c * 6 + f, and the vertices are looked up again only when the hashes agree, which keeps
+// the table at 8 bytes per slot and the build at O(number of cells) without any
+// node-based container.
+template<typename T>
+void unstructured_hex_mesh<T>::build_connectivity()
+{
+  const std::size_t nc = num_cells();
+  const std::size_t nlf = nc * num_cell_faces();
+
+  m_face_offsets.resize(nc + 1);
+  for (std::size_t c = 0; c <= nc; ++c) m_face_offsets[c] = c * num_cell_faces();
+  m_faces.assign(nlf, invalid_index);
+  m_neighbors.assign(nlf, invalid_index);
+  m_neighbor_faces.assign(nlf, -1);
+  m_orientations.assign(nlf, 0);
+  m_face_cells.clear();
+  m_face_cells.reserve(nlf + 2 * num_cell_faces());
+
+  // each face enters the table once, by its owner, and there are about half as many
+  // faces as local faces, i.e., the table is at most about half full; a slot packs the
+  // upper 32 bits of the hash and the local face index plus one (0 for an empty slot)
+  assert(nlf < (std::size_t(1) << 32) - 1);
+  std::size_t capacity = 1;
+  while (capacity < nlf + 2 * num_cell_faces()) capacity <<= 1;
+  std::vector<std::uint64_t> table(capacity, 0);
+  const std::size_t mask = capacity - 1;
+
+  for (std::size_t c = 0; c < nc; ++c)
+    for (int f = 0; f < num_cell_faces(); ++f)
+    {
+      auto fv = face_vertices(c, f);
+      std::uint64_t h = hash(fv);
+      std::uint64_t tag = h & 0xffffffff00000000ULL;
+      std::size_t slot = h & mask;
+      while (true)
+      {
+        std::uint64_t entry = table[slot];
+        if (entry == 0)
+        {
+          // first appearance: a new face owned by this cell
+          table[slot] = tag | (c * num_cell_faces() + f + 1);
+          m_faces[m_face_offsets[c] + f] = m_face_cells.size() / 2;
+          m_face_cells.push_back(c);
+          m_face_cells.push_back(invalid_index);
+          break;
+        }
+
+        std::size_t lf = (entry & 0xffffffffULL) - 1;
+        std::size_t oc = lf / num_cell_faces();
+        int of = static_cast<int>(lf % num_cell_faces());
+        if ((entry & 0xffffffff00000000ULL) == tag && m_neighbors[m_face_offsets[oc] + of] == invalid_index &&
+            same_face(fv, face_vertices(oc, of)))
+        {
+          std::size_t face = m_faces[m_face_offsets[oc] + of];
+          m_faces[m_face_offsets[c] + f] = face;
+          m_face_cells[2 * face + 1] = c;
+          m_neighbors[m_face_offsets[c] + f] = oc;
+          m_neighbor_faces[m_face_offsets[c] + f] = static_cast<std::int8_t>(of);
+          m_neighbors[m_face_offsets[oc] + of] = c;
+          m_neighbor_faces[m_face_offsets[oc] + of] = static_cast<std::int8_t>(f);
+          m_orientations[m_face_offsets[c] + f] = static_cast<std::int8_t>(orientation_code(face_vertices(oc, of), fv));
+          break;
+        }
+        slot = (slot + 1) & mask;
+      }
+    }
+
+  m_num_boundary_faces = 0;
+  for (std::size_t i = 0; i < num_faces(); ++i)
+    if (m_face_cells[2 * i + 1] == invalid_index) m_num_boundary_faces++;
+}
+
+}
+
+#endif
@@ -0,0 +1,243 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#ifndef MODAL_BASIS_H
+#define MODAL_BASIS_H
+
+#include <cstddef> // size_t
+#include <vector>
+#include <map>
+#include <mutex>
+#include <memory>
+#include <iterator>
+#include <limits>
+#include <cmath>
+#include <cassert>
+
+#include "const_val.h"
+#include "variable.h"
+#include "dense_matrix.h"
+#include "legendre_polynomials.h"
+#include "gauss_lobatto_quadrature.h"
+
+namespace rdg {
+
+// Transforms between the nodal values at the LGL nodes of reference_segment of a given
+// order and the coefficients of the orthonormal Legendre polynomials
+// P~_j = sqrt((2j + 1) / 2) * P_j, j = 0, ..., order, i.e., the modal coefficients.
+// The Vandermonde matrix V(i, j) = P~_j(r_i) and its inverse are built once per
+// (T, order) and kept in a process-wide table.
+template<typename T>
+class modal_transform
+{
+public:
+  using matrix_type = dense_matrix<T, false>; // row major
+
+  // thread safe; the returned reference stays valid until the program exits
+  static const modal_transform& get(std::size_t order);
+
+  std::size_t order() const { return m_V.size_row() - 1; }
+
+  std::size_t num_nodes() const { return m_V.size_row(); }
+
+  // nodal = V * modal
+  const matrix_type& vandermonde() const { return m_V; }
+
+  // modal = V^{-1} * nodal
+  const matrix_type& inverse_vandermonde() const { return m_invV; }
+
+  // Batched transforms of num_elems elements whose nodal values (or modal coefficients)
+  // are stored consecutively, num_nodes() per element, in a per-component (SoA) array.
+  void nodal_to_modal(const T* nodal, std::size_t num_elems, T* modal) const
+  { transform(m_invV, nodal, num_elems, modal); }
+
+  void modal_to_nodal(const T* modal, std::size_t num_elems, T* nodal) const
+  { transform(m_V, modal, num_elems, nodal); }
+
+private:
+  explicit modal_transform(std::size_t order);
+
+  void transform(const matrix_type& m, const T* in, std::size_t num_elems, T* out) const
+  {
+    assert(in != out);
+    std::size_t n = num_nodes();
+    gemm(const_val<T, 1>, m.view(), const_dense_matrix_view<T, true>(in, 0, n, num_elems, n),
+         const_val<T, 0>, dense_matrix_view<T, true>(out, 0, n, num_elems, n));
+  }
+
+private:
+  matrix_type m_V;
+  matrix_type m_invV;
+};
+
+template<typename T>
+const modal_transform<T>& modal_transform<T>::get(std::size_t order)
+{
+  static std::mutex s_mutex;
+  static std::map<std::size_t, std::unique_ptr<const modal_transform>> s_transforms;
+
+  std::lock_guard<std::mutex> lock(s_mutex);
+  auto& transform = s_transforms[order];
+  if (!transform) transform.reset(new modal_transform(order));
+  return *transform;
+}
+
+template<typename T>
+modal_transform<T>::modal_transform(std::size_t order) : m_V(order + 1, order + 1)
+{
+  assert(order > 0);
+
+  std::vector<T> nodes, weights;
+  gauss_lobatto_quadrature(order + 1, std::back_inserter(nodes), std::back_inserter(weights));
+
+  std::vector<T> vals;
+  for (std::size_t i = 0; i <= order; ++i)
+  {
+    vals.clear();
+    legendre_polynomial_values(order, nodes[i], std::back_inserter(vals));
+    for (std::size_t j = 0; j <= order; ++j)
+      m_V(i, j) = vals[j] / std::sqrt(legendre_polynomial_l2_norm<T>(j));
+  }
+  m_invV = m_V.inverse();
+}
+
+// Modal filter of the nodal values of reference_segment elements, F = V * diag(sigma) * V^{-1},
+// where sigma_k is the damping factor of the kth orthonormal Legendre mode. It is applied
+// element by element to the solution, e.g., between the stages of the Runge-Kutta schemes
+// (see explicit_runge_kutta.h), to stabilize under-resolved computations.
+template<typename T>
+class spectral_filter
+{
+public:
+  using matrix_type = dense_matrix<T, false>; // row major
+
+  // exponential filter sigma_k = exp(-alpha * ((k - Nc) / (N - Nc))^s) for k > Nc and 1 otherwise,
+  // where N is the order; alpha = -ln(machine epsilon) damps the highest mode to round-off
+  static spectral_filter exponential(std::size_t order, std::size_t cutoff, int s,
+                                     T alpha = - std::log(std::numeric_limits<T>::epsilon()));
+
+  // sharp cutoff: the modes above Nc are removed
+  static spectral_filter cutoff(std::size_t order, std::size_t cutoff);
+
+  std::size_t num_nodes() const { return m_sigma.size(); }
+
+  T damping_factor(std::size_t k) const { assert(k < m_sigma.size()); return m_sigma[k]; }
+
+  const matrix_type& matrix() const { return m_F; }
+
+  // in place application to size nodal values (of size / num_nodes() elements)
+  template<typename Itr, typename VART = typename std::iterator_traits<Itr>::value_type>
+  void apply(Itr begin, std::size_t size) const;
+
+  // the same for a stand-alone per-component (SoA) array, batched over all elements
+  void apply_batched(T* data, std::size_t num_elems) const;
+
+private:
+  explicit spectral_filter(std::vector<T>&& sigma);
+
+private:
+  std::vector<T> m_sigma;
+  matrix_type    m_F;
+};
+
+template<typename T>
+spectral_filter<T> spectral_filter<T>::exponential(std::size_t order, std::size_t cutoff, int s, T alpha)
+{
+  assert(cutoff < order && s > 0);
+
+  std::vector<T> sigma(order + 1, const_val<T, 1>);
+  for (std::size_t k = cutoff + 1; k <= order; ++k)
+    sigma[k] = std::exp(- alpha * std::pow(static_cast<T>(k - cutoff) / static_cast<T>(order - cutoff), s));
+  return spectral_filter(std::move(sigma));
+}
+
+template<typename T>
+spectral_filter<T> spectral_filter<T>::cutoff(std::size_t order, std::size_t cutoff)
+{
+  assert(cutoff <= order);
+
+  std::vector<T> sigma(order + 1, const_val<T, 1>);
+  for (std::size_t k = cutoff + 1; k <= order; ++k) sigma[k] = const_val<T, 0>;
+  return spectral_filter(std::move(sigma));
+}
+
+template<typename T>
+spectral_filter<T>::spectral_filter(std::vector<T>&& sigma) : m_sigma(std::move(sigma))
+{
+  const auto& transform = modal_transform<T>::get(m_sigma.size() - 1);
+  matrix_type SinvV = transform.inverse_vandermonde();
+  for (std::size_t k = 0; k < m_sigma.size(); ++k)
+    for (std::size_t j = 0; j < m_sigma.size(); ++j)
+      SinvV(k, j) *= m_sigma[k];
+  m_F = transform.vandermonde() * SinvV;
+}
+
+template<typename T> template<typename Itr, typename VART>
+void spectral_filter<T>::apply(Itr begin, std::size_t size) const
+{
+  std::size_t n = num_nodes();
+  assert(size % n == 0);
+
+  std::vector<VART> in(n), out(n);
+  for (std::size_t e = 0; e < size / n; ++e, begin += n)
+  {
+    for (std::size_t i = 0; i < n; ++i) in[i] = VART(*(begin + i));
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      out[i] = initialize_variable_to_zero<VART>();
+      for (std::size_t j = 0; j < n; ++j) out[i] += m_F(i, j) * in[j];
+    }
+    for (std::size_t i = 0; i < n; ++i) *(begin + i) = out[i];
+  }
+}
+
+template<typename T>
+void spectral_filter<T>::apply_batched(T* data, std::size_t num_elems) const
+{
+  std::size_t n = num_nodes();
+  std::vector<T> in(data, data + n * num_elems);
+  gemm(const_val<T, 1>, m_F.view(), const_dense_matrix_view<T, true>(in.data(), 0, n, num_elems, n),
+       const_val<T, 0>, dense_matrix_view<T, true>(data, 0, n, num_elems, n));
+}
+
+// Smoothness indicator of Persson and Peraire of the nodal values of an element of the
+// given order, s = log10(c_N^2 / sum_k c_k^2), where c_k are the modal coefficients, i.e.,
+// the fraction of the L2 norm in the highest mode. The coefficients of a smooth solution
+// decay like 1/N^2 or faster, so s <= -4 * log10(N) roughly where the solution is
+// resolved, while s is close to 0 at discontinuities. Returns lowest() for zeros.
+template<typename T>
+T smoothness_indicator(std::size_t order, const T* nodal)
+{
+  const auto& invV = modal_transform<T>::get(order).inverse_vandermonde();
+  T total = const_val<T, 0>, highest = const_val<T, 0>;
+  for (std::size_t k = 0; k <= order; ++k)
+  {
+    T c = const_val<T, 0>;
+    for (std::size_t j = 0; j <= order; ++j) c += invV(k, j) * nodal[j];
+    total += c * c;
+    if (k == order) highest = c * c;
+  }
+  if (!(highest > const_val<T, 0>)) return std::numeric_limits<T>::lowest();
+  return std::log10(highest / total);
+}
+
+}
+
+#endif
@@ -0,0 +1,106 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#ifndef MPI_HALO_EXCHANGE_1D_H
+#define MPI_HALO_EXCHANGE_1D_H
+
+#include <cstddef>
+#include <array>
+#include <utility>
+
+#include <mpi.h>
+#include <boost/tuple/tuple.hpp>
+
+namespace rdg {
+
+template<typename T> MPI_Datatype mpi_datatype();
+
+template<> inline MPI_Datatype mpi_datatype<float>() { return MPI_FLOAT; }
+
+template<> inline MPI_Datatype mpi_datatype<double>() { return MPI_DOUBLE; }
+
+// Halo exchange (see halo_exchange_1d.h) of the ranks of comm that own contiguous ranges
+// of the cells in the rank order, i.e., the neighbors of rank r are r - 1 and r + 1, by
+// non-blocking point-to-point messages of the traces of NC components of type T, e.g.,
+// the conservative variables as boost::tuple. The first and the last ranks have no
+// neighbor beyond the ends of the mesh and exchange nothing there.
+template<typename T, std::size_t NC>
+class mpi_halo_exchange_1d
+{
+public:
+  explicit mpi_halo_exchange_1d(MPI_Comm comm) : m_comm(comm)
+  {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    m_left = rank > 0 ? rank - 1 : MPI_PROC_NULL;
+    m_right = rank + 1 < size ? rank + 1 : MPI_PROC_NULL;
+  }
+
+  bool has_left() const { return m_left != MPI_PROC_NULL; }
+
+  bool has_right() const { return m_right != MPI_PROC_NULL; }
+
+  template<typename V>
+  void start(const V& first, const V& last)
+  {
+    pack(first, m_send.data(), std::make_index_sequence<NC>());
+    pack(last, m_send.data() + NC, std::make_index_sequence<NC>());
+
+    // the trace going right is received from the left, and vice versa
+    MPI_Irecv(m_recv.data(), NC, mpi_datatype<T>(), m_left, s_rightward, m_comm, &m_requests[0]);
+    MPI_Irecv(m_recv.data() + NC, NC, mpi_datatype<T>(), m_right, s_leftward, m_comm, &m_requests[1]);
+    MPI_Isend(m_send.data(), NC, mpi_datatype<T>(), m_left, s_leftward, m_comm, &m_requests[2]);
+    MPI_Isend(m_send.data() + NC, NC, mpi_datatype<T>(), m_right, s_rightward, m_comm, &m_requests[3]);
+  }
+
+  template<typename V>
+  void finish(V& left, V& right)
+  {
+    MPI_Waitall(4, m_requests.data(), MPI_STATUSES_IGNORE);
+    if (has_left()) unpack(m_recv.data(), left, std::make_index_sequence<NC>());
+    if (has_right()) unpack(m_recv.data() + NC, right, std::make_index_sequence<NC>());
+  }
+
+private:
+  template<typename V, std::size_t... Is>
+  static void pack(const V& v, T* buffer, std::index_sequence<Is...>)
+  { ((buffer[Is] = boost::get<Is>(v)), ...); }
+
+  template<typename V, std::size_t... Is>
+  static void unpack(const T* buffer, V& v, std::index_sequence<Is...>)
+  { ((boost::get<Is>(v) = buffer[Is]), ...); }
+
+private:
+  static constexpr int s_rightward = 101;
+  static constexpr int s_leftward = 102;
+
+  MPI_Comm m_comm;
+  int      m_left;
+  int      m_right;
+
+  std::array<T, 2 * NC>      m_send;
+  std::array<T, 2 * NC>      m_recv;
+  std::array<MPI_Request, 4> m_requests;
+};
+
+}
+
+#endif
@@ -0,0 +1,133 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#ifndef REFERENCE_HEXAHEDRON_H
+#define REFERENCE_HEXAHEDRON_H
+
+#include <cstddef> // size_t
+#include <vector>
+#include <array>
+#include <cassert>
+
+#include "dense_matrix.h"
+#include "reference_segment.h"
+#include "sum_factorization.h"
+
+namespace rdg {
+
+// Tensor product of three reference_segment's of the same order on [-1, 1]^3. The node
+// (i, j, k), i.e., at (r_i, s_j, t_k), is numbered i + N * (j + N * k) where N is the
+// number of nodes of the 1D element. Faces are numbered 0: r = -1, 1: r = 1, 2: s = -1,
+// 3: s = 1, 4: t = -1, and 5: t = 1, and the nodes of each face (a, b) are numbered
+// a + N * b where a and b run along the two free coordinates in the order r, s, t.
+template<typename T>
+class reference_hexahedron
+{
+public:
+  using matrix_type = typename reference_segment<T>::matrix_type;
+
+  explicit reference_hexahedron(std::size_t order);
+
+  std::size_t order() const { return m_segment.num_nodes() - 1; }
+
+  std::size_t num_nodes_1d() const { return m_segment.num_nodes(); }
+
+  std::size_t num_nodes() const { return num_nodes_1d() * num_nodes_1d() * num_nodes_1d(); }
+
+  static constexpr std::size_t num_faces() { return 6; }
+
+  std::size_t num_face_nodes() const { return num_nodes_1d() * num_nodes_1d(); }
+
+  std::size_t node_index(std::size_t i, std::size_t j, std::size_t k) const
+  { return i + num_nodes_1d() * (j + num_nodes_1d() * k); }
+
+  T node_position_r(std::size_t n) const { return m_segment.node_position(n % num_nodes_1d()); }
+
+  T node_position_s(std::size_t n) const { return m_segment.node_position(n / num_nodes_1d() % num_nodes_1d()); }
+
+  T node_position_t(std::size_t n) const { return m_segment.node_position(n / (num_nodes_1d() * num_nodes_1d())); }
+
+  // diagonal of the (diagonal) mass matrix, i.e., the tensor-product quadrature weights
+  T weight(std::size_t n) const
+  {
+    std::size_t N = num_nodes_1d();
+    return m_weights_1d[n % N] * m_weights_1d[n / N % N] * m_weights_1d[n / (N * N)];
+  }
+
+  const reference_segment<T>& segment() const { return m_segment; }
+
+  const matrix_type& derivative_matrix_1d() const { return m_D; }
+
+  // volume node indices of the nodes of face f
+  const std::vector<std::size_t>& face_nodes(std::size_t f) const { assert(f < num_faces()); return m_face_nodes[f]; }
+
+  // sum-factorized application of the 1D operator A along the r, s, or t axis
+  template<typename InputItr, typename OutputItr>
+  void apply_r(const matrix_type& A, InputItr in, OutputItr out) const
+  { apply_along_axis(A, in, 1, num_nodes_1d() * num_nodes_1d(), out); }
+
+  template<typename InputItr, typename OutputItr>
+  void apply_s(const matrix_type& A, InputItr in, OutputItr out) const
+  { apply_along_axis(A, in, num_nodes_1d(), num_nodes_1d(), out); }
+
+  template<typename InputItr, typename OutputItr>
+  void apply_t(const matrix_type& A, InputItr in, OutputItr out) const
+  { apply_along_axis(A, in, num_nodes_1d() * num_nodes_1d(), 1, out); }
+
+  // derivatives of the nodal data with respect to r, s, and t, in O(N^4)
+  template<typename InputItr, typename OutputItr>
+  void derivative_r(InputItr in, OutputItr out) const { apply_r(m_D, in, out); }
+
+  template<typename InputItr, typename OutputItr>
+  void derivative_s(InputItr in, OutputItr out) const { apply_s(m_D, in, out); }
+
+  template<typename InputItr, typename OutputItr>
+  void derivative_t(InputItr in, OutputItr out) const { apply_t(m_D, in, out); }
+
+private:
+  reference_segment<T>                      m_segment;
+  matrix_type                               m_D;
+  std::vector<T>                            m_weights_1d;
+  std::array<std::vector<std::size_t>, 6>   m_face_nodes;
+};
+
+template<typename T>
+reference_hexahedron<T>::reference_hexahedron(std::size_t order)
+  : m_segment(order), m_D(m_segment.derivative_matrix_wrt_r())
+{
+  std::size_t n = num_nodes_1d();
+  auto M = m_segment.mass_matrix();
+  for (std::size_t i = 0; i < n; ++i) m_weights_1d.push_back(M(i, i));
+
+  for (std::size_t b = 0; b < n; ++b)
+    for (std::size_t a = 0; a < n; ++a)
+    {
+      m_face_nodes[0].push_back(node_index(0, a, b));
+      m_face_nodes[1].push_back(node_index(n - 1, a, b));
+      m_face_nodes[2].push_back(node_index(a, 0, b));
+      m_face_nodes[3].push_back(node_index(a, n - 1, b));
+      m_face_nodes[4].push_back(node_index(a, b, 0));
+      m_face_nodes[5].push_back(node_index(a, b, n - 1));
+    }
+}
+
+}
+
+#endif
@@ -0,0 +1,194 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#ifndef REFERENCE_SEGMENT_TRAITS_H
+#define REFERENCE_SEGMENT_TRAITS_H
+
+#include <cstddef> // size_t
+#include <array>
+#include <utility>
+#include <type_traits>
+
+namespace rdg {
+
+// constexpr helpers to generate the tables at compile time -- std::cos, std::abs, etc.
+// are not constexpr, and the tables of both double and long double are computed in
+// long double and then rounded to the target type
+namespace lgl_constexpr {
+
+using real = long double;
+
+constexpr real abs(real x) { return x < 0 ? -x : x; }
+
+constexpr real pi = 3.141592653589793238462643383279502884L;
+
+// accurate enough for x in [0, pi], which is all that is needed here
+constexpr real cos(real x)
+{
+  real term = 1, sum = 1;
+  for (int k = 1; k < 40; ++k)
+  {
+    term *= - x * x / static_cast<real>((2 * k - 1) * (2 * k));
+    sum += term;
+  }
+  return sum;
+}
+
+// Legendre polynomial of degree n at x and its first two derivatives at x, |x| < 1
+constexpr void legendre(int n, real x, real& p, real& dp, real& ddp)
+{
+  real p_prev = 1;
+  p = x;
+  for (int i = 1; i < n; ++i)
+  {
+    real p_next = (static_cast<real>(2 * i + 1) * x * p - static_cast<real>(i) * p_prev) / static_cast<real>(i + 1);
+    p_prev = p;
+    p = p_next;
+  }
+  dp = static_cast<real>(n) * (x * p - p_prev) / (x * x - 1);
+  ddp = (2 * x * dp - static_cast<real>(n * (n + 1)) * p) / (1 - x * x);
+}
+
+template<std::size_t N> // number of nodes
+struct lgl_data
+{
+  std::array<real, N>     nodes{};
+  std::array<real, N>     weights{};
+  std::array<real, N * N> D{}; // row major, D(i, j) = l_j'(x_i)
+};
+
+// the same algorithm as gauss_lobatto_table, plus the derivative matrix from the
+// barycentric weights, with the diagonal by the negative sum trick
+template<std::size_t N>
+constexpr lgl_data<N> make_lgl_data()
+{
+  static_assert(N >= 2);
+
+  constexpr int n = static_cast<int>(N) - 1;
+  constexpr real nn1 = static_cast<real>(n * (n + 1));
+
+  lgl_data<N> data;
+  data.nodes[0] = -1;
+  data.nodes[n] = 1;
+  data.weights[0] = data.weights[n] = 2 / nn1;
+  for (int j = 1; j <= n / 2; ++j)
+  {
+    real x = 0, p = 0, dp = 0, ddp = 0;
+    if (2 * j != n)
+    {
+      x = - cos(pi * static_cast<real>(j) / static_cast<real>(n));
+      for (int iter = 0; iter < 100; ++iter)
+      {
+        legendre(n, x, p, dp, ddp);
+        real dx = dp / ddp;
+        x -= dx;
+        if (abs(dx) <= 1.e-19L) break;
+      }
+    }
+    legendre(n, x, p, dp, ddp);
+    data.nodes[j] = x;
+    data.nodes[n - j] = -x;
+    data.weights[j] = data.weights[n - j] = 2 / (nn1 * p * p);
+  }
+
+  std::array<real, N> bw{};
+  for (std::size_t i = 0; i < N; ++i)
+  {
+    bw[i] = 1;
+    for (std::size_t k = 0; k < N; ++k)
+      if (k != i) bw[i] *= data.nodes[i] - data.nodes[k];
+    bw[i] = 1 / bw[i];
+  }
+  for (std::size_t i = 0; i < N; ++i)
+  {
+    real diag = 0;
+    for (std::size_t j = 0; j < N; ++j)
+      if (j != i)
+      {
+        data.D[i * N + j] = bw[j] / bw[i] / (data.nodes[i] - data.nodes[j]);
+        diag -= data.D[i * N + j];
+      }
+    data.D[i * N + i] = diag;
+  }
+  return data;
+}
+
+template<typename T, std::size_t M>
+constexpr std::array<T, M> cast_array(const std::array<real, M>& a)
+{
+  std::array<T, M> result{};
+  for (std::size_t i = 0; i < M; ++i) result[i] = static_cast<T>(a[i]);
+  return result;
+}
+
+}
+
+// Compile-time Legendre-Gauss-Lobatto (LGL) nodes, quadrature weights and derivative
+// matrix of the reference segment of order ORDER, i.e., the same data as those of
+// reference_segment<T>(ORDER) but as constexpr tables, so that kernels of a fixed
+// order can inline them as immediates and the compiler can constant-fold them.
+template<typename T, int ORDER>
+struct reference_segment_traits
+{
+  static_assert(std::is_floating_point_v<T>, "reference_segment_traits requires a floating point type");
+  static_assert(ORDER >= 1 && ORDER <= 16, "reference_segment_traits is provided for orders 1 to 16");
+
+  static constexpr int order = ORDER;
+
+  static constexpr std::size_t num_nodes() { return ORDER + 1; }
+
+private:
+  static constexpr auto s_data = lgl_constexpr::make_lgl_data<ORDER + 1>();
+
+public:
+  static constexpr std::array<T, ORDER + 1> nodes = lgl_constexpr::cast_array<T>(s_data.nodes);
+
+  static constexpr std::array<T, ORDER + 1> weights = lgl_constexpr::cast_array<T>(s_data.weights);
+
+  static constexpr std::array<T, (ORDER + 1) * (ORDER + 1)> derivative_matrix = lgl_constexpr::cast_array<T>(s_data.D);
+
+  static constexpr T node_position(std::size_t i) { return nodes[i]; }
+
+  static constexpr T weight(std::size_t i) { return weights[i]; }
+
+  // D(i, j) = derivative of the jth basis polynomial at the ith node
+  static constexpr T derivative(std::size_t i, std::size_t j) { return derivative_matrix[i * (ORDER + 1) + j]; }
+};
+
+// maximum order for which the fixed order kernels are instantiated
+constexpr int max_fixed_order = 16;
+
+namespace detail {
+
+template<typename F, int... Is>
+bool dispatch_fixed_order_impl(int order, F& f, std::integer_sequence<int, Is...>)
+{ return ((order == Is + 1 ? (f(std::integral_constant<int, Is + 1>()), true) : false) || ...); }
+
+}
+
+// Calls f(std::integral_constant<int, order>()) if 1 <= order <= MAX_ORDER and returns
+// true; returns false otherwise so that the caller can fall back to the run time order.
+template<int MAX_ORDER = max_fixed_order, typename F>
+bool dispatch_fixed_order(int order, F&& f)
+{ return detail::dispatch_fixed_order_impl(order, f, std::make_integer_sequence<int, MAX_ORDER>()); }
+
+}
+
+#endif
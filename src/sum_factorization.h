@@ -0,0 +1,66 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#ifndef SUM_FACTORIZATION_H
+#define SUM_FACTORIZATION_H
+
+#include <cstddef> // size_t
+#include <iterator>
+#include <cassert>
+
+#include "variable.h"
+
+namespace rdg {
+
+// Applies the 1D operator A (m x n) along one axis of the tensor-product nodal data in,
+// laid out as [num_after][n][num_before] with the first index slowest, and writes the
+// result, laid out as [num_after][m][num_before], to out. E.g., with the node (i, j, k)
+// of a hexahedron at i + N * (j + N * k), num_before = 1, N, N * N and num_after = N * N,
+// N, 1 for the r, s, and t axes respectively. This costs O(m * n * num_before * num_after),
+// i.e., O(N^{d+1}) per element in d dimensions for square A, instead of the O(N^{2d}) of
+// the multiplication by the full (Kronecker product) matrix.
+//
+// The values can be variables, e.g., boost::tuple, as long as the operators of
+// scalar * variable and variable += variable are defined (see variable.h).
+template<typename MATRIX, typename InputItr, typename OutputItr,
+         typename V = typename std::iterator_traits<OutputItr>::value_type>
+void apply_along_axis(const MATRIX& A, InputItr in, std::size_t num_before, std::size_t num_after, OutputItr out)
+{
+  const std::size_t m = A.size_row();
+  const std::size_t n = A.size_col();
+
+  for (std::size_t a = 0; a < num_after; ++a)
+  {
+    InputItr in_a = in + a * n * num_before;
+    OutputItr out_a = out + a * m * num_before;
+    for (std::size_t b = 0; b < m; ++b)
+      for (std::size_t p = 0; p < num_before; ++p)
+      {
+        V v = initialize_variable_to_zero<V>();
+        for (std::size_t k = 0; k < n; ++k)
+          v += A(b, k) * V(*(in_a + k * num_before + p));
+        *(out_a + b * num_before + p) = v;
+      }
+  }
+}
+
+}
+
+#endif
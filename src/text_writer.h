@@ -0,0 +1,236 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#ifndef TEXT_WRITER_H
+#define TEXT_WRITER_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <tuple>
+#include <charconv>
+#include <fstream>
+#include <stdexcept>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <algorithm>
+
+#include "default_init_allocator.h"
+#include "execution_space.h"
+
+namespace rdg {
+
+// the text of the numbers: the shortest text that reads back to the same value if the
+// precision is negative, or else the given precision of the format as printf() does it,
+// e.g., {std::chars_format::general, 15} for what an ostream of precision 15 writes
+struct text_format
+{
+  std::chars_format format    = std::chars_format::general;
+  int               precision = -1;
+};
+
+namespace detail {
+
+using char_buffer = std::vector<char, default_init_allocator<char>>;
+
+// an upper bound of the length of the text of a number of type T
+template<typename T>
+std::size_t max_number_chars(const text_format& f)
+{
+  if constexpr (std::is_integral_v<T>) return 24;
+  else
+  {
+    std::size_t digits = std::max(f.precision, 17);
+    if (f.format == std::chars_format::fixed) digits += std::numeric_limits<T>::max_exponent10 + 1;
+    return digits + 16;
+  }
+}
+
+template<typename T>
+char* format_number(char* first, char* last, T value, const text_format& f)
+{
+  std::to_chars_result r;
+  if constexpr (std::is_integral_v<T>) r = std::to_chars(first, last, value);
+  else if (f.precision < 0) r = std::to_chars(first, last, value, f.format);
+  else r = std::to_chars(first, last, value, f.format, f.precision);
+  assert(r.ec == std::errc());
+  return r.ptr;
+}
+
+template<typename T>
+void append_number(char_buffer& out, T value, const text_format& f)
+{
+  std::size_t size = out.size();
+  out.resize(size + max_number_chars<T>(f));
+  out.resize(format_number(out.data() + size, out.data() + out.size(), value, f) - out.data());
+}
+
+}
+
+// Text output of numbers without the locales, virtual calls and flushes of the ostreams:
+// the numbers are formatted by std::to_chars() into a large buffer that is written to
+// the file in big chunks. write_columns() writes the rows of the columns of values, e.g.,
+// "x rho" for all the nodes, formatting blocks of rows in parallel on an execution space
+// and writing them in order, so the file is the same on any number of threads.
+//
+// NOTE: The file is written when the buffer is full and by flush() or close(), which throw
+// NOTE: std::runtime_error if the file cannot be written; the destructor writes what is
+// NOTE: left without throwing.
+class text_writer
+{
+public:
+  explicit text_writer(const std::string& file_name, text_format format = text_format(),
+                       std::size_t buffer_size = std::size_t(1) << 22)
+    : m_name(file_name), m_file(file_name, std::ios::binary), m_format(format),
+      m_capacity(std::max<std::size_t>(buffer_size, 4096))
+  {
+    if (!m_file) throw std::runtime_error("cannot open " + file_name);
+    m_buffer.reserve(m_capacity);
+  }
+
+  ~text_writer()
+  {
+    try { close(); }
+    catch (...) {}
+  }
+
+  text_writer(const text_writer&) = delete;
+  text_writer& operator=(const text_writer&) = delete;
+
+  const text_format& format() const { return m_format; }
+
+  void set_format(const text_format& format) { m_format = format; }
+
+  text_writer& write_text(std::string_view text)
+  {
+    if (m_buffer.size() + text.size() > m_capacity) flush();
+    if (text.size() > m_capacity) write_to_file(text.data(), text.size());
+    else m_buffer.insert(m_buffer.end(), text.begin(), text.end());
+    return *this;
+  }
+
+  text_writer& write_char(char c)
+  {
+    if (m_buffer.size() == m_capacity) flush();
+    m_buffer.push_back(c);
+    return *this;
+  }
+
+  template<typename T>
+  text_writer& write_number(T value)
+  {
+    static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>, "not a number");
+    if (m_buffer.size() + detail::max_number_chars<T>(m_format) > m_capacity) flush();
+    detail::append_number(m_buffer, value, m_format);
+    return *this;
+  }
+
+  // the rows i in [0, n) of the values columns(i)..., separated by the separator and each
+  // ended by a new line; the columns are the callables of the row index that return the
+  // numbers, e.g., [&](std::size_t i) { return x[i]; }
+  template<typename Space, typename... Columns>
+  void write_columns(const Space& space, std::size_t n, std::string_view separator, Columns... columns);
+
+  void flush()
+  {
+    if (m_buffer.empty()) return;
+    write_to_file(m_buffer.data(), m_buffer.size());
+    m_buffer.clear();
+  }
+
+  void close()
+  {
+    if (!m_file.is_open()) return;
+    flush();
+    m_file.close();
+    if (!m_file) throw std::runtime_error("cannot write " + m_name);
+  }
+
+  // number of the bytes written so far, including those still in the buffer
+  std::uint64_t bytes_written() const { return m_written + m_buffer.size(); }
+
+private:
+  void write_to_file(const char* data, std::size_t size)
+  {
+    m_file.write(data, static_cast<std::streamsize>(size));
+    if (!m_file) throw std::runtime_error("cannot write " + m_name);
+    m_written += size;
+  }
+
+private:
+  std::string         m_name;
+  std::ofstream       m_file;
+  text_format         m_format;
+  std::size_t         m_capacity;
+  detail::char_buffer m_buffer;
+  std::uint64_t       m_written = 0;
+
+  // the text of the blocks of rows being formatted in parallel, reused between calls
+  std::vector<detail::char_buffer> m_blocks;
+};
+
+template<typename Space, typename... Columns>
+void text_writer::write_columns(const Space& space, std::size_t n, std::string_view separator, Columns... columns)
+{
+  static_assert(sizeof...(Columns) > 0, "no columns");
+  constexpr std::size_t block_rows = 1 << 14;
+
+  // a few blocks for each thread at a time, so the memory taken stays bounded
+  std::size_t num_blocks = (n + block_rows - 1) / block_rows;
+  std::size_t batch = std::min<std::size_t>(num_blocks, 4 * std::max(space.concurrency(), 1u));
+  if (m_blocks.size() < batch) m_blocks.resize(batch);
+
+  auto cols = std::make_tuple(columns...);
+  for (std::size_t first = 0; first < num_blocks; first += batch)
+  {
+    std::size_t count = std::min(batch, num_blocks - first);
+    parallel_for(space, count,
+                 [](std::size_t) { return static_cast<double>(block_rows * sizeof...(Columns)); },
+                 [&](std::size_t begin, std::size_t end)
+    {
+      for (std::size_t b = begin; b < end; ++b)
+      {
+        detail::char_buffer& out = m_blocks[b];
+        out.clear();
+        std::size_t row_end = std::min(n, (first + b + 1) * block_rows);
+        for (std::size_t i = (first + b) * block_rows; i < row_end; ++i)
+        {
+          std::size_t k = 0;
+          std::apply([&](const auto&... column) {
+            ((k++ > 0 ? (void)out.insert(out.end(), separator.begin(), separator.end()) : (void)0,
+              detail::append_number(out, column(i), m_format)), ...);
+          }, cols);
+          out.push_back('\n');
+        }
+      }
+    });
+    for (std::size_t b = 0; b < count; ++b)
+      write_text(std::string_view(m_blocks[b].data(), m_blocks[b].size()));
+  }
+}
+
+}
+
+#endif
@@ -0,0 +1,134 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#ifndef THREAD_AFFINITY_H
+#define THREAD_AFFINITY_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace rdg {
+
+// placement of the threads of a pool on the CPUs: none leaves it to the operating system,
+// compact fills the CPUs of one NUMA node before the next one, and scatter deals the
+// threads round-robin to the NUMA nodes, i.e., the most memory bandwidth for few threads
+enum class thread_affinity { none, compact, scatter };
+
+// "compact", "scatter", or anything else for none
+inline thread_affinity thread_affinity_from_string(const std::string& s)
+{
+  if (s == "compact") return thread_affinity::compact;
+  if (s == "scatter") return thread_affinity::scatter;
+  return thread_affinity::none;
+}
+
+// CPUs of a list in the format of sysfs and of taskset, e.g., "0-3,8,10-11"
+inline std::vector<int> parse_cpu_list(const std::string& list)
+{
+  std::vector<int> cpus;
+  std::stringstream ss(list);
+  std::string range;
+  while (std::getline(ss, range, ','))
+  {
+    if (range.find_first_of("0123456789") == std::string::npos) continue;
+    std::size_t dash = range.find('-');
+    int first = std::stoi(range.substr(0, dash));
+    int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+    for (int c = first; c <= last; ++c) cpus.push_back(c);
+  }
+  return cpus;
+}
+
+// CPUs of each NUMA node from sysfs; one node of the online CPUs if there is no NUMA
+// information, e.g., on other operating systems than Linux
+inline std::vector<std::vector<int>> numa_node_cpus()
+{
+  std::vector<std::vector<int>> nodes;
+  for (int n = 0; ; ++n)
+  {
+    std::ifstream file("/sys/devices/system/node/node" + std::to_string(n) + "/cpulist");
+    if (!file) break;
+    std::string list;
+    std::getline(file, list);
+    std::vector<int> cpus = parse_cpu_list(list);
+    if (!cpus.empty()) nodes.push_back(std::move(cpus));
+  }
+  if (nodes.empty())
+  {
+    std::ifstream file("/sys/devices/system/cpu/online");
+    std::string list;
+    if (file) std::getline(file, list);
+    std::vector<int> cpus = parse_cpu_list(list);
+    if (cpus.empty())
+      for (unsigned c = 0; c < std::max(std::thread::hardware_concurrency(), 1u); ++c) cpus.push_back(c);
+    nodes.push_back(std::move(cpus));
+  }
+  return nodes;
+}
+
+// the CPU of each of num_threads threads given the CPUs of the NUMA nodes; the threads
+// wrap around if there are more threads than CPUs
+inline std::vector<int> affinity_cpus(thread_affinity affinity, unsigned num_threads,
+                                      const std::vector<std::vector<int>>& nodes)
+{
+  std::vector<int> order;
+  if (affinity == thread_affinity::compact)
+    for (const auto& node : nodes) order.insert(order.end(), node.begin(), node.end());
+  else if (affinity == thread_affinity::scatter)
+  {
+    std::size_t max_size = 0;
+    for (const auto& node : nodes) max_size = std::max(max_size, node.size());
+    for (std::size_t k = 0; k < max_size; ++k)
+      for (const auto& node : nodes)
+        if (k < node.size()) order.push_back(node[k]);
+  }
+  if (order.empty()) return std::vector<int>();
+
+  std::vector<int> cpus(num_threads);
+  for (unsigned t = 0; t < num_threads; ++t) cpus[t] = order[t % order.size()];
+  return cpus;
+}
+
+// pins the calling thread to the CPU; returns false if it is not supported or failed
+inline bool pin_this_thread(int cpu)
+{
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+  return false;
+#endif
+}
+
+}
+
+#endif
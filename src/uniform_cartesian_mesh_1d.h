@@ -49,6 +49,13 @@ public:
   std::tuple<point_type, point_type> get_cell(std::size_t i) const
   { return std::make_tuple(m_x0 + i * m_delta, m_x0 + (i + 1) * m_delta); }
 
+  // geometry of the cells, the same for all cells (see also cartesian_mesh_1d)
+  T J(std::size_t i) const { return m_delta / static_cast<T>(2); }
+
+  T inv_J(std::size_t i) const { return static_cast<T>(2) / m_delta; }
+
+  T min_cell_size() const { return m_delta; }
+
 private:
   T m_x0;
   T m_delta;
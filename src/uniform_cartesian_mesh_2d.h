@@ -0,0 +1,152 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#ifndef UNIFORM_CARTESIAN_MESH_2D_H
+#define UNIFORM_CARTESIAN_MESH_2D_H
+
+#include <cassert>
+#include <cstddef>
+#include <tuple>
+#include <limits>
+#include <algorithm>
+
+namespace rdg {
+
+// Structured mesh of nx * ny equal rectangles on [x0, x1] x [y0, y1], optionally
+// periodic in x and/or y. The cell (i, j) is numbered i + nx * j. The local faces of
+// a cell are numbered as those of reference_quadrilateral, i.e., 0: x = x_left,
+// 1: x = x_right, 2: y = y_bottom, and 3: y = y_top. The faces normal to x are
+// numbered first, i + nfx * j where nfx = nx (periodic) or nx + 1, followed by the
+// faces normal to y, num_x_faces() + i + nx * j. Each face has a minus cell on its
+// lower side and a plus cell on its upper side along the face normal; on a
+// non-periodic boundary the missing cell is invalid_index.
+template<typename T>
+class uniform_cartesian_mesh_2d
+{
+public:
+  using point_type = std::tuple<T, T>;
+
+  static constexpr std::size_t invalid_index = std::numeric_limits<std::size_t>::max();
+
+  uniform_cartesian_mesh_2d(T x0, T x1, std::size_t nx, T y0, T y1, std::size_t ny,
+                            bool periodic_x = false, bool periodic_y = false)
+    : m_x0(x0), m_y0(y0), m_nx(nx), m_ny(ny), m_periodic_x(periodic_x), m_periodic_y(periodic_y)
+  {
+    assert(x0 < x1 && y0 < y1 && nx > 0 && ny > 0);
+    m_dx = (x1 - x0) / static_cast<T>(nx);
+    m_dy = (y1 - y0) / static_cast<T>(ny);
+  }
+
+  std::size_t num_cells_x() const { return m_nx; }
+
+  std::size_t num_cells_y() const { return m_ny; }
+
+  std::size_t num_cells() const { return m_nx * m_ny; }
+
+  std::size_t num_x_faces() const { return (m_periodic_x ? m_nx : m_nx + 1) * m_ny; }
+
+  std::size_t num_y_faces() const { return m_nx * (m_periodic_y ? m_ny : m_ny + 1); }
+
+  std::size_t num_faces() const { return num_x_faces() + num_y_faces(); }
+
+  std::size_t cell_index(std::size_t i, std::size_t j) const { return i + m_nx * j; }
+
+  point_type get_vertex(std::size_t i, std::size_t j) const
+  { return std::make_tuple(m_x0 + i * m_dx, m_y0 + j * m_dy); }
+
+  // lower-left and upper-right corners of the cell
+  std::tuple<point_type, point_type> get_cell(std::size_t c) const
+  {
+    std::size_t i = c % m_nx, j = c / m_nx;
+    return std::make_tuple(get_vertex(i, j), get_vertex(i + 1, j + 1));
+  }
+
+  // global face of the local face f of cell c
+  std::size_t cell_face(std::size_t c, int f) const
+  {
+    assert(c < num_cells() && f >= 0 && f < 4);
+    std::size_t i = c % m_nx, j = c / m_nx;
+    std::size_t nfx = m_periodic_x ? m_nx : m_nx + 1;
+    switch (f)
+    {
+      case 0: return i + nfx * j;
+      case 1: return (m_periodic_x && i == m_nx - 1 ? 0 : i + 1) + nfx * j;
+      case 2: return num_x_faces() + i + m_nx * j;
+      default: return num_x_faces() + i + m_nx * (m_periodic_y && j == m_ny - 1 ? 0 : j + 1);
+    }
+  }
+
+  // minus (lower) and plus (upper) cells of face f
+  std::tuple<std::size_t, std::size_t> face_cells(std::size_t f) const
+  {
+    assert(f < num_faces());
+    if (f < num_x_faces())
+    {
+      std::size_t nfx = m_periodic_x ? m_nx : m_nx + 1;
+      std::size_t i = f % nfx, j = f / nfx;
+      if (m_periodic_x) return std::make_tuple(cell_index(i == 0 ? m_nx - 1 : i - 1, j), cell_index(i, j));
+      return std::make_tuple(i == 0 ? invalid_index : cell_index(i - 1, j),
+                             i == m_nx ? invalid_index : cell_index(i, j));
+    }
+    f -= num_x_faces();
+    std::size_t i = f % m_nx, j = f / m_nx;
+    if (m_periodic_y) return std::make_tuple(cell_index(i, j == 0 ? m_ny - 1 : j - 1), cell_index(i, j));
+    return std::make_tuple(j == 0 ? invalid_index : cell_index(i, j - 1),
+                           j == m_ny ? invalid_index : cell_index(i, j));
+  }
+
+  // 0 for the faces normal to x and 1 for the faces normal to y
+  int face_direction(std::size_t f) const { return f < num_x_faces() ? 0 : 1; }
+
+  // the cell across the local face f of cell c, or invalid_index on a boundary
+  std::size_t neighbor(std::size_t c, int f) const
+  {
+    auto cells = face_cells(cell_face(c, f));
+    return f % 2 == 0 ? std::get<0>(cells) : std::get<1>(cells);
+  }
+
+  // geometry of the cells, the same for all cells: the affine mapping from the
+  // reference quadrilateral has J = dx * dy / 4, dr/dx = 2 / dx, and ds/dy = 2 / dy
+  T J(std::size_t c) const { return m_dx * m_dy / static_cast<T>(4); }
+
+  T dr_dx(std::size_t c) const { return static_cast<T>(2) / m_dx; }
+
+  T ds_dy(std::size_t c) const { return static_cast<T>(2) / m_dy; }
+
+  T delta_x() const { return m_dx; }
+
+  T delta_y() const { return m_dy; }
+
+  T min_cell_size() const { return std::min(m_dx, m_dy); }
+
+private:
+  T m_x0;
+  T m_y0;
+  T m_dx;
+  T m_dy;
+  std::size_t m_nx;
+  std::size_t m_ny;
+  bool m_periodic_x;
+  bool m_periodic_y;
+};
+
+}
+
+#endif
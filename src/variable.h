@@ -67,6 +67,15 @@ boost::tuple<T1, T2, T3> operator+(const boost::tuple<T1, T2, T3>& v0, const boo
                            boost::get<2>(v0) + boost::get<2>(v1));
 }
 
+template<typename T1, typename T2, typename T3, typename T4>
+boost::tuple<T1, T2, T3, T4> operator+(const boost::tuple<T1, T2, T3, T4>& v0, const boost::tuple<T1, T2, T3, T4>& v1)
+{
+  return boost::make_tuple(boost::get<0>(v0) + boost::get<0>(v1),
+                           boost::get<1>(v0) + boost::get<1>(v1),
+                           boost::get<2>(v0) + boost::get<2>(v1),
+                           boost::get<3>(v0) + boost::get<3>(v1));
+}
+
 template<typename T1, typename T2, typename T3, typename T4, typename T5>
 boost::tuple<T1, T2, T3, T4, T5> operator+(const boost::tuple<T1, T2, T3, T4, T5>& v0, const boost::tuple<T1, T2, T3, T4, T5>& v1)
 {
@@ -86,6 +95,16 @@ boost::tuple<T1, T2, T3>& operator+=(boost::tuple<T1, T2, T3>& v0, const boost::
   return v0;
 }
 
+template<typename T1, typename T2, typename T3, typename T4>
+boost::tuple<T1, T2, T3, T4>& operator+=(boost::tuple<T1, T2, T3, T4>& v0, const boost::tuple<T1, T2, T3, T4>& v1)
+{
+  boost::get<0>(v0) += boost::get<0>(v1);
+  boost::get<1>(v0) += boost::get<1>(v1);
+  boost::get<2>(v0) += boost::get<2>(v1);
+  boost::get<3>(v0) += boost::get<3>(v1);
+  return v0;
+}
+
 template<typename T1, typename T2, typename T3, typename T4, typename T5>
 boost::tuple<T1, T2, T3, T4, T5>& operator+=(boost::tuple<T1, T2, T3, T4, T5>& v0, const boost::tuple<T1, T2, T3, T4, T5>& v1)
 {
@@ -105,6 +124,15 @@ boost::tuple<T1, T2, T3> operator-(const boost::tuple<T1, T2, T3>& v)
                            -boost::get<2>(v));
 }
 
+template<typename T1, typename T2, typename T3, typename T4>
+boost::tuple<T1, T2, T3, T4> operator-(const boost::tuple<T1, T2, T3, T4>& v)
+{
+  return boost::make_tuple(-boost::get<0>(v),
+                           -boost::get<1>(v),
+                           -boost::get<2>(v),
+                           -boost::get<3>(v));
+}
+
 template<typename T1, typename T2, typename T3, typename T4, typename T5>
 boost::tuple<T1, T2, T3, T4, T5> operator-(const boost::tuple<T1, T2, T3, T4, T5>& v)
 {
@@ -123,6 +151,15 @@ boost::tuple<T1, T2, T3> operator-(const boost::tuple<T1, T2, T3>& v0, const boo
                            boost::get<2>(v0) - boost::get<2>(v1));
 }
 
+template<typename T1, typename T2, typename T3, typename T4>
+boost::tuple<T1, T2, T3, T4> operator-(const boost::tuple<T1, T2, T3, T4>& v0, const boost::tuple<T1, T2, T3, T4>& v1)
+{
+  return boost::make_tuple(boost::get<0>(v0) - boost::get<0>(v1),
+                           boost::get<1>(v0) - boost::get<1>(v1),
+                           boost::get<2>(v0) - boost::get<2>(v1),
+                           boost::get<3>(v0) - boost::get<3>(v1));
+}
+
 template<typename T1, typename T2, typename T3, typename T4, typename T5>
 boost::tuple<T1, T2, T3, T4, T5> operator-(const boost::tuple<T1, T2, T3, T4, T5>& v0, const boost::tuple<T1, T2, T3, T4, T5>& v1)
 {
@@ -142,6 +179,16 @@ boost::tuple<T1, T2, T3>& operator-=(boost::tuple<T1, T2, T3>& v0, const boost::
   return v0;
 }
 
+template<typename T1, typename T2, typename T3, typename T4>
+boost::tuple<T1, T2, T3, T4>& operator-=(boost::tuple<T1, T2, T3, T4>& v0, const boost::tuple<T1, T2, T3, T4>& v1)
+{
+  boost::get<0>(v0) -= boost::get<0>(v1);
+  boost::get<1>(v0) -= boost::get<1>(v1);
+  boost::get<2>(v0) -= boost::get<2>(v1);
+  boost::get<3>(v0) -= boost::get<3>(v1);
+  return v0;
+}
+
 template<typename T1, typename T2, typename T3, typename T4, typename T5>
 boost::tuple<T1, T2, T3, T4, T5>& operator-=(boost::tuple<T1, T2, T3, T4, T5>& v0, const boost::tuple<T1, T2, T3, T4, T5>& v1)
 {
@@ -161,6 +208,15 @@ boost::tuple<T1, T2, T3> operator*(T scalar, const boost::tuple<T1, T2, T3>& v)
                            scalar * boost::get<2>(v));
 }
 
+template<typename T, typename T1, typename T2, typename T3, typename T4>
+boost::tuple<T1, T2, T3, T4> operator*(T scalar, const boost::tuple<T1, T2, T3, T4>& v)
+{
+  return boost::make_tuple(scalar * boost::get<0>(v),
+                           scalar * boost::get<1>(v),
+                           scalar * boost::get<2>(v),
+                           scalar * boost::get<3>(v));
+}
+
 template<typename T, typename T1,  typename T2, typename T3, typename T4, typename T5>
 boost::tuple<T1, T2, T3, T4, T5> operator*(T scalar, const boost::tuple<T1, T2, T3, T4, T5>& v)
 {
@@ -180,6 +236,16 @@ boost::tuple<T1, T2, T3>& operator*=(boost::tuple<T1, T2, T3>& v, T scalar)
   return v;
 }
 
+template<typename T, typename T1, typename T2, typename T3, typename T4>
+boost::tuple<T1, T2, T3, T4>& operator*=(boost::tuple<T1, T2, T3, T4>& v, T scalar)
+{
+  boost::get<0>(v) *= scalar;
+  boost::get<1>(v) *= scalar;
+  boost::get<2>(v) *= scalar;
+  boost::get<3>(v) *= scalar;
+  return v;
+}
+
 template<typename T, typename T1, typename T2, typename T3, typename T4, typename T5>
 boost::tuple<T1, T2, T3, T4, T5>& operator*=(boost::tuple<T1, T2, T3, T4, T5>& v, T scalar)
 {
@@ -199,6 +265,15 @@ boost::tuple<T1, T2, T3> operator/(const boost::tuple<T1, T2, T3>& v, T scalar)
                            boost::get<2>(v) / scalar);
 }
 
+template<typename T, typename T1, typename T2, typename T3, typename T4>
+boost::tuple<T1, T2, T3, T4> operator/(const boost::tuple<T1, T2, T3, T4>& v, T scalar)
+{
+  return boost::make_tuple(boost::get<0>(v) / scalar,
+                           boost::get<1>(v) / scalar,
+                           boost::get<2>(v) / scalar,
+                           boost::get<3>(v) / scalar);
+}
+
 template<typename T, typename T1, typename T2, typename T3, typename T4, typename T5>
 boost::tuple<T1, T2, T3, T4, T5> operator/(const boost::tuple<T1, T2, T3, T4, T5>& v, T scalar)
 {
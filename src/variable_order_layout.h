@@ -0,0 +1,150 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#ifndef VARIABLE_ORDER_LAYOUT_H
+#define VARIABLE_ORDER_LAYOUT_H
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+
+#include "const_val.h"
+#include "modal_basis.h"
+
+namespace rdg {
+
+// Layout of the DOFs of 1D elements of various orders (p-adaptivity): the nodal values of
+// the cells are stored consecutively in the cell order, order(c) + 1 of them starting at
+// offset(c), so the traces of the neighbors are found directly at the faces. The cells
+// are also grouped into buckets of the same order, from low to high, so that an element
+// loop runs bucket by bucket with the kernel specialized for the order of the bucket
+// (see dispatch_fixed_order).
+class variable_order_layout
+{
+public:
+  variable_order_layout(std::size_t num_cells, int order) : m_orders(num_cells, order) { build(); }
+
+  explicit variable_order_layout(const std::vector<int>& orders) : m_orders(orders) { build(); }
+
+  std::size_t num_cells() const { return m_orders.size(); }
+
+  std::size_t num_dofs() const { return m_offsets.back(); }
+
+  int order(std::size_t c) const { return m_orders[c]; }
+
+  const std::vector<int>& orders() const { return m_orders; }
+
+  std::size_t num_nodes(std::size_t c) const { return m_orders[c] + 1; }
+
+  std::size_t offset(std::size_t c) const { return m_offsets[c]; }
+
+  const std::vector<std::size_t>& offsets() const { return m_offsets; }
+
+  int min_order() const { return m_bucket_orders.front(); }
+
+  int max_order() const { return m_bucket_orders.back(); }
+
+  // the buckets of the cells of the same order, cells bucket_begin(b), ..., bucket_end(b) - 1
+  // of bucket_order(b) in the increasing cell order
+  std::size_t num_buckets() const { return m_bucket_orders.size(); }
+
+  int bucket_order(std::size_t b) const { return m_bucket_orders[b]; }
+
+  const std::size_t* bucket_begin(std::size_t b) const { return m_bucket_cells.data() + m_bucket_offsets[b]; }
+
+  const std::size_t* bucket_end(std::size_t b) const { return m_bucket_cells.data() + m_bucket_offsets[b + 1]; }
+
+  std::size_t bucket_size(std::size_t b) const { return m_bucket_offsets[b + 1] - m_bucket_offsets[b]; }
+
+  // the buckets one after another, i.e., bucket b at the positions bucket_offset(b), ...,
+  // bucket_offset(b + 1) - 1, so that a loop over the positions can be split anywhere
+  std::size_t bucket_offset(std::size_t b) const { return m_bucket_offsets[b]; }
+
+  std::size_t bucketed_cell(std::size_t k) const { return m_bucket_cells[k]; }
+
+private:
+  void build()
+  {
+    assert(!m_orders.empty());
+    const std::size_t n = num_cells();
+
+    m_offsets.assign(n + 1, 0);
+    for (std::size_t c = 0; c < n; ++c)
+    {
+      assert(m_orders[c] > 0);
+      m_offsets[c + 1] = m_offsets[c] + m_orders[c] + 1;
+    }
+
+    // counting sort of the cells by their orders
+    int max_order = *std::max_element(m_orders.begin(), m_orders.end());
+    std::vector<std::size_t> counts(max_order + 2, 0);
+    for (int p : m_orders) counts[p + 1]++;
+    for (int p = 0; p <= max_order; ++p) counts[p + 1] += counts[p];
+    m_bucket_cells.resize(n);
+    std::vector<std::size_t> next(counts.begin(), counts.end() - 1);
+    for (std::size_t c = 0; c < n; ++c) m_bucket_cells[next[m_orders[c]]++] = c;
+
+    m_bucket_orders.clear();
+    m_bucket_offsets.assign(1, 0);
+    for (int p = 1; p <= max_order; ++p)
+      if (counts[p + 1] > counts[p])
+      {
+        m_bucket_orders.push_back(p);
+        m_bucket_offsets.push_back(counts[p + 1]);
+      }
+  }
+
+private:
+  std::vector<int>         m_orders;
+  std::vector<std::size_t> m_offsets;
+
+  std::vector<int>         m_bucket_orders;
+  std::vector<std::size_t> m_bucket_offsets;
+  std::vector<std::size_t> m_bucket_cells;
+};
+
+// Moves the nodal values of one component (SoA) from the layout from to the layout to of
+// the same cells: a cell of a higher order gets the same polynomial (exact), and a cell of
+// a lower order gets the L2 projection, i.e., the leading modal coefficients, which keeps
+// the mean of the cell.
+template<typename T>
+void change_orders(const variable_order_layout& from, const variable_order_layout& to, const T* in, T* out)
+{
+  assert(from.num_cells() == to.num_cells() && in != out);
+
+  std::vector<T> modal;
+  for (std::size_t c = 0; c < from.num_cells(); ++c)
+  {
+    int p = from.order(c), q = to.order(c);
+    if (p == q)
+    {
+      std::copy_n(in + from.offset(c), p + 1, out + to.offset(c));
+      continue;
+    }
+    modal.assign(std::max(p, q) + 1, const_val<T, 0>);
+    modal_transform<T>::get(p).nodal_to_modal(in + from.offset(c), 1, modal.data());
+    modal_transform<T>::get(q).modal_to_nodal(modal.data(), 1, out + to.offset(c));
+  }
+}
+
+}
+
+#endif
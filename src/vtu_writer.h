@@ -0,0 +1,322 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#ifndef VTU_WRITER_H
+#define VTU_WRITER_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <array>
+#include <map>
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+#include <mutex>
+
+#include "variable_order_layout.h"
+#include "execution_space.h"
+
+namespace rdg {
+
+// VTK XML output of the high-order solution: the nodes of each element are the points
+// of a Lagrange cell, so that ParaView and VisIt render the element by its polynomial,
+// and the point data, i.e., the solution at the nodes, are written as raw binary in the
+// appended section of the .vtu file, streamed directly from the solution buffers.
+//
+// The nodes of an element of order p are (p + 1)^dim consecutive DOFs in the lexicographic
+// order of the reference element, r fastest (see reference_quadrilateral), and the cells
+// of a piece are consecutive, so the point data of a piece is a slice of each buffer.
+enum class vtk_lagrange_cell : std::uint8_t { curve = 68, quadrilateral = 70, hexahedron = 72 };
+
+// a field of the point data, i.e., the values at the nodes in the DOF order
+template<typename T>
+struct vtk_point_field
+{
+  std::string name;
+  const T*    values;
+};
+
+// the lexicographic index of the node at each position of the VTK Lagrange cell of order
+// p, i.e., the corners, the interior nodes of the edges and the faces, then the interior
+// (edges 10 and 11 of the hexahedron in the order of VTK 9.1, file version 2.2)
+inline std::vector<std::size_t> vtk_lagrange_node_order(vtk_lagrange_cell shape, std::size_t p)
+{
+  assert(p > 0);
+  const std::size_t n = p + 1;
+  std::vector<std::size_t> order;
+  auto add = [&](std::size_t i, std::size_t j, std::size_t k) { order.push_back(i + n * (j + n * k)); };
+  auto line = [&](auto node) { for (std::size_t a = 1; a < p; ++a) node(a); };
+  auto square = [&](auto node) { for (std::size_t b = 1; b < p; ++b) for (std::size_t a = 1; a < p; ++a) node(a, b); };
+
+  switch (shape)
+  {
+  case vtk_lagrange_cell::curve:
+    add(0, 0, 0); add(p, 0, 0);
+    line([&](std::size_t a) { add(a, 0, 0); });
+    break;
+  case vtk_lagrange_cell::quadrilateral:
+    add(0, 0, 0); add(p, 0, 0); add(p, p, 0); add(0, p, 0);
+    line([&](std::size_t a) { add(a, 0, 0); });
+    line([&](std::size_t a) { add(p, a, 0); });
+    line([&](std::size_t a) { add(a, p, 0); });
+    line([&](std::size_t a) { add(0, a, 0); });
+    square([&](std::size_t a, std::size_t b) { add(a, b, 0); });
+    break;
+  case vtk_lagrange_cell::hexahedron:
+    for (std::size_t k : {std::size_t(0), p})
+    { add(0, 0, k); add(p, 0, k); add(p, p, k); add(0, p, k); }
+    for (std::size_t k : {std::size_t(0), p})
+    {
+      line([&](std::size_t a) { add(a, 0, k); });
+      line([&](std::size_t a) { add(p, a, k); });
+      line([&](std::size_t a) { add(a, p, k); });
+      line([&](std::size_t a) { add(0, a, k); });
+    }
+    line([&](std::size_t a) { add(0, 0, a); });
+    line([&](std::size_t a) { add(p, 0, a); });
+    line([&](std::size_t a) { add(p, p, a); });
+    line([&](std::size_t a) { add(0, p, a); });
+    for (std::size_t i : {std::size_t(0), p}) square([&](std::size_t a, std::size_t b) { add(i, a, b); });
+    for (std::size_t j : {std::size_t(0), p}) square([&](std::size_t a, std::size_t b) { add(a, j, b); });
+    for (std::size_t k : {std::size_t(0), p}) square([&](std::size_t a, std::size_t b) { add(a, b, k); });
+    for (std::size_t k = 1; k < p; ++k) square([&](std::size_t a, std::size_t b) { add(a, b, k); });
+    break;
+  }
+  return order;
+}
+
+namespace detail {
+
+inline int vtk_dimension(vtk_lagrange_cell shape)
+{ return shape == vtk_lagrange_cell::curve ? 1 : (shape == vtk_lagrange_cell::quadrilateral ? 2 : 3); }
+
+inline const char* vtk_byte_order()
+{
+  const std::uint16_t one = 1;
+  return *reinterpret_cast<const unsigned char*>(&one) == 1 ? "LittleEndian" : "BigEndian";
+}
+
+template<typename T>
+const char* vtk_type_name() { return sizeof(T) == 4 ? "Float32" : "Float64"; }
+
+// base name of a path, for the references of the .pvtu file to its pieces
+inline std::string vtk_file_name(const std::string& path)
+{
+  std::size_t slash = path.find_last_of("/\\");
+  return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+}
+
+// writes the cells [cell_begin, cell_end) as a .vtu file; cell c has the order order(c),
+// and its nodes start at the DOF offset(c); coords are the x, y and z of the nodes, where
+// a null pointer gives zeros, e.g., y and z of a 1D mesh
+template<typename T, typename Order, typename Offset>
+void write_vtu(const std::string& filename, vtk_lagrange_cell shape, std::size_t cell_begin, std::size_t cell_end,
+               Order order, Offset offset, const std::array<const T*, 3>& coords,
+               const std::vector<vtk_point_field<T>>& fields)
+{
+  assert(cell_begin < cell_end);
+  const int dim = detail::vtk_dimension(shape);
+  auto num_nodes = [&](std::size_t c)
+  {
+    std::size_t n = static_cast<std::size_t>(order(c)) + 1, m = n;
+    for (int d = 1; d < dim; ++d) m *= n;
+    return m;
+  };
+
+  const std::size_t first = offset(cell_begin);
+  const std::size_t numPoints = offset(cell_end - 1) + num_nodes(cell_end - 1) - first;
+  const std::size_t numCells = cell_end - cell_begin;
+
+  // the offsets of the arrays in the appended data, each after its size in bytes
+  const std::uint64_t fieldBytes = numPoints * sizeof(T);
+  const std::uint64_t pointBytes = 3 * numPoints * sizeof(T);
+  const std::uint64_t connectivityBytes = numPoints * sizeof(std::int64_t);
+  const std::uint64_t offsetBytes = numCells * sizeof(std::int64_t);
+  const std::uint64_t typeBytes = numCells;
+  std::uint64_t pos = 0;
+  auto next = [&pos](std::uint64_t bytes) { std::uint64_t p = pos; pos += sizeof(std::uint64_t) + bytes; return p; };
+
+  std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+  if (!file) throw std::runtime_error("cannot open " + filename);
+
+  const char* type = detail::vtk_type_name<T>();
+  file << "<?xml version=\"1.0\"?>\n"
+       << "<VTKFile type=\"UnstructuredGrid\" version=\"2.2\" byte_order=\"" << detail::vtk_byte_order()
+       << "\" header_type=\"UInt64\">\n"
+       << "  <UnstructuredGrid>\n"
+       << "    <Piece NumberOfPoints=\"" << numPoints << "\" NumberOfCells=\"" << numCells << "\">\n"
+       << "      <PointData>\n";
+  for (const auto& f : fields)
+    file << "        <DataArray type=\"" << type << "\" Name=\"" << f.name
+         << "\" format=\"appended\" offset=\"" << next(fieldBytes) << "\"/>\n";
+  file << "      </PointData>\n"
+       << "      <Points>\n"
+       << "        <DataArray type=\"" << type << "\" NumberOfComponents=\"3\" format=\"appended\" offset=\""
+       << next(pointBytes) << "\"/>\n"
+       << "      </Points>\n"
+       << "      <Cells>\n"
+       << "        <DataArray type=\"Int64\" Name=\"connectivity\" format=\"appended\" offset=\"" << next(connectivityBytes) << "\"/>\n"
+       << "        <DataArray type=\"Int64\" Name=\"offsets\" format=\"appended\" offset=\"" << next(offsetBytes) << "\"/>\n"
+       << "        <DataArray type=\"UInt8\" Name=\"types\" format=\"appended\" offset=\"" << next(typeBytes) << "\"/>\n"
+       << "      </Cells>\n"
+       << "    </Piece>\n"
+       << "  </UnstructuredGrid>\n"
+       << "  <AppendedData encoding=\"raw\">\n"
+       << "   _";
+
+  auto put = [&file](const void* data, std::uint64_t bytes)
+  { file.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes)); };
+
+  // point data, straight from the buffers
+  for (const auto& f : fields)
+  {
+    put(&fieldBytes, sizeof(std::uint64_t));
+    put(f.values + first, fieldBytes);
+  }
+
+  // the points and the cells are assembled in blocks, as VTK has no 1D or 2D points
+  const std::size_t blockSize = 4096;
+  std::vector<T> points(3 * blockSize);
+  put(&pointBytes, sizeof(std::uint64_t));
+  for (std::size_t b = 0; b < numPoints; b += blockSize)
+  {
+    std::size_t m = std::min(blockSize, numPoints - b);
+    for (std::size_t i = 0; i < m; ++i)
+      for (int d = 0; d < 3; ++d) points[3 * i + d] = coords[d] ? coords[d][first + b + i] : static_cast<T>(0);
+    put(points.data(), 3 * m * sizeof(T));
+  }
+
+  std::map<int, std::vector<std::size_t>> nodeOrders;
+  std::vector<std::int64_t> connectivity;
+  put(&connectivityBytes, sizeof(std::uint64_t));
+  for (std::size_t c = cell_begin; c < cell_end; ++c)
+  {
+    int p = order(c);
+    auto it = nodeOrders.find(p);
+    if (it == nodeOrders.end()) it = nodeOrders.emplace(p, vtk_lagrange_node_order(shape, p)).first;
+    connectivity.clear();
+    for (std::size_t n : it->second) connectivity.push_back(static_cast<std::int64_t>(offset(c) - first + n));
+    put(connectivity.data(), connectivity.size() * sizeof(std::int64_t));
+  }
+
+  put(&offsetBytes, sizeof(std::uint64_t));
+  for (std::size_t c = cell_begin; c < cell_end; ++c)
+  {
+    std::int64_t end = static_cast<std::int64_t>(offset(c) - first + num_nodes(c));
+    put(&end, sizeof(end));
+  }
+
+  put(&typeBytes, sizeof(std::uint64_t));
+  std::vector<std::uint8_t> types(numCells, static_cast<std::uint8_t>(shape));
+  put(types.data(), typeBytes);
+
+  file << "\n  </AppendedData>\n</VTKFile>\n";
+  file.close();
+  if (!file) throw std::runtime_error("cannot write " + filename);
+}
+
+// the cells of a 1D mesh of the orders of the layout
+template<typename T>
+void write_vtu(const std::string& filename, const variable_order_layout& layout, std::size_t cell_begin, std::size_t cell_end,
+               const T* x, const std::vector<vtk_point_field<T>>& fields)
+{
+  write_vtu<T>(filename, vtk_lagrange_cell::curve, cell_begin, cell_end,
+               [&layout](std::size_t c) { return layout.order(c); },
+               [&layout](std::size_t c) { return layout.offset(c); },
+               std::array<const T*, 3>{x, nullptr, nullptr}, fields);
+}
+
+// writes the index of the pieces, e.g., of the ranks of a distributed run, given the
+// names of their .vtu files and of the fields of the point data
+template<typename T>
+void write_pvtu(const std::string& filename, const std::vector<std::string>& pieces, const std::vector<std::string>& fields)
+{
+  std::ofstream file(filename);
+  if (!file) throw std::runtime_error("cannot open " + filename);
+
+  const char* type = detail::vtk_type_name<T>();
+  file << "<?xml version=\"1.0\"?>\n"
+       << "<VTKFile type=\"PUnstructuredGrid\" version=\"2.2\" byte_order=\"" << detail::vtk_byte_order()
+       << "\" header_type=\"UInt64\">\n"
+       << "  <PUnstructuredGrid GhostLevel=\"0\">\n"
+       << "    <PPointData>\n";
+  for (const auto& f : fields)
+    file << "      <PDataArray type=\"" << type << "\" Name=\"" << f << "\"/>\n";
+  file << "    </PPointData>\n"
+       << "    <PPoints>\n"
+       << "      <PDataArray type=\"" << type << "\" NumberOfComponents=\"3\"/>\n"
+       << "    </PPoints>\n";
+  for (const auto& p : pieces)
+    file << "    <Piece Source=\"" << detail::vtk_file_name(p) << "\"/>\n";
+  file << "  </PUnstructuredGrid>\n"
+       << "</VTKFile>\n";
+  if (!file) throw std::runtime_error("cannot write " + filename);
+}
+
+// writes the cells [0, num_cells) in num_pieces pieces of about equal numbers of nodes,
+// <basename>_<k>.vtu, concurrently on the execution space, and their index <basename>.pvtu
+template<typename Space, typename T, typename Order, typename Offset>
+void write_vtu_pieces(const Space& space, const std::string& basename, std::size_t num_pieces,
+                      vtk_lagrange_cell shape, std::size_t num_cells, Order order, Offset offset,
+                      const std::array<const T*, 3>& coords, const std::vector<vtk_point_field<T>>& fields)
+{
+  num_pieces = std::max<std::size_t>(std::min(num_pieces, num_cells), 1);
+
+  // the first cell of each piece, cut at the equal shares of the nodes
+  std::vector<std::size_t> cuts(1, 0);
+  const double total = static_cast<double>(offset(num_cells - 1) - offset(0) + 1);
+  for (std::size_t c = 1; c < num_cells && cuts.size() < num_pieces; ++c)
+    if (offset(c) - offset(0) >= total * cuts.size() / num_pieces) cuts.push_back(c);
+  cuts.push_back(num_cells);
+  num_pieces = cuts.size() - 1;
+
+  std::vector<std::string> pieces(num_pieces), names;
+  for (std::size_t k = 0; k < num_pieces; ++k) pieces[k] = basename + "_" + std::to_string(k) + ".vtu";
+  for (const auto& f : fields) names.push_back(f.name);
+
+  // the pieces are written concurrently, and the first error, if any, is thrown after
+  std::mutex mutex;
+  std::string error;
+  auto cost = [&](std::size_t k) { return static_cast<double>(offset(cuts[k + 1] - 1) - offset(cuts[k]) + 1); };
+  parallel_for(space, num_pieces, cost, [&](std::size_t begin, std::size_t end)
+  {
+    for (std::size_t k = begin; k < end; ++k)
+    {
+      try { write_vtu<T>(pieces[k], shape, cuts[k], cuts[k + 1], order, offset, coords, fields); }
+      catch (const std::exception& e)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (error.empty()) error = e.what();
+      }
+    }
+  });
+  if (!error.empty()) throw std::runtime_error(error);
+
+  write_pvtu<T>(basename + ".pvtu", pieces, names);
+}
+
+}
+
+#endif
@@ -0,0 +1,259 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#ifndef WORK_STEALING_SCHEDULER_H
+#define WORK_STEALING_SCHEDULER_H
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <utility>
+#include <functional>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+#include "thread_affinity.h"
+
+namespace rdg {
+
+// Parallel loops over work items of various costs, e.g., the elements of various orders
+// (see variable_order_layout), the shock-capturing elements, or the boundary faces, on
+// a pool of persistent threads. The items of a loop are cut into tasks, i.e., ranges of
+// consecutive items of about the grain size (or of the grain cost given the cost hints of
+// the items), and the tasks are dealt to the threads in contiguous blocks of about equal
+// costs, one deque per thread. A thread runs its tasks from the front of its deque and,
+// once they are done, steals the tasks from the back of the deques of the others, so the
+// threads stay busy until the loop ends even if the cost hints are off.
+//
+// The threads can be pinned to the CPUs (see thread_affinity), and parallel_for_static()
+// runs the tasks on the threads they are dealt to, without stealing, e.g., to first-touch
+// the pages of the buffers that the loops with the same items and costs work on.
+//
+// NOTE: The calling thread takes part in the loops as thread 0, so the pool has
+// NOTE: num_threads() - 1 worker threads; with an affinity it is pinned as well. A loop
+// NOTE: must not throw or be called from within another loop of the same scheduler.
+class work_stealing_scheduler
+{
+public:
+  explicit work_stealing_scheduler(unsigned num_threads = std::thread::hardware_concurrency(),
+                                   thread_affinity affinity = thread_affinity::none)
+    : m_deques(std::max(num_threads, 1u)),
+      m_cpus(affinity_cpus(affinity, std::max(num_threads, 1u), numa_node_cpus()))
+  {
+    if (!m_cpus.empty()) pin_this_thread(m_cpus[0]);
+    for (unsigned id = 1; id < this->num_threads(); ++id)
+      m_workers.emplace_back([this, id]() { work(id); });
+  }
+
+  ~work_stealing_scheduler()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto& worker : m_workers) worker.join();
+  }
+
+  work_stealing_scheduler(const work_stealing_scheduler&) = delete;
+  work_stealing_scheduler& operator=(const work_stealing_scheduler&) = delete;
+
+  unsigned num_threads() const { return static_cast<unsigned>(m_deques.size()); }
+
+  // the CPU each thread is pinned to; empty if the threads are not pinned
+  const std::vector<int>& cpus() const { return m_cpus; }
+
+  // f(begin, end) on the ranges of about grain items of [0, n)
+  template<typename F>
+  void parallel_for(std::size_t n, std::size_t grain, F&& f)
+  { parallel_for(n, [](std::size_t) { return 1.; }, static_cast<double>(std::max<std::size_t>(grain, 1)), f); }
+
+  // f(begin, end) on the ranges of [0, n) of about grain_cost of the cost hints cost(i)
+  template<typename Cost, typename F>
+  void parallel_for(std::size_t n, Cost cost, double grain_cost, F&& f)
+  { loop(n, cost, grain_cost, f, true); }
+
+  // f(begin, end) on the same ranges and threads as the tasks of parallel_for(n, cost,
+  // grain_cost, f) are dealt to, without stealing
+  template<typename Cost, typename F>
+  void parallel_for_static(std::size_t n, Cost cost, double grain_cost, F&& f)
+  { loop(n, cost, grain_cost, f, false); }
+
+  // number of the tasks stolen in the last loop
+  std::size_t num_steals() const { return m_steals.load(std::memory_order_relaxed); }
+
+private:
+  using task = std::pair<std::size_t, std::size_t>;
+
+  struct task_deque
+  {
+    std::mutex       mutex;
+    std::deque<task> tasks;
+  };
+
+  bool pop(unsigned id, task& t)
+  {
+    task_deque& q = m_deques[id];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (q.tasks.empty()) return false;
+    t = q.tasks.front();
+    q.tasks.pop_front();
+    return true;
+  }
+
+  bool steal(unsigned id, task& t)
+  {
+    for (unsigned k = 1; k < num_threads(); ++k)
+    {
+      task_deque& q = m_deques[(id + k) % num_threads()];
+      std::lock_guard<std::mutex> lock(q.mutex);
+      if (q.tasks.empty()) continue;
+      t = q.tasks.back();
+      q.tasks.pop_back();
+      m_steals.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+    return false;
+  }
+
+  template<typename Cost, typename F>
+  void loop(std::size_t n, Cost cost, double grain_cost, F& f, bool stealing);
+
+  // runs the tasks of the current loop until there are none left to run or steal
+  void run_tasks(unsigned id, const std::function<void(std::size_t, std::size_t)>& job, bool stealing)
+  {
+    task t;
+    while (pop(id, t) || (stealing && steal(id, t)))
+    {
+      job(t.first, t.second);
+      if (m_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_done.notify_all();
+      }
+    }
+  }
+
+  void work(unsigned id)
+  {
+    if (!m_cpus.empty()) pin_this_thread(m_cpus[id]);
+
+    std::size_t generation = 0;
+    while (true)
+    {
+      const std::function<void(std::size_t, std::size_t)>* job;
+      bool stealing;
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_wake.wait(lock, [&]() { return m_stop || m_generation != generation; });
+        if (m_stop) return;
+        generation = m_generation;
+        job = m_job;
+        stealing = m_stealing;
+        m_active++;
+      }
+      run_tasks(id, *job, stealing);
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_active--;
+      }
+      m_done.notify_all();
+    }
+  }
+
+private:
+  std::vector<task_deque>  m_deques;
+  std::vector<std::thread> m_workers;
+  std::vector<int>         m_cpus;
+
+  // the current loop, guarded by m_mutex; the workers that have joined the loop are
+  // active until they find no more tasks, and the next loop waits for them to leave
+  std::mutex              m_mutex;
+  std::condition_variable m_wake;
+  std::condition_variable m_done;
+  bool                    m_stop = false;
+  std::size_t             m_generation = 0;
+  unsigned                m_active = 0;
+  bool                    m_stealing = true;
+  const std::function<void(std::size_t, std::size_t)>* m_job = nullptr;
+
+  std::atomic<std::size_t> m_remaining{0};
+  std::atomic<std::size_t> m_steals{0};
+};
+
+template<typename Cost, typename F>
+void work_stealing_scheduler::loop(std::size_t n, Cost cost, double grain_cost, F& f, bool stealing)
+{
+  if (n == 0) return;
+  if (num_threads() == 1)
+  {
+    f(std::size_t(0), n);
+    return;
+  }
+
+  // the tasks and their prefix costs
+  std::vector<task> tasks;
+  std::vector<double> prefix(1, 0.);
+  double sum = 0.;
+  for (std::size_t i = 0, begin = 0; i < n; ++i)
+  {
+    sum += cost(i);
+    if (sum - prefix.back() >= grain_cost || i + 1 == n)
+    {
+      tasks.emplace_back(begin, i + 1);
+      prefix.push_back(sum);
+      begin = i + 1;
+    }
+  }
+
+  std::function<void(std::size_t, std::size_t)> job = [&f](std::size_t begin, std::size_t end) { f(begin, end); };
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this]() { return m_active == 0; });
+
+    // thread id gets the tasks whose prefix costs fall in its share of the total cost
+    for (std::size_t k = 0, id = 0; k < tasks.size(); ++k)
+    {
+      while (id + 1 < num_threads() && prefix[k] >= sum * (id + 1) / num_threads()) ++id;
+      std::lock_guard<std::mutex> qlock(m_deques[id].mutex);
+      m_deques[id].tasks.push_back(tasks[k]);
+    }
+    m_remaining.store(tasks.size(), std::memory_order_relaxed);
+    m_steals.store(0, std::memory_order_relaxed);
+    m_job = &job;
+    m_stealing = stealing;
+    m_generation++;
+  }
+  m_wake.notify_all();
+
+  run_tasks(0, job, stealing);
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_done.wait(lock, [this]() { return m_remaining.load(std::memory_order_acquire) == 0; });
+}
+
+}
+
+#endif
@@ -30,11 +30,11 @@ int main(int argc, char **argv) {
 //  if (test_legendre_polynomials())
 //    std::cout << "test_legendre_polynomials FAILED!!!" << std::endl;
 //
-//  if (test_gauss_lobatto_quadrature())
-//    std::cout << "test_gauss_lobatto_quadrature FAILED!!!" << std::endl;
+  if (test_gauss_lobatto_quadrature())
+    std::cout << "test_gauss_lobatto_quadrature FAILED!!!" << std::endl;
 //
-//  if (test_lagrange_basis())
-//    std::cout << "test_lagrange_basis FAILED!!!" << std::endl;
+  if (test_lagrange_basis())
+    std::cout << "test_lagrange_basis FAILED!!!" << std::endl;
 //
 //  if (test_reference_segment())
 //    std::cout << "test_reference_segment FAILED!!!" << std::endl;
@@ -42,6 +42,72 @@ int main(int argc, char **argv) {
   if (test_mapping_segment())
     std::cout << "test_mapping_segment FAILED!!!" << std::endl;
 
+  if (test_dense_matrix_view())
+    std::cout << "test_dense_matrix_view FAILED!!!" << std::endl;
+
+  if (test_gauss_legendre_quadrature())
+    std::cout << "test_gauss_legendre_quadrature FAILED!!!" << std::endl;
+
+  if (test_lgl_gl_transfer())
+    std::cout << "test_lgl_gl_transfer FAILED!!!" << std::endl;
+
+  if (test_reference_segment_traits())
+    std::cout << "test_reference_segment_traits FAILED!!!" << std::endl;
+
+  if (test_modal_basis())
+    std::cout << "test_modal_basis FAILED!!!" << std::endl;
+
+  if (test_reference_hexahedron())
+    std::cout << "test_reference_hexahedron FAILED!!!" << std::endl;
+
+  if (test_cartesian_mesh_1d())
+    std::cout << "test_cartesian_mesh_1d FAILED!!!" << std::endl;
+
+  if (test_uniform_cartesian_mesh_2d())
+    std::cout << "test_uniform_cartesian_mesh_2d FAILED!!!" << std::endl;
+
+  if (test_gmsh_reader())
+    std::cout << "test_gmsh_reader FAILED!!!" << std::endl;
+
+  if (test_cell_reordering())
+    std::cout << "test_cell_reordering FAILED!!!" << std::endl;
+
+  if (test_cell_partition())
+    std::cout << "test_cell_partition FAILED!!!" << std::endl;
+
+  if (test_curvilinear_metrics())
+    std::cout << "test_curvilinear_metrics FAILED!!!" << std::endl;
+
+  if (test_adaptive_mesh_1d())
+    std::cout << "test_adaptive_mesh_1d FAILED!!!" << std::endl;
+
+  if (test_variable_order_layout())
+    std::cout << "test_variable_order_layout FAILED!!!" << std::endl;
+
+  if (test_work_stealing_scheduler())
+    std::cout << "test_work_stealing_scheduler FAILED!!!" << std::endl;
+
+  if (test_thread_affinity())
+    std::cout << "test_thread_affinity FAILED!!!" << std::endl;
+
+  if (test_execution_space())
+    std::cout << "test_execution_space FAILED!!!" << std::endl;
+
+  if (test_async_writer())
+    std::cout << "test_async_writer FAILED!!!" << std::endl;
+
+  if (test_checkpoint())
+    std::cout << "test_checkpoint FAILED!!!" << std::endl;
+
+  if (test_vtu_writer())
+    std::cout << "test_vtu_writer FAILED!!!" << std::endl;
+
+  if (test_float_codec())
+    std::cout << "test_float_codec FAILED!!!" << std::endl;
+
+  if (test_text_writer())
+    std::cout << "test_text_writer FAILED!!!" << std::endl;
+
   // finish
   return 0;
 }
@@ -0,0 +1,149 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#include <iostream>
+#include <vector>
+#include <iterator>
+#include <cstdlib>
+#include <cmath>
+
+#include "gauss_lobatto_quadrature.h"
+#include "mapping_segment.h"
+#include "adaptive_mesh_1d.h"
+
+namespace {
+
+bool is_balanced(const rdg::adaptive_mesh_1d<double>& mesh)
+{
+  double length = 0.;
+  for (std::size_t i = 0; i < mesh.num_cells(); ++i)
+  {
+    if (i + 1 < mesh.num_cells() && std::abs(mesh.level(i) - mesh.level(i + 1)) > 1) return false;
+    length += 2. * mesh.J(i);
+  }
+  return std::abs(length - 1.) < 1.e-14;
+}
+
+template<typename F>
+std::vector<double> nodal_values(const rdg::adaptive_mesh_1d<double>& mesh, const std::vector<double>& r, F f)
+{
+  std::vector<double> u;
+  for (std::size_t i = 0; i < mesh.num_cells(); ++i)
+    for (double ri : r)
+      u.push_back(f(rdg::mapping_segment::r_to_x(mesh.get_vertex(i), mesh.get_vertex(i + 1), ri)));
+  return u;
+}
+
+double integral(const rdg::adaptive_mesh_1d<double>& mesh, const std::vector<double>& w, const std::vector<double>& u)
+{
+  double sum = 0.;
+  for (std::size_t i = 0; i < mesh.num_cells(); ++i)
+    for (std::size_t a = 0; a < w.size(); ++a) sum += mesh.J(i) * w[a] * u[i * w.size() + a];
+  return sum;
+}
+
+}
+
+int test_adaptive_mesh_1d()
+{
+  using namespace rdg;
+
+  const double tol = 1.e-13;
+
+  adaptive_mesh_1d<double> mesh(0., 1., 4, 4);
+
+  // refining the last cell three times grades the mesh without further refinement
+  std::vector<int> flags;
+  for (int k = 0; k < 3; ++k)
+  {
+    flags.assign(mesh.num_cells(), 0);
+    flags.back() = 1;
+    if (!mesh.adapt(flags)) return 1;
+  }
+  if (mesh.num_cells() != 7 || mesh.level(3) != 1 || mesh.level(6) != 3) return 1;
+
+  // refining a cell of level 3 cascades to the left for the 2:1 balance
+  flags.assign(mesh.num_cells(), 0);
+  flags[5] = 1;
+  if (!mesh.adapt(flags) || !is_balanced(mesh)) return 1;
+  std::cout << "number of cells after the balanced refinement = " << mesh.num_cells() << std::endl;
+  if (mesh.num_cells() != 11 || mesh.level(1) != 0 || mesh.level(2) != 1 || mesh.level(8) != 4) return 1;
+  if (std::abs(mesh.min_cell_size() - 1. / 64.) > tol) return 1;
+
+  // the maximum level caps the refinement
+  flags.assign(mesh.num_cells(), 0);
+  flags[8] = flags[9] = 1;
+  if (mesh.adapt(flags)) return 1;
+
+  // coarsening a cell without its sibling does nothing
+  flags.assign(mesh.num_cells(), 0);
+  flags[7] = -1;
+  if (mesh.adapt(flags)) return 1;
+
+  // coarsening everything keeps the 2:1 balance
+  flags.assign(mesh.num_cells(), -1);
+  if (!mesh.adapt(flags) || !is_balanced(mesh)) return 1;
+
+  // the transfer of a polynomial of degree np - 1 is exact both ways, and the
+  // coarsening conserves the integral of any solution
+  const std::size_t np = 4;
+  std::vector<double> r, w;
+  gauss_lobatto_quadrature(np, std::back_inserter(r), std::back_inserter(w));
+  auto p = [](double x) { return 1. + x * (2. - x * (3. - 4. * x)); };
+  auto f = [](double x) { return std::sin(7. * x) + std::exp(x); };
+
+  adaptive_mesh_1d<double> amr(0., 1., 3, 2);
+  flags.assign(amr.num_cells(), 1);
+  std::vector<double> up = nodal_values(amr, r, p), uf = nodal_values(amr, r, f);
+  amr.adapt(flags);
+  std::vector<double> vp(amr.num_cells() * np), vf(amr.num_cells() * np);
+  amr.transfer(np, up.cbegin(), vp.begin());
+  amr.transfer(np, uf.cbegin(), vf.begin());
+  std::vector<double> exact = nodal_values(amr, r, p);
+  for (std::size_t k = 0; k < vp.size(); ++k)
+    if (std::abs(vp[k] - exact[k]) > tol) return 1;
+  double before = integral(amr, w, vf);
+
+  flags.assign(amr.num_cells(), -1);
+  amr.adapt(flags);
+  if (amr.num_cells() != 3) return 1;
+  up.resize(amr.num_cells() * np);
+  uf.resize(amr.num_cells() * np);
+  amr.transfer(np, vp.cbegin(), up.begin());
+  amr.transfer(np, vf.cbegin(), uf.begin());
+  exact = nodal_values(amr, r, p);
+  for (std::size_t k = 0; k < up.size(); ++k)
+    if (std::abs(up[k] - exact[k]) > tol) return 1;
+  std::cout << "integral before and after coarsening = " << before << ", " << integral(amr, w, uf) << std::endl;
+  if (std::abs(integral(amr, w, uf) - before) > tol) return 1;
+
+  // an adapt() that changes nothing after one that did leaves the transfer a copy
+  adaptive_mesh_1d<double> fine(0., 1., 3, 1);
+  flags.assign(fine.num_cells(), 1);
+  if (!fine.adapt(flags)) return 1;
+  flags.assign(fine.num_cells(), 1);
+  if (fine.adapt(flags)) return 1;
+  up = nodal_values(fine, r, f);
+  vp.assign(up.size(), 0.);
+  fine.transfer(np, up.cbegin(), vp.begin());
+  if (vp != up) return 1;
+
+  return 0;
+}
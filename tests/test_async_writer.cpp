@@ -0,0 +1,79 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <stdexcept>
+
+#include "async_writer.h"
+
+int test_async_writer()
+{
+  using namespace rdg;
+
+  // a slow writer falls behind, so the writes are throttled by the two staging buffers,
+  // but the snapshots are serialized in order and not changed by the later updates
+  std::vector<std::string> names;
+  std::vector<double> sums;
+  std::vector<double> u(1000), x(1000);
+  for (std::size_t i = 0; i < x.size(); ++i) x[i] = static_cast<double>(i);
+  {
+    async_writer<double> writer([&](const async_writer<double>::snapshot& s)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      double sum = 0.;
+      for (std::size_t i = 0; i < s.columns[0].size(); ++i) sum += s.columns[0][i] * s.columns[1][i];
+      names.push_back(s.name);
+      sums.push_back(sum);
+    });
+
+    for (int k = 0; k < 6; ++k)
+    {
+      std::fill(u.begin(), u.end(), static_cast<double>(k));
+      writer.write("step" + std::to_string(k), k * 0.1, u.size(), x.cbegin(), u.cbegin());
+    }
+    if (writer.num_stalls() == 0) return 1;
+
+    writer.flush();
+    if (names.size() != 6) return 1;
+    std::cout << "output stalls = " << writer.num_stalls() << " (" << writer.stall_seconds() << " s)" << std::endl;
+
+    // the destructor serializes the snapshots still queued
+    writer.write("last", 1., u.size(), x.cbegin(), u.cbegin());
+  }
+  if (names.size() != 7 || names.back() != "last") return 1;
+  for (int k = 0; k < 6; ++k)
+    if (names[k] != "step" + std::to_string(k) || sums[k] != k * 999. * 1000. / 2.) return 1;
+
+  // the errors of the writer thread come back to the caller
+  async_writer<double> failing([](const async_writer<double>::snapshot& s)
+  { throw std::runtime_error("cannot open " + s.name); });
+  failing.write("bad", 0., u.size(), u.cbegin());
+  bool thrown = false;
+  try { failing.flush(); }
+  catch (const std::runtime_error&) { thrown = true; }
+  if (!thrown) return 1;
+  failing.flush();
+
+  return 0;
+}
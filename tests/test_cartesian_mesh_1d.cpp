@@ -0,0 +1,62 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+
+#include "cartesian_mesh_1d.h"
+#include "uniform_cartesian_mesh_1d.h"
+
+int test_cartesian_mesh_1d()
+{
+  using namespace rdg;
+
+  const double tol = 1.e-14;
+
+  // a uniform cartesian_mesh_1d must match uniform_cartesian_mesh_1d
+  uniform_cartesian_mesh_1d<double> uniform(0., 2., 8);
+  cartesian_mesh_1d<double> mesh(0., 2., 8);
+  if (mesh.num_cells() != uniform.num_cells()) return 1;
+  for (std::size_t i = 0; i < mesh.num_cells(); ++i)
+  {
+    if (std::abs(mesh.J(i) - uniform.J(i)) > tol) return 1;
+    if (std::abs(mesh.inv_J(i) * mesh.J(i) - 1.) > tol) return 1;
+  }
+  if (std::abs(mesh.min_cell_size() - uniform.min_cell_size()) > tol) return 1;
+
+  // clustering around the middle of [0, 1] yields a symmetric mesh finest at the middle
+  std::vector<double> v(11);
+  clustered_vertices(0., 1., 10, 0.5, 4., v.begin());
+  cartesian_mesh_1d<double> clustered(v.cbegin(), v.cend());
+  std::cout << "min cell size of the clustered mesh = " << clustered.min_cell_size() << std::endl;
+  for (std::size_t i = 0; i < v.size(); ++i)
+    if (std::abs(v[i] + v[v.size() - 1 - i] - 1.) > tol) return 1;
+  if (std::abs(clustered.min_cell_size() - (v[5] - v[4])) > tol) return 1;
+  double sumJ = 0.;
+  for (std::size_t i = 0; i < clustered.num_cells(); ++i)
+  {
+    if (clustered.J(i) < clustered.J(4) - tol) return 1;
+    sumJ += 2. * clustered.J_data()[i];
+  }
+  if (std::abs(sumJ - 1.) > tol) return 1;
+
+  return 0;
+}
@@ -0,0 +1,92 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#include <iostream>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include <random>
+
+#include "cell_partition.h"
+
+int test_cell_partition()
+{
+  using namespace rdg;
+
+  // n x n x n box of unit hexahedra in a random order
+  const std::size_t n = 12;
+  auto vertex = [n](std::size_t i, std::size_t j, std::size_t k) { return i + (n + 1) * (j + (n + 1) * k); };
+  std::vector<double> x, y, z;
+  for (std::size_t k = 0; k <= n; ++k)
+    for (std::size_t j = 0; j <= n; ++j)
+      for (std::size_t i = 0; i <= n; ++i)
+      {
+        x.push_back(i);
+        y.push_back(j);
+        z.push_back(k);
+      }
+  std::mt19937 gen(11);
+  std::vector<std::size_t> cells(n * n * n);
+  std::iota(cells.begin(), cells.end(), 0);
+  std::shuffle(cells.begin(), cells.end(), gen);
+  std::vector<std::size_t> cell_vertices;
+  for (std::size_t c : cells)
+    for (std::size_t d = 0; d < 8; ++d)
+      cell_vertices.push_back(vertex(c % n + d % 2, c / n % n + d / 2 % 2, c / (n * n) + d / 4));
+  unstructured_hex_mesh<double> mesh(x, y, z, cell_vertices);
+
+  std::vector<double> xc, yc, zc;
+  cell_centroids(mesh, xc, yc, zc);
+  std::vector<std::size_t> offsets, adjacency;
+  cell_adjacency(mesh, offsets, adjacency);
+
+  // cells of random orders 1 to 4
+  std::uniform_int_distribution<int> orders(1, 4);
+  std::vector<double> weights(mesh.num_cells());
+  for (double& w : weights) w = flux_differencing_cost(orders(gen), 3);
+
+  auto order = hilbert_order(xc, yc, zc);
+  for (int K : {1, 4, 7, 16})
+  {
+    cell_partition partition(order, weights, K);
+    partition.print_statistics(std::cout, offsets, adjacency);
+    if (partition.num_parts() != K) return 1;
+    if (partition.imbalance() > 1.05) return 1;
+
+    // contiguous along the order, every cell in one part
+    for (int p = 0; p < K; ++p)
+    {
+      if (partition.part_begin(p) >= partition.part_end(p)) return 1;
+      for (std::size_t i = partition.part_begin(p); i < partition.part_end(p); ++i)
+        if (partition.part(order.new_to_old(i)) != p) return 1;
+    }
+    if (partition.part_end(K - 1) != mesh.num_cells()) return 1;
+
+    // the cut is much lower than that of the same partition of the random order
+    cell_partition random(cell_permutation::identity(mesh.num_cells()), weights, K);
+    if (K > 1 && 2 * partition.edge_cut(offsets, adjacency) > random.edge_cut(offsets, adjacency)) return 1;
+  }
+
+  // more parts than cells leave some parts empty
+  cell_partition tiny(cell_permutation::identity(3), std::vector<int>{1, 1, 1}, 5);
+  if (tiny.num_parts() != 5 || tiny.part_end(4) != 3) return 1;
+
+  return 0;
+}
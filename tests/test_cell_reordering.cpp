@@ -0,0 +1,133 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#include <iostream>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include <random>
+#include <cstdlib>
+
+#include "cell_reordering.h"
+
+// n x n x n box of unit hexahedra in a random order
+static rdg::unstructured_hex_mesh<double> shuffled_box(std::size_t n)
+{
+  auto vertex = [n](std::size_t i, std::size_t j, std::size_t k) { return i + (n + 1) * (j + (n + 1) * k); };
+  std::vector<double> x, y, z;
+  for (std::size_t k = 0; k <= n; ++k)
+    for (std::size_t j = 0; j <= n; ++j)
+      for (std::size_t i = 0; i <= n; ++i)
+      {
+        x.push_back(i);
+        y.push_back(j);
+        z.push_back(k);
+      }
+
+  std::vector<std::size_t> order(n * n * n);
+  std::iota(order.begin(), order.end(), 0);
+  std::shuffle(order.begin(), order.end(), std::mt19937(7));
+  std::vector<std::size_t> cell_vertices;
+  for (std::size_t c : order)
+  {
+    std::size_t i = c % n, j = c / n % n, k = c / (n * n);
+    for (std::size_t d = 0; d < 8; ++d)
+      cell_vertices.push_back(vertex(i + d % 2, j + d / 2 % 2, k + d / 4));
+  }
+  return rdg::unstructured_hex_mesh<double>(x, y, z, cell_vertices);
+}
+
+// average distance in the cell order of the face neighbors
+static double average_neighbor_distance(const rdg::unstructured_hex_mesh<double>& mesh)
+{
+  using mesh_type = rdg::unstructured_hex_mesh<double>;
+  double sum = 0.;
+  std::size_t count = 0;
+  for (std::size_t c = 0; c < mesh.num_cells(); ++c)
+    for (int f = 0; f < mesh_type::num_cell_faces(); ++f)
+      if (mesh.neighbor(c, f) != mesh_type::invalid_index)
+      {
+        sum += std::abs(static_cast<double>(c) - static_cast<double>(mesh.neighbor(c, f)));
+        count++;
+      }
+  return sum / count;
+}
+
+int test_cell_reordering()
+{
+  using namespace rdg;
+
+  // consecutive cells of a 4 x 4 x 4 grid along the Hilbert curve are face neighbors
+  std::vector<std::uint64_t> keys;
+  for (std::uint32_t c = 0; c < 64; ++c)
+    keys.push_back(hilbert_key((c % 4) << 19, (c / 4 % 4) << 19, (c / 16) << 19));
+  std::vector<std::size_t> curve(64);
+  std::iota(curve.begin(), curve.end(), 0);
+  std::sort(curve.begin(), curve.end(), [&keys](std::size_t a, std::size_t b) { return keys[a] < keys[b]; });
+  for (std::size_t i = 1; i < curve.size(); ++i)
+  {
+    int a = curve[i - 1], b = curve[i];
+    int d = std::abs(a % 4 - b % 4) + std::abs(a / 4 % 4 - b / 4 % 4) + std::abs(a / 16 - b / 16);
+    if (d != 1) return 1;
+  }
+
+  // all orderings bring the neighbors closer than a random order
+  auto mesh = shuffled_box(8);
+  std::vector<double> xc, yc, zc;
+  cell_centroids(mesh, xc, yc, zc);
+  std::vector<std::size_t> offsets, adjacency;
+  cell_adjacency(mesh, offsets, adjacency);
+
+  double d0 = average_neighbor_distance(mesh);
+  std::cout << "average distance of neighbors: random " << d0;
+  for (int method = 0; method < 3; ++method)
+  {
+    cell_permutation perm = method == 0 ? morton_order(xc, yc, zc) :
+                            method == 1 ? hilbert_order(xc, yc, zc) : rcm_order(offsets, adjacency);
+
+    // a permutation and its inverse
+    std::vector<std::size_t> seen(perm.size(), 0);
+    for (std::size_t i = 0; i < perm.size(); ++i)
+    {
+      seen[perm.new_to_old(i)]++;
+      if (perm.old_to_new(perm.new_to_old(i)) != i) return 1;
+    }
+    if (std::count(seen.begin(), seen.end(), 1) != static_cast<long>(perm.size())) return 1;
+
+    auto reordered = permute_cells(mesh, perm);
+    if (reordered.num_faces() != mesh.num_faces() || reordered.cell_vertex(5, 3) != mesh.cell_vertex(perm.new_to_old(5), 3))
+      return 1;
+    double d = average_neighbor_distance(reordered);
+    std::cout << (method == 0 ? ", Morton " : method == 1 ? ", Hilbert " : ", RCM ") << d;
+    if (d > 0.25 * d0) return 1;
+
+    // blocks of DOFs per cell go to the new order and back
+    const std::size_t np = 3;
+    std::vector<double> dofs(perm.size() * np), permuted(dofs.size()), back(dofs.size());
+    std::iota(dofs.begin(), dofs.end(), 0.);
+    perm.apply(dofs.cbegin(), np, permuted.begin());
+    if (permuted[7 * np + 2] != dofs[perm.new_to_old(7) * np + 2]) return 1;
+    perm.apply_inverse(permuted.cbegin(), np, back.begin());
+    if (back != dofs) return 1;
+  }
+  std::cout << std::endl;
+
+  return 0;
+}
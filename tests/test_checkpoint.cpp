@@ -0,0 +1,111 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#include <iostream>
+#include <vector>
+#include <fstream>
+#include <string>
+#include <iterator>
+#include <stdexcept>
+#include <cstdio>
+#include <cstdint>
+
+#include "checkpoint.h"
+#include "cartesian_mesh_1d.h"
+#include "work_stealing_scheduler.h"
+
+int test_checkpoint()
+{
+  using namespace rdg;
+
+  // a non-uniform mesh of cells of various orders
+  std::vector<double> vertices{0., 0.1, 0.15, 0.4, 0.7, 1.};
+  cartesian_mesh_1d<double> mesh(vertices.begin(), vertices.end());
+  variable_order_layout layout(std::vector<int>{1, 3, 2, 4, 2});
+  std::size_t n = layout.num_dofs();
+  std::vector<double> u(n), v(n);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    u[i] = 1. / (i + 1.);
+    v[i] = -3. * i;
+  }
+
+  const std::string filename = "test_checkpoint.ckpt";
+  save_checkpoint<double>(filename, mesh, layout, 42, 0.125, 1e-3, {u.data(), v.data()});
+  {
+    mapped_checkpoint<double> ckpt(filename);
+    if (!ckpt.verify()) return 1;
+    if (ckpt.num_cells() != 5 || ckpt.num_dofs() != n || ckpt.num_variables() != 2) return 1;
+    if (ckpt.step() != 42 || ckpt.time() != 0.125 || ckpt.dt() != 1e-3) return 1;
+    if (ckpt.layout().orders() != layout.orders()) return 1;
+    for (std::size_t i = 0; i < vertices.size(); ++i)
+      if (ckpt.vertices()[i] != vertices[i]) return 1;
+
+    // the arrays are aligned and used in place
+    if (reinterpret_cast<std::uintptr_t>(ckpt.variable(1)) % checkpoint_alignment != 0) return 1;
+    for (std::size_t i = 0; i < n; ++i)
+      if (ckpt.variable(0)[i] != u[i] || ckpt.variable(1)[i] != v[i]) return 1;
+  }
+
+  // a compressed checkpoint gives the same values in a smaller file
+  const std::string compressed = "test_checkpoint_z.ckpt";
+  auto rawSize = save_checkpoint<double>(filename, mesh, layout, 42, 0.125, 1e-3, {u.data(), v.data()});
+  auto compressedSize = save_checkpoint<double>(compressed, mesh, layout, 42, 0.125, 1e-3, {u.data(), v.data()},
+                                                checkpoint_compression::lossless);
+  {
+    mapped_checkpoint<double> ckpt(compressed);
+    if (!ckpt.verify() || ckpt.compression() != checkpoint_compression::lossless) return 1;
+    std::vector<double> cu(n), cv(n);
+    ckpt.read_variable(0, cu.data());
+    ckpt.read_variable(1, cv.data());
+    if (cu != u || cv != v) return 1;
+  }
+  if (compressedSize >= rawSize) return 1;
+
+  // and the same file when compressed on a thread pool
+  {
+    std::ifstream serial(compressed, std::ios::binary);
+    std::string serialBytes((std::istreambuf_iterator<char>(serial)), std::istreambuf_iterator<char>());
+    work_stealing_scheduler scheduler(3);
+    save_checkpoint<double>(compressed, mesh, layout, 42, 0.125, 1e-3, {u.data(), v.data()},
+                            checkpoint_compression::lossless, thread_pool_space(&scheduler, 1.));
+    std::ifstream parallel(compressed, std::ios::binary);
+    std::string parallelBytes((std::istreambuf_iterator<char>(parallel)), std::istreambuf_iterator<char>());
+    if (parallelBytes != serialBytes) return 1;
+  }
+  std::remove(compressed.c_str());
+
+  // a flipped bit fails the checksum
+  {
+    std::fstream file(filename, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(sizeof(checkpoint_header) + 200);
+    file.put(0x55);
+  }
+  if (mapped_checkpoint<double>(filename).verify()) return 1;
+
+  // a checkpoint of another scalar type is rejected
+  bool thrown = false;
+  try { mapped_checkpoint<float> ckpt(filename); }
+  catch (const std::runtime_error&) { thrown = true; }
+  std::remove(filename.c_str());
+  if (!thrown) return 1;
+
+  return 0;
+}
@@ -0,0 +1,130 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#include <iostream>
+#include <vector>
+#include <array>
+#include <cmath>
+#include <algorithm>
+
+#include "curvilinear_metrics.h"
+#include "unstructured_hex_mesh.h"
+
+int test_curvilinear_metrics()
+{
+  using namespace rdg;
+
+  const double pi = std::acos(-1.);
+  const double tol = 1.e-12;
+
+  // 2 x 2 x 2 box of unit hexahedra
+  std::vector<double> x, y, z;
+  for (int k = 0; k <= 2; ++k)
+    for (int j = 0; j <= 2; ++j)
+      for (int i = 0; i <= 2; ++i)
+      {
+        x.push_back(i);
+        y.push_back(j);
+        z.push_back(k);
+      }
+  std::vector<std::size_t> cell_vertices;
+  for (int c = 0; c < 8; ++c)
+    for (int d = 0; d < 8; ++d)
+      cell_vertices.push_back((c % 2 + d % 2) + 3 * (c / 2 % 2 + d / 2 % 2) + 9 * (c / 4 + d / 4));
+  unstructured_hex_mesh<double> mesh(x, y, z, cell_vertices);
+
+  reference_hexahedron<double> hex(4);
+  std::size_t Np = hex.num_nodes();
+
+  // straight-sided elements: constant metric terms
+  std::vector<double> xn, yn, zn;
+  hexahedron_nodes(hex, mesh, [](double a, double b, double c) { return std::array<double, 3>{a, b, c}; }, xn, yn, zn);
+  hexahedron_metrics<double> affine(hex, mesh.num_cells(), xn.cbegin(), yn.cbegin(), zn.cbegin());
+  for (std::size_t e = 0; e < affine.num_elements(); ++e)
+    for (std::size_t n = 0; n < Np; ++n)
+    {
+      if (std::abs(affine.J(e, n) - 0.125) > tol) return 1;
+      for (int i = 0; i < 3; ++i)
+        for (int k = 0; k < 3; ++k)
+          if (std::abs(affine.Ja(i, k, e, n) - (i == k ? 0.25 : 0.)) > tol) return 1;
+    }
+  if (std::abs(affine.normal(0, 3, 0, 5) + 1.) > tol || std::abs(affine.normal(2, 3, 5, 5) - 1.) > tol) return 1;
+  if (std::abs(affine.scaling(3, 4, 7) - 0.25) > tol) return 1;
+
+  // curved elements: the discrete metric identities sum_i D_i (J a^i)_k = 0 hold to round-off
+  auto g = [pi](double a, double b, double c)
+  {
+    double bump = 0.1 * std::sin(pi * a / 2.) * std::sin(pi * b / 2.) * std::sin(pi * c / 2.);
+    return std::array<double, 3>{a + bump, b + 0.5 * bump * a, c - bump * b};
+  };
+  hexahedron_nodes(hex, mesh, g, xn, yn, zn);
+  hexahedron_metrics<double> curved(hex, mesh.num_cells(), xn.cbegin(), yn.cbegin(), zn.cbegin());
+
+  double maxIdentity = 0., volume = 0.;
+  std::vector<double> Ja(Np), d(Np), sum(Np);
+  for (std::size_t e = 0; e < curved.num_elements(); ++e)
+  {
+    for (int k = 0; k < 3; ++k)
+    {
+      std::fill(sum.begin(), sum.end(), 0.);
+      for (int i = 0; i < 3; ++i)
+      {
+        for (std::size_t n = 0; n < Np; ++n) Ja[n] = curved.Ja(i, k, e, n);
+        if (i == 0) hex.derivative_r(Ja.cbegin(), d.begin());
+        else if (i == 1) hex.derivative_s(Ja.cbegin(), d.begin());
+        else hex.derivative_t(Ja.cbegin(), d.begin());
+        for (std::size_t n = 0; n < Np; ++n) sum[n] += d[n];
+      }
+      for (std::size_t n = 0; n < Np; ++n) maxIdentity = std::max(maxIdentity, std::abs(sum[n]));
+    }
+    for (std::size_t n = 0; n < Np; ++n) volume += hex.weight(n) * curved.J(e, n);
+    for (int f = 0; f < 6; ++f)
+      for (std::size_t a = 0; a < curved.num_face_nodes(); ++a)
+      {
+        double nx = curved.normal(0, e, f, a), ny = curved.normal(1, e, f, a), nz = curved.normal(2, e, f, a);
+        if (std::abs(nx * nx + ny * ny + nz * nz - 1.) > tol) return 1;
+      }
+  }
+  std::cout << "curvilinear hexahedra: max metric identity residual " << maxIdentity
+            << ", volume " << volume << std::endl;
+  if (maxIdentity > tol) return 1;
+
+  // the transformation moves the interior but not the boundary of the box, whose volume is 8
+  if (std::abs(volume - 8.) > 1.e-6) return 1;
+
+  // 2D: a curved quadrilateral
+  reference_quadrilateral<double> quad(5);
+  std::vector<double> xq(quad.num_nodes()), yq(quad.num_nodes());
+  for (std::size_t n = 0; n < quad.num_nodes(); ++n)
+  {
+    double r = quad.node_position_r(n), s = quad.node_position_s(n);
+    xq[n] = 2. * r + 0.1 * std::sin(pi * s);
+    yq[n] = s + 0.1 * r * r;
+  }
+  quadrilateral_metrics<double> qm(quad, 1, xq.cbegin(), yq.cbegin());
+  double area = 0.;
+  for (std::size_t n = 0; n < quad.num_nodes(); ++n) area += quad.weight(n) * qm.J(0, n);
+  std::cout << "curvilinear quadrilateral: area " << area << std::endl;
+  // the area of the mapping is 8 exactly and the integrand is of a degree the quadrature resolves
+  if (std::abs(area - 8.) > 1.e-6) return 1;
+  if (std::abs(qm.normal(0, 0, 1, 2) * qm.normal(0, 0, 1, 2) + qm.normal(1, 0, 1, 2) * qm.normal(1, 0, 1, 2) - 1.) > tol) return 1;
+
+  return 0;
+}
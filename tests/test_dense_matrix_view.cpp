@@ -0,0 +1,78 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#include <vector>
+#include <utility>
+#include <iostream>
+
+#include "dense_matrix.h"
+
+int test_dense_matrix_view()
+{
+  using namespace rdg;
+
+  dense_matrix<double> A{{1., 2., 3.}, {4., 5., 6.}, {7., 8., 9.}};
+  dense_matrix<double> B{{1., 0., 2.}, {0., 1., 0.}, {3., 0., 1.}};
+
+  // products through views must agree with those of owning matrices
+  auto AB = A * B;
+  dense_matrix<double, true> C(3, 3);
+  gemm(1., A.view(), B.view(), 0., C.view());
+  for (std::size_t i = 0; i < 3; ++i)
+    for (std::size_t j = 0; j < 3; ++j)
+      if (C(i, j) != AB(i, j))
+      {
+        std::cout << "gemm through views: C(" << i << ", " << j << ") = " << C(i, j) << ", expected " << AB(i, j) << std::endl;
+        return 1;
+      }
+
+  // sub-block and zero-copy transpose
+  auto sub = A.view().submatrix(1, 1, 2, 2);
+  auto subT = sub.transposed_view();
+  if (sub(0, 1) != 6. || subT(1, 0) != 6. || sub.transpose()(1, 0) != 6.)
+  {
+    std::cout << "sub-block view of A gives wrong entries!" << std::endl;
+    return 1;
+  }
+
+  // apply an operator to the elements stored in a per-component (SoA) array, in place
+  constexpr std::size_t N = 3;
+  constexpr std::size_t K = 4;
+  std::vector<double> u(N * K);
+  for (std::size_t i = 0; i < u.size(); ++i) u[i] = static_cast<double>(i);
+  std::vector<double> Au(N * K);
+  gemm(1., A.view(), make_elements_view(std::as_const(u), 0, K, N), 0., make_elements_view(Au, 0, K, N));
+
+  std::vector<double> y(N);
+  for (std::size_t k = 0; k < K; ++k)
+  {
+    A.gemv(1., u.begin() + k * N, 0., y.begin());
+    for (std::size_t i = 0; i < N; ++i)
+      if (y[i] != Au[k * N + i])
+      {
+        std::cout << "element " << k << ", node " << i << ": Au = " << Au[k * N + i] << ", expected " << y[i] << std::endl;
+        return 1;
+      }
+  }
+
+  std::cout << "A * u over the elements of an SoA array: " << std::endl << make_elements_view(Au, 0, K, N).transpose() << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,94 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <cmath>
+
+#include "execution_space.h"
+#include "explicit_runge_kutta.h"
+
+namespace {
+
+// the loops give the same results on every execution space
+template<typename Space>
+int check_space(const Space& space)
+{
+  using namespace rdg;
+
+  const std::size_t n = 10007;
+  std::vector<double> x(n), y(n), z(n);
+  parallel_for(space, n, [&](std::size_t i)
+  {
+    x[i] = static_cast<double>(i);
+    y[i] = static_cast<double>(n - i);
+  });
+
+  axpy_n<Space, double, std::vector<double>::iterator, double>(space, 2., x.begin(), n, y.begin(), z.begin());
+  for (std::size_t i = 0; i < n; ++i)
+    if (z[i] != static_cast<double>(n + i)) return 1;
+
+  // the sum is joined in the order of the ranges, so it is the same on every space
+  double sum = parallel_reduce(space, n, 0., [&](std::size_t i, double& partial) { partial += 0.1 * z[i]; },
+                               [](double a, double b) { return a + b; });
+  double expected = 0.;
+  for (std::size_t i = 0; i < n; ++i) expected += 0.1 * z[i];
+  if (std::abs(sum - expected) > 1e-9 * expected) return 1;
+  if (sum != parallel_reduce(space, n, 0., [&](std::size_t i, double& partial) { partial += 0.1 * z[i]; },
+                             [](double a, double b) { return a + b; })) return 1;
+
+  double maxZ = parallel_reduce(space, n, 0., [&](std::size_t i, double& partial) { partial = std::max(partial, z[i]); },
+                                [](double a, double b) { return std::max(a, b); });
+  if (maxZ != static_cast<double>(2 * n - 1)) return 1;
+
+  // the leagues of a team loop cover the elements exactly once
+  std::vector<std::atomic<int>> visits(n);
+  team_for(space, n, [](std::size_t i) { return i % 7 == 0 ? 49. : 4.; }, [&](const team_member& team)
+  {
+    for (std::size_t e = team.league_begin(); e < team.league_end(); ++e)
+      team.vector_for(3, [&](std::size_t) { visits[e]++; });
+  });
+  for (std::size_t i = 0; i < n; ++i)
+    if (visits[i] != 3) return 1;
+
+  return 0;
+}
+
+}
+
+int test_execution_space()
+{
+  using namespace rdg;
+
+  if (check_space(serial_space())) return 1;
+
+  work_stealing_scheduler scheduler(4);
+  if (check_space(thread_pool_space(&scheduler, 256.))) return 1;
+  if (check_space(thread_pool_space())) return 1;
+  if (thread_pool_space(&scheduler).concurrency() != 4) return 1;
+
+#ifdef _OPENMP
+  if (check_space(openmp_space(256.))) return 1;
+#endif
+
+  return 0;
+}
@@ -0,0 +1,122 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include "float_codec.h"
+#include "work_stealing_scheduler.h"
+
+namespace {
+
+template<typename T>
+bool bitwise_equal(const std::vector<T>& a, const std::vector<T>& b)
+{ return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0; }
+
+}
+
+int test_float_codec()
+{
+  using namespace rdg;
+
+  // a smooth solution at the nodes of elements of order 4, with a jump in the middle
+  const std::size_t numCells = 1 << 16, np = 5;
+  const double r[np] = {-1., -std::sqrt(3. / 7.), 0., std::sqrt(3. / 7.), 1.};
+  std::vector<double> u(numCells * np);
+  for (std::size_t c = 0; c < numCells; ++c)
+    for (std::size_t j = 0; j < np; ++j)
+    {
+      double x = (c + (r[j] + 1.) / 2.) / numCells;
+      u[c * np + j] = (x < 0.5 ? 1. : 0.125) + 0.1 * std::sin(6.283185307179586 * x);
+    }
+  const double bytes = u.size() * sizeof(double);
+
+  // lossless: bit for bit, and the same stream on any number of threads
+  std::vector<std::uint8_t> stream;
+  auto t0 = std::chrono::steady_clock::now();
+  compress_floats(serial_space(), u.data(), u.size(), stream);
+  auto t1 = std::chrono::steady_clock::now();
+  std::vector<double> v(u.size());
+  decompress_floats(serial_space(), stream.data(), stream.size(), v.data(), v.size());
+  auto t2 = std::chrono::steady_clock::now();
+  if (!bitwise_equal(u, v)) return 1;
+  double ratio = bytes / stream.size();
+  std::cout << "lossless: ratio = " << ratio << ", compression " << bytes / std::chrono::duration<double>(t1 - t0).count() / 1e9
+            << " GB/s, decompression " << bytes / std::chrono::duration<double>(t2 - t1).count() / 1e9 << " GB/s" << std::endl;
+  if (ratio < 1.1) return 1;
+
+  work_stealing_scheduler scheduler(3);
+  std::vector<std::uint8_t> parallel;
+  compress_floats(thread_pool_space(&scheduler, 1.), u.data(), u.size(), parallel);
+  if (parallel != stream) return 1;
+  std::fill(v.begin(), v.end(), 0.);
+  decompress_floats(thread_pool_space(&scheduler, 1.), parallel.data(), parallel.size(), v.data(), v.size());
+  if (!bitwise_equal(u, v)) return 1;
+
+  // special values and floats come back bit for bit too
+  std::vector<double> s{0., -0., std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::infinity(),
+                        -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::denorm_min(),
+                        std::numeric_limits<double>::max(), -1.5, 1e-300, 3.};
+  std::vector<double> sv(s.size());
+  compress_floats(serial_space(), s.data(), s.size(), stream, float_codec_options{false, 0., 3});
+  decompress_floats(serial_space(), stream.data(), stream.size(), sv.data(), sv.size());
+  if (!bitwise_equal(s, sv)) return 1;
+
+  std::vector<float> f(1000), fv(1000);
+  for (std::size_t i = 0; i < f.size(); ++i) f[i] = std::cos(0.01f * i);
+  compress_floats(serial_space(), f.data(), f.size(), stream);
+  decompress_floats(serial_space(), stream.data(), stream.size(), fv.data(), fv.size());
+  if (!bitwise_equal(f, fv)) return 1;
+
+  // lossy: every value within the bound, NaNs kept
+  for (double bound : {1e-3, 1e-6, 1e-9})
+  {
+    float_codec_options options;
+    options.lossy = true;
+    options.error_bound = bound;
+    compress_floats(serial_space(), u.data(), u.size(), stream, options);
+    decompress_floats(serial_space(), stream.data(), stream.size(), v.data(), v.size());
+    double maxError = 0.;
+    for (std::size_t i = 0; i < u.size(); ++i) maxError = std::max(maxError, std::abs(u[i] - v[i]));
+    std::cout << "lossy, error bound " << bound << ": ratio = " << bytes / stream.size() << ", max error = " << maxError << std::endl;
+    if (maxError > bound || bytes / stream.size() < ratio) return 1;
+  }
+  float_codec_options options;
+  options.lossy = true;
+  options.error_bound = 1e-3;
+  compress_floats(serial_space(), s.data(), s.size(), stream, options);
+  decompress_floats(serial_space(), stream.data(), stream.size(), sv.data(), sv.size());
+  if (!std::isnan(sv[2]) || sv[3] != s[3] || sv[4] != s[4] || sv[6] != s[6]) return 1;
+  for (std::size_t i : {0, 1, 5, 7, 8, 9})
+    if (std::abs(sv[i] - s[i]) > 1e-3) return 1;
+
+  // a truncated stream is detected
+  bool thrown = false;
+  try { decompress_floats(serial_space(), stream.data(), stream.size() - 1, sv.data(), sv.size()); }
+  catch (const std::runtime_error&) { thrown = true; }
+  if (!thrown) return 1;
+
+  return 0;
+}
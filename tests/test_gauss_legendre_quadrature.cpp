@@ -0,0 +1,65 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#include <vector>
+#include <iterator>
+#include <iostream>
+#include <cmath>
+
+#include "gauss_legendre_quadrature.h"
+
+int test_gauss_legendre_quadrature()
+{
+  using namespace rdg;
+
+  std::vector<double> points;
+  std::vector<double> weights;
+
+  // Gauss-Legendre quadrature: exact for polynomials of degree up to 2 * np - 1
+  for(int np = 1; np <= 24; ++np)
+  {
+    points.clear();
+    weights.clear();
+    gauss_legendre_quadrature(np, std::back_inserter(points), std::back_inserter(weights));
+
+    if (np < 6)
+    {
+      std::cout << "Gauss-Legendre quadrature of " << np << " points:" << std::endl;
+      for (std::size_t j = 0; j < points.size(); ++j)
+        std::cout << "p = " << points[j] << ", w = " << weights[j] << std::endl;
+    }
+
+    for (int k = 0; k <= 2 * np - 1; ++k)
+    {
+      double integral = 0.;
+      for (std::size_t j = 0; j < points.size(); ++j)
+        integral += weights[j] * std::pow(points[j], k);
+      double exact = k % 2 == 0 ? 2. / (k + 1) : 0.;
+      if (std::abs(integral - exact) > 1.e-14)
+      {
+        std::cout << "Gauss-Legendre quadrature of " << np << " points integrates x^" << k << " to " << integral << std::endl;
+        return 1;
+      }
+    }
+  }
+  std::cout << std::endl;
+
+  return 0;
+}
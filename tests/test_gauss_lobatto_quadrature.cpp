@@ -21,6 +21,8 @@
 #include <vector>
 #include <iterator>
 #include <iostream>
+#include <limits>
+#include <cmath>
 
 #include "gauss_lobatto_quadrature.h"
 
@@ -41,8 +43,39 @@ int test_gauss_lobatto_quadrature()
     std::cout << "Gauss-Lobatto quadrature of " << np << " points:" << std::endl;
     for (std::size_t j = 0; j < points.size(); ++j)
       std::cout << "p = " << points[j] << ", w = " << weights[j] << std::endl;
+
+    // the computed table must reproduce the closed-form values
+    const auto& table = gauss_lobatto_table<double>::get(np);
+    for (std::size_t j = 0; j < points.size(); ++j)
+      if (std::abs(table.points()[j] - points[j]) > 4. * std::numeric_limits<double>::epsilon() ||
+          std::abs(table.weights()[j] - weights[j]) > 4. * std::numeric_limits<double>::epsilon())
+      {
+        std::cout << "computed p = " << table.points()[j] << ", w = " << table.weights()[j] << " differ from the closed form!" << std::endl;
+        return 1;
+      }
   }
   std::cout << std::endl;
 
+  // high orders: exact for polynomials of degree up to 2 * np - 3
+  for(int np = 8; np <= 24; ++np)
+  {
+    points.clear();
+    weights.clear();
+    gauss_lobatto_quadrature(np, std::back_inserter(points), std::back_inserter(weights));
+
+    for (int k = 0; k <= 2 * np - 3; ++k)
+    {
+      double integral = 0.;
+      for (std::size_t j = 0; j < points.size(); ++j)
+        integral += weights[j] * std::pow(points[j], k);
+      double exact = k % 2 == 0 ? 2. / (k + 1) : 0.;
+      if (std::abs(integral - exact) > 1.e-14)
+      {
+        std::cout << "Gauss-Lobatto quadrature of " << np << " points integrates x^" << k << " to " << integral << std::endl;
+        return 1;
+      }
+    }
+  }
+
   return 0;
 }
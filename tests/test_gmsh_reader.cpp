@@ -0,0 +1,158 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <tuple>
+#include <cstdio>
+
+#include "gmsh_reader.h"
+
+// writes an n x n x n box of unit hexahedra in the Gmsh format 4.1, with every other
+// hexahedron numbered from a different corner to give faces of various orientations,
+// and with the quadrilaterals of the face z = 0 and an $Entities section to be skipped
+static void write_box(const std::string& filename, std::size_t n, bool binary)
+{
+  std::ofstream out(filename, std::ios::binary);
+  auto vertex = [n](std::size_t i, std::size_t j, std::size_t k) { return 1 + i + (n + 1) * (j + (n + 1) * k); };
+  auto write_sizes = [&](std::vector<std::size_t> v)
+  {
+    if (binary) out.write(reinterpret_cast<const char*>(v.data()), v.size() * sizeof(std::size_t));
+    else { for (std::size_t i = 0; i < v.size(); ++i) out << (i ? " " : "") << v[i]; out << "\n"; }
+  };
+  auto write_block = [&](int dim, int entity, int type, std::size_t num)
+  {
+    if (binary)
+    {
+      int h[3] = {dim, entity, type};
+      out.write(reinterpret_cast<const char*>(h), sizeof(h));
+      out.write(reinterpret_cast<const char*>(&num), sizeof(num));
+    }
+    else out << dim << " " << entity << " " << type << " " << num << "\n";
+  };
+
+  out << "$MeshFormat\n4.1 " << (binary ? 1 : 0) << " " << sizeof(std::size_t) << "\n";
+  if (binary) { int one = 1; out.write(reinterpret_cast<const char*>(&one), sizeof(one)); out << "\n"; }
+  out << "$EndMeshFormat\n";
+  out << "$Entities\n0 0 0 1\n1 0 0 0 1 1 1 0 0\n$EndEntities\n";
+
+  std::size_t nv = (n + 1) * (n + 1) * (n + 1);
+  out << "$Nodes\n";
+  write_sizes({1, nv, 1, nv});
+  write_block(3, 1, 0, nv);
+  std::vector<std::size_t> tags;
+  std::vector<double> coords;
+  for (std::size_t k = 0; k <= n; ++k)
+    for (std::size_t j = 0; j <= n; ++j)
+      for (std::size_t i = 0; i <= n; ++i)
+      {
+        tags.push_back(vertex(i, j, k));
+        coords.insert(coords.end(), {double(i), double(j), double(k)});
+      }
+  write_sizes(tags);
+  if (binary) out.write(reinterpret_cast<const char*>(coords.data()), coords.size() * sizeof(double));
+  else for (std::size_t i = 0; i < coords.size(); i += 3) out << coords[i] << " " << coords[i + 1] << " " << coords[i + 2] << "\n";
+  if (binary) out << "\n";
+  out << "$EndNodes\n";
+
+  out << "$Elements\n";
+  write_sizes({2, n * n * n + n * n, 1, n * n * n + n * n});
+  write_block(2, 1, 3, n * n);
+  std::size_t tag = 1;
+  for (std::size_t j = 0; j < n; ++j)
+    for (std::size_t i = 0; i < n; ++i)
+      write_sizes({tag++, vertex(i, j, 0), vertex(i + 1, j, 0), vertex(i + 1, j + 1, 0), vertex(i, j + 1, 0)});
+  write_block(3, 1, 5, n * n * n);
+  for (std::size_t k = 0; k < n; ++k)
+    for (std::size_t j = 0; j < n; ++j)
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        std::vector<std::size_t> g = {vertex(i, j, k), vertex(i + 1, j, k), vertex(i + 1, j + 1, k), vertex(i, j + 1, k),
+                                      vertex(i, j, k + 1), vertex(i + 1, j, k + 1), vertex(i + 1, j + 1, k + 1), vertex(i, j + 1, k + 1)};
+        if ((i + j + k) % 2) g = {g[1], g[2], g[3], g[0], g[5], g[6], g[7], g[4]};
+        if ((i + 2 * j + k) % 3 == 0) g = {g[4], g[7], g[6], g[5], g[0], g[3], g[2], g[1]};
+        g.insert(g.begin(), tag++);
+        write_sizes(g);
+      }
+  if (binary) out << "\n";
+  out << "$EndElements\n";
+}
+
+static int check_box(const rdg::unstructured_hex_mesh<double>& mesh, std::size_t n)
+{
+  using mesh_type = rdg::unstructured_hex_mesh<double>;
+
+  if (mesh.num_cells() != n * n * n) return 1;
+  if (mesh.num_faces() != 3 * n * n * (n + 1) || mesh.num_boundary_faces() != 6 * n * n) return 1;
+
+  for (std::size_t c = 0; c < mesh.num_cells(); ++c)
+    for (int f = 0; f < mesh_type::num_cell_faces(); ++f)
+    {
+      std::size_t nb = mesh.neighbor(c, f);
+      auto cells = mesh.face_cells(mesh.cell_face(c, f));
+      if (nb == mesh_type::invalid_index)
+      {
+        if (std::get<0>(cells) != c || std::get<1>(cells) != mesh_type::invalid_index) return 1;
+        continue;
+      }
+      int nf = mesh.neighbor_face(c, f);
+      if (mesh.neighbor(nb, nf) != c || mesh.cell_face(nb, nf) != mesh.cell_face(c, f)) return 1;
+
+      // the corners of the face seen from this cell map to the same vertices seen from the owner
+      std::size_t owner = std::get<0>(cells);
+      int of = owner == c ? f : nf;
+      auto ov = mesh.face_vertices(owner, of);
+      auto fv = mesh.face_vertices(c, f);
+      const int corner[4][2] = {{0, 0}, {1, 0}, {1, 1}, {0, 1}};
+      for (int k = 0; k < 4; ++k)
+      {
+        auto ab = mesh_type::face_node_map(mesh.face_orientation(c, f), 2, corner[k][0], corner[k][1]);
+        int ok = 0;
+        while (corner[ok][0] != std::get<0>(ab) || corner[ok][1] != std::get<1>(ab)) ++ok;
+        if (ov[ok] != fv[k]) return 1;
+      }
+    }
+  return 0;
+}
+
+int test_gmsh_reader()
+{
+  using namespace rdg;
+
+  const std::size_t n = 3;
+  for (bool binary : {false, true})
+  {
+    std::string filename = binary ? "test_box_binary.msh" : "test_box_ascii.msh";
+    write_box(filename, n, binary);
+    auto mesh = read_gmsh<double>(filename);
+    std::remove(filename.c_str());
+    std::cout << (binary ? "binary" : "ASCII") << " Gmsh mesh: " << mesh.num_cells() << " cells, "
+              << mesh.num_faces() << " faces, " << mesh.num_boundary_faces() << " on the boundary" << std::endl;
+    if (check_box(mesh, n)) return 1;
+  }
+
+  // a missing file is reported by an exception
+  try { read_gmsh<double>("no_such_file.msh"); return 1; }
+  catch (const std::runtime_error&) {}
+
+  return 0;
+}
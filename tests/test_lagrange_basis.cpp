@@ -22,6 +22,7 @@
 #include <fstream>
 #include <string>
 #include <vector>
+#include <cmath>
 
 #include "lagrange_basis.h"
 
@@ -64,6 +65,31 @@ int test_lagrange_basis()
   for (int p = 0; p < N; ++p) 
     x[p] = p * 2. / static_cast<double>(N - 1) - 1.;
 
+  // batch evaluations, including points coinciding with nodes
+  x[N / 3] = nodes[2];
+  auto batch_vals = basis.values(x, x + N);
+  auto batch_devs = basis.derivatives(x, x + N);
+  for (int b = 0; b <= degree; ++b)
+    for (int p = 0; p < N; ++p)
+    {
+      if (std::abs(batch_vals(b, p) - basis.value(b, x[p])) > 1.e-14)
+      {
+        std::cout << "basis = " << b << ", x = " << x[p] << ": batch value " << batch_vals(b, p)
+                  << " differs from " << basis.value(b, x[p]) << std::endl;
+        return 1;
+      }
+      if (std::abs(batch_devs(b, p) - basis.derivative(b, x[p])) > 1.e-12 * (1. + std::abs(batch_devs(b, p))))
+      {
+        std::cout << "basis = " << b << ", x = " << x[p] << ": batch derivative " << batch_devs(b, p)
+                  << " differs from " << basis.derivative(b, x[p]) << std::endl;
+        return 1;
+      }
+    }
+  x[N / 3] = (N / 3) * 2. / static_cast<double>(N - 1) - 1.;
+
+  // and of no points at all
+  if (basis.values(x, x).size_col() != 0 || basis.derivatives(x, x).size_col() != 0) return 1;
+
   double val[N];
   double dev[N];
   std::ofstream file;
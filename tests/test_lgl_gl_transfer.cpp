@@ -0,0 +1,68 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#include <vector>
+#include <iostream>
+#include <cmath>
+
+#include "lgl_gl_transfer.h"
+
+int test_lgl_gl_transfer()
+{
+  using namespace rdg;
+
+  auto poly = [](double x) { return 1. - 2. * x + 3. * x * x * x; };
+
+  for (std::size_t n_lgl = 4; n_lgl <= 8; ++n_lgl)
+    for (std::size_t n_gl = 4; n_gl <= n_lgl + 4; ++n_gl)
+    {
+      const auto& transfer = lgl_gl_transfer<double>::get(n_lgl, n_gl);
+      if (&transfer != &lgl_gl_transfer<double>::get(n_lgl, n_gl))
+      {
+        std::cout << "transfer operators are not cached!" << std::endl;
+        return 1;
+      }
+
+      // a cubic polynomial is represented exactly on both point sets, so
+      // interpolation as well as projection must reproduce it
+      std::vector<double> u_lgl, u_gl;
+      for (double x : transfer.lgl_points()) u_lgl.push_back(poly(x));
+      for (double x : transfer.gl_points()) u_gl.push_back(poly(x));
+
+      std::vector<double> v_gl(n_gl), v_lgl(n_lgl);
+      transfer.lgl_to_gl().gemv(1., u_lgl.cbegin(), 0., v_gl.begin());
+      transfer.gl_to_lgl().gemv(1., u_gl.cbegin(), 0., v_lgl.begin());
+
+      for (std::size_t q = 0; q < n_gl; ++q)
+        if (std::abs(v_gl[q] - u_gl[q]) > 1.e-13)
+        {
+          std::cout << "LGL(" << n_lgl << ") to GL(" << n_gl << ") interpolation error = " << v_gl[q] - u_gl[q] << std::endl;
+          return 1;
+        }
+      for (std::size_t i = 0; i < n_lgl; ++i)
+        if (std::abs(v_lgl[i] - u_lgl[i]) > 1.e-12)
+        {
+          std::cout << "GL(" << n_gl << ") to LGL(" << n_lgl << ") transfer error = " << v_lgl[i] - u_lgl[i] << std::endl;
+          return 1;
+        }
+    }
+
+  return 0;
+}
@@ -29,17 +29,17 @@ int test_mapping_segment()
   const double A = -2.;
   const double B = -1.;
   double x = -1.25;
-  double r = mapping_segment<double>::x_to_r(A, B, x);
+  double r = mapping_segment::x_to_r(A, B, x);
   std::cout << "in segment [-2, -1], x = -1.25 is mapped to r = " << r << std::endl;
 
-  x = mapping_segment<double>::r_to_x(A, B, 0.5);
+  x = mapping_segment::r_to_x(A, B, 0.5);
   std::cout << "in segment [-2, -1], r = 0.5 is mapped to x = " << x << std::endl;
 
-  double J = mapping_segment<double>::J(A, B);
+  double J = mapping_segment::J(A, B);
   std::cout << "J of the segment [-2, -1] = " << J << std::endl;
 
   std::cout << "contravariant basis of the segment [-2, -1] = ";
-  std::cout << mapping_segment<double>::contravariant_basis(A, B) << std::endl;
+  std::cout << mapping_segment::contravariant_basis(A, B) << std::endl;
 
   return 0;
 }
@@ -0,0 +1,84 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#include <vector>
+#include <iostream>
+#include <cmath>
+
+#include "modal_basis.h"
+#include "legendre_polynomials.h"
+#include "reference_segment.h"
+
+int test_modal_basis()
+{
+  using namespace rdg;
+
+  constexpr std::size_t order = 8;
+  constexpr std::size_t K = 5; // number of elements
+  constexpr std::size_t n = order + 1;
+
+  const auto& transform = modal_transform<double>::get(order);
+  reference_segment<double> refElem(order);
+
+  // element e holds the nodal values of the Legendre polynomial of degree e + 1, so its
+  // only nonzero modal coefficient is that of degree e + 1, sqrt(2 / (2 * (e + 1) + 1))
+  std::vector<double> nodal(n * K), modal(n * K), back(n * K);
+  for (std::size_t e = 0; e < K; ++e)
+    for (std::size_t i = 0; i < n; ++i)
+      nodal[e * n + i] = legendre_polynomial_value(e + 1, refElem.node_position(i));
+
+  transform.nodal_to_modal(nodal.data(), K, modal.data());
+  transform.modal_to_nodal(modal.data(), K, back.data());
+  for (std::size_t e = 0; e < K; ++e)
+    for (std::size_t k = 0; k < n; ++k)
+    {
+      double expected = k == e + 1 ? std::sqrt(legendre_polynomial_l2_norm<double>(k)) : 0.;
+      if (std::abs(modal[e * n + k] - expected) > 1.e-13 || std::abs(back[e * n + k] - nodal[e * n + k]) > 1.e-13)
+      {
+        std::cout << "element " << e << ", mode " << k << ": modal coefficient = " << modal[e * n + k] << std::endl;
+        return 1;
+      }
+    }
+
+  // cutoff filter: the elements holding modes above the cutoff are zeroed, the others are kept
+  constexpr std::size_t cutoff = 3;
+  auto filter = spectral_filter<double>::cutoff(order, cutoff);
+  std::vector<double> filtered = nodal;
+  filter.apply(filtered.begin(), filtered.size());
+  std::vector<double> batched = nodal;
+  filter.apply_batched(batched.data(), K);
+  for (std::size_t e = 0; e < K; ++e)
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      double expected = e + 1 <= cutoff ? nodal[e * n + i] : 0.;
+      if (std::abs(filtered[e * n + i] - expected) > 1.e-13 || std::abs(batched[e * n + i] - filtered[e * n + i]) > 1.e-14)
+      {
+        std::cout << "cutoff filter: element " << e << ", node " << i << " = " << filtered[e * n + i] << std::endl;
+        return 1;
+      }
+    }
+
+  auto exp_filter = spectral_filter<double>::exponential(order, 2, 8);
+  std::cout << "exponential filter damping factors: ";
+  for (std::size_t k = 0; k < n; ++k) std::cout << exp_filter.damping_factor(k) << " ";
+  std::cout << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,82 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#include <vector>
+#include <iostream>
+#include <cmath>
+
+#include "reference_hexahedron.h"
+
+int test_reference_hexahedron()
+{
+  using namespace rdg;
+
+  constexpr std::size_t order = 5;
+  reference_hexahedron<double> hex(order);
+
+  // f = r^2 s^3 t^5 and its derivatives are represented exactly at order 5
+  std::size_t np = hex.num_nodes();
+  std::vector<double> f(np), fr(np), fs(np), ft(np);
+  double sum_weights = 0.;
+  for (std::size_t n = 0; n < np; ++n)
+  {
+    double r = hex.node_position_r(n), s = hex.node_position_s(n), t = hex.node_position_t(n);
+    f[n] = r * r * s * s * s * std::pow(t, 5);
+    sum_weights += hex.weight(n);
+  }
+  if (std::abs(sum_weights - 8.) > 1.e-13)
+  {
+    std::cout << "sum of the weights of the hexahedron = " << sum_weights << std::endl;
+    return 1;
+  }
+
+  hex.derivative_r(f.cbegin(), fr.begin());
+  hex.derivative_s(f.cbegin(), fs.begin());
+  hex.derivative_t(f.cbegin(), ft.begin());
+  for (std::size_t n = 0; n < np; ++n)
+  {
+    double r = hex.node_position_r(n), s = hex.node_position_s(n), t = hex.node_position_t(n);
+    if (std::abs(fr[n] - 2. * r * s * s * s * std::pow(t, 5)) > 1.e-12 ||
+        std::abs(fs[n] - 3. * r * r * s * s * std::pow(t, 5)) > 1.e-12 ||
+        std::abs(ft[n] - 5. * r * r * s * s * s * std::pow(t, 4)) > 1.e-12)
+    {
+      std::cout << "wrong derivatives at node " << n << ": " << fr[n] << ", " << fs[n] << ", " << ft[n] << std::endl;
+      return 1;
+    }
+  }
+
+  // the face nodes are on the faces
+  for (std::size_t f = 0; f < hex.num_faces(); ++f)
+  {
+    if (hex.face_nodes(f).size() != hex.num_face_nodes()) return 1;
+    double coord = f % 2 == 0 ? -1. : 1.;
+    for (std::size_t n : hex.face_nodes(f))
+    {
+      double x = f / 2 == 0 ? hex.node_position_r(n) : (f / 2 == 1 ? hex.node_position_s(n) : hex.node_position_t(n));
+      if (x != coord)
+      {
+        std::cout << "node " << n << " is not on face " << f << std::endl;
+        return 1;
+      }
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,83 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+#include "reference_segment.h"
+#include "reference_segment_traits.h"
+
+template<int ORDER>
+double max_difference_to_reference_segment()
+{
+  using traits = rdg::reference_segment_traits<double, ORDER>;
+  static_assert(traits::node_position(0) == -1. && traits::node_position(ORDER) == 1.);
+
+  rdg::reference_segment<double> refElem(ORDER);
+  auto M = refElem.mass_matrix();
+  auto D = refElem.derivative_matrix_wrt_r();
+
+  double diff = 0.;
+  for (std::size_t i = 0; i < traits::num_nodes(); ++i)
+  {
+    diff = std::max(diff, std::abs(traits::node_position(i) - refElem.node_position(i)));
+    diff = std::max(diff, std::abs(traits::weight(i) - M(i, i)));
+    for (std::size_t j = 0; j < traits::num_nodes(); ++j)
+      diff = std::max(diff, std::abs(traits::derivative(i, j) - D(i, j)) / (1. + std::abs(D(i, j))));
+  }
+  return diff;
+}
+
+template<int... ORDERS>
+int check_orders(std::integer_sequence<int, ORDERS...>)
+{
+  int failed = 0;
+  ((failed += max_difference_to_reference_segment<ORDERS + 1>() > 1.e-12), ...);
+  return failed;
+}
+
+int test_reference_segment_traits()
+{
+  using namespace rdg;
+
+  if (check_orders(std::make_integer_sequence<int, max_fixed_order>()))
+  {
+    std::cout << "compile-time tables differ from reference_segment!" << std::endl;
+    return 1;
+  }
+
+  // the SBP property of the long double tables, Q + Q^T = B where Q = M * D
+  using traits = reference_segment_traits<long double, 16>;
+  constexpr std::size_t N = traits::num_nodes();
+  for (std::size_t i = 0; i < N; ++i)
+    for (std::size_t j = 0; j < N; ++j)
+    {
+      long double b = traits::weight(i) * traits::derivative(i, j) + traits::weight(j) * traits::derivative(j, i);
+      long double expected = i == j && i == 0 ? -1.L : (i == j && i == N - 1 ? 1.L : 0.L);
+      if (std::abs(b - expected) > 1.e-15L)
+      {
+        std::cout << "SBP property violated at (" << i << ", " << j << "): " << b << std::endl;
+        return 1;
+      }
+    }
+
+  return 0;
+}
@@ -0,0 +1,133 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+
+#include "text_writer.h"
+#include "work_stealing_scheduler.h"
+
+namespace {
+
+std::string read_file(const std::string& name)
+{
+  std::ifstream file(name, std::ios::binary);
+  std::stringstream s;
+  s << file.rdbuf();
+  return s.str();
+}
+
+}
+
+int test_text_writer()
+{
+  using namespace rdg;
+
+  // more rows than a block, so the rows are formatted in several blocks
+  const std::size_t n = 100000;
+  std::vector<double> x(n), u(n);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    x[i] = static_cast<double>(i) / n;
+    u[i] = std::sin(100. * x[i]) / (1. + x[i]) - 1e-7;
+  }
+  auto xs = [&](std::size_t i) { return x[i]; };
+  auto us = [&](std::size_t i) { return u[i]; };
+  auto is = [](std::size_t i) { return static_cast<int>(i) - 7; };
+
+  // what an ostream of precision 15 writes, in a small buffer
+  const text_format ostream15{std::chars_format::general, std::numeric_limits<double>::digits10};
+  {
+    text_writer file("test_text_writer_1.txt", ostream15, 4096);
+    file.write_text("#         x         u         i\n");
+    file.write_columns(serial_space(), n, "  ", xs, us, is);
+    file.write_char('\n');
+    file.write_number(-0.).write_char(' ').write_number(std::numeric_limits<double>::infinity()).write_char('\n');
+    file.close();
+    if (file.bytes_written() != read_file("test_text_writer_1.txt").size()) return 1;
+  }
+  {
+    std::ofstream file("test_text_writer_2.txt");
+    file.precision(std::numeric_limits<double>::digits10);
+    file << "#         x         u         i\n";
+    for (std::size_t i = 0; i < n; ++i)
+      file << x[i] << "  " << u[i] << "  " << is(i) << '\n';
+    file << '\n' << -0. << ' ' << std::numeric_limits<double>::infinity() << '\n';
+  }
+  if (read_file("test_text_writer_1.txt") != read_file("test_text_writer_2.txt")) return 1;
+
+  // the shortest text reads back to the same values, and the same on any number of threads
+  work_stealing_scheduler scheduler(3);
+  auto t0 = std::chrono::steady_clock::now();
+  {
+    text_writer file("test_text_writer_1.txt");
+    file.write_columns(serial_space(), n, " ", xs, us);
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  {
+    text_writer file("test_text_writer_2.txt");
+    file.write_columns(thread_pool_space(&scheduler), n, " ", xs, us);
+  }
+  std::string text = read_file("test_text_writer_1.txt");
+  if (text != read_file("test_text_writer_2.txt")) return 1;
+  {
+    const char* p = text.c_str();
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      char* end;
+      if (std::strtod(p, &end) != x[i]) return 1;
+      p = end;
+      if (std::strtod(p, &end) != u[i]) return 1;
+      p = end;
+    }
+  }
+
+  auto t2 = std::chrono::steady_clock::now();
+  {
+    std::ofstream file("test_text_writer_2.txt");
+    file.precision(std::numeric_limits<double>::max_digits10);
+    for (std::size_t i = 0; i < n; ++i)
+      file << x[i] << " " << u[i] << std::endl;
+  }
+  auto t3 = std::chrono::steady_clock::now();
+  std::cout << "text_writer: " << text.size() / std::chrono::duration<double>(t1 - t0).count() / 1e6
+            << " MB/s, ofstream with std::endl: " << read_file("test_text_writer_2.txt").size() / std::chrono::duration<double>(t3 - t2).count() / 1e6
+            << " MB/s" << std::endl;
+
+  std::remove("test_text_writer_1.txt");
+  std::remove("test_text_writer_2.txt");
+
+  // a file that cannot be opened
+  bool thrown = false;
+  try { text_writer file("no_such_directory/test_text_writer.txt"); }
+  catch (const std::runtime_error&) { thrown = true; }
+  if (!thrown) return 1;
+
+  return 0;
+}
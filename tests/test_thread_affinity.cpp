@@ -0,0 +1,80 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <mutex>
+
+#include "thread_affinity.h"
+#include "default_init_allocator.h"
+#include "work_stealing_scheduler.h"
+
+int test_thread_affinity()
+{
+  using namespace rdg;
+
+  // CPU lists of sysfs
+  if (parse_cpu_list("0-3,8,10-11\n") != std::vector<int>{0, 1, 2, 3, 8, 10, 11}) return 1;
+  if (!parse_cpu_list("").empty()) return 1;
+
+  // compact fills a node before the next, scatter alternates the nodes
+  std::vector<std::vector<int>> nodes{{0, 1, 2}, {4, 5, 6}};
+  if (affinity_cpus(thread_affinity::compact, 4, nodes) != std::vector<int>{0, 1, 2, 4}) return 1;
+  if (affinity_cpus(thread_affinity::scatter, 4, nodes) != std::vector<int>{0, 4, 1, 5}) return 1;
+  if (affinity_cpus(thread_affinity::scatter, 8, nodes) != std::vector<int>{0, 4, 1, 5, 2, 6, 0, 4}) return 1;
+  if (!affinity_cpus(thread_affinity::none, 4, nodes).empty()) return 1;
+  if (numa_node_cpus().empty()) return 1;
+
+  // the static loops run the same ranges on the same threads, so the items first touched
+  // by a thread are the ones it runs in the next static loop
+  work_stealing_scheduler scheduler(4, thread_affinity::compact);
+  if (scheduler.cpus().size() != 4) return 1;
+  const std::size_t n = 5003;
+  auto cost = [](std::size_t i) { return i < 1000 ? 8. : 1.; };
+  std::vector<std::thread::id> first(n), second(n);
+  std::vector<int, default_init_allocator<int>> visits(n);
+  scheduler.parallel_for_static(n, cost, 256., [&](std::size_t begin, std::size_t end)
+  {
+    for (std::size_t i = begin; i < end; ++i)
+    {
+      first[i] = std::this_thread::get_id();
+      visits[i] = 1;
+    }
+  });
+  scheduler.parallel_for_static(n, cost, 256., [&](std::size_t begin, std::size_t end)
+  {
+    for (std::size_t i = begin; i < end; ++i)
+    {
+      second[i] = std::this_thread::get_id();
+      visits[i]++;
+    }
+  });
+  if (scheduler.num_steals() != 0) return 1;
+  for (std::size_t i = 0; i < n; ++i)
+    if (visits[i] != 2 || first[i] != second[i]) return 1;
+
+  // the allocator still constructs the elements given values
+  std::vector<double, default_init_allocator<double>> v(8, 1.5);
+  v.resize(16, 2.5);
+  if (v[7] != 1.5 || v[15] != 2.5) return 1;
+
+  return 0;
+}
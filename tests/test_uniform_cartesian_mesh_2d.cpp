@@ -0,0 +1,76 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#include <iostream>
+#include <tuple>
+#include <vector>
+#include <cmath>
+
+#include "uniform_cartesian_mesh_2d.h"
+
+// every cell must be the minus or plus cell of its local faces, consistently with the
+// face numbering of the reference quadrilateral, and each face must appear twice (once
+// on a boundary)
+static int check_connectivity(const rdg::uniform_cartesian_mesh_2d<double>& mesh)
+{
+  using mesh_type = rdg::uniform_cartesian_mesh_2d<double>;
+
+  std::vector<int> count(mesh.num_faces(), 0);
+  for (std::size_t c = 0; c < mesh.num_cells(); ++c)
+    for (int f = 0; f < 4; ++f)
+    {
+      std::size_t face = mesh.cell_face(c, f);
+      if (face >= mesh.num_faces()) return 1;
+      if (mesh.face_direction(face) != f / 2) return 1;
+      auto cells = mesh.face_cells(face);
+      if ((f % 2 == 0 ? std::get<1>(cells) : std::get<0>(cells)) != c) return 1;
+      count[face]++;
+    }
+
+  for (std::size_t face = 0; face < mesh.num_faces(); ++face)
+  {
+    auto cells = mesh.face_cells(face);
+    bool boundary = std::get<0>(cells) == mesh_type::invalid_index || std::get<1>(cells) == mesh_type::invalid_index;
+    if (count[face] != (boundary ? 1 : 2)) return 1;
+  }
+  return 0;
+}
+
+int test_uniform_cartesian_mesh_2d()
+{
+  using namespace rdg;
+  using mesh_type = uniform_cartesian_mesh_2d<double>;
+
+  mesh_type mesh(0., 3., 3, 0., 1., 2);
+  std::cout << "3 x 2 mesh: " << mesh.num_x_faces() << " faces normal to x and "
+            << mesh.num_y_faces() << " faces normal to y" << std::endl;
+  if (mesh.num_x_faces() != 8 || mesh.num_y_faces() != 9) return 1;
+  if (check_connectivity(mesh)) return 1;
+  if (mesh.neighbor(0, 0) != mesh_type::invalid_index || mesh.neighbor(0, 1) != 1 || mesh.neighbor(0, 3) != 3) return 1;
+
+  mesh_type periodic(0., 3., 3, 0., 1., 2, true, true);
+  if (periodic.num_x_faces() != 6 || periodic.num_y_faces() != 6) return 1;
+  if (check_connectivity(periodic)) return 1;
+  if (periodic.neighbor(0, 0) != 2 || periodic.neighbor(0, 2) != 3 || periodic.neighbor(5, 1) != 3) return 1;
+
+  if (std::abs(mesh.J(0) - 0.125) > 1.e-15 || std::abs(mesh.min_cell_size() - 0.5) > 1.e-15) return 1;
+
+  return 0;
+}
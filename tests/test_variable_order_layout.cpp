@@ -0,0 +1,84 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#include <iostream>
+#include <vector>
+#include <iterator>
+#include <cmath>
+
+#include "gauss_lobatto_quadrature.h"
+#include "modal_basis.h"
+#include "variable_order_layout.h"
+
+int test_variable_order_layout()
+{
+  using namespace rdg;
+
+  const double tol = 1.e-13;
+
+  // cells of orders 3, 1, 3, 2, 1 are bucketed by increasing orders
+  variable_order_layout layout(std::vector<int>{3, 1, 3, 2, 1});
+  if (layout.num_dofs() != 15 || layout.offset(3) != 10 || layout.num_nodes(4) != 2) return 1;
+  if (layout.num_buckets() != 3 || layout.min_order() != 1 || layout.max_order() != 3) return 1;
+  const std::vector<std::size_t> cells{1, 4, 3, 0, 2};
+  for (std::size_t b = 0, k = 0; b < layout.num_buckets(); ++b)
+    for (const std::size_t* it = layout.bucket_begin(b); it != layout.bucket_end(b); ++it, ++k)
+      if (*it != cells[k] || layout.order(*it) != layout.bucket_order(b)) return 1;
+
+  // the values of x^2 on cells of orders >= 2 stay exact when the orders change, and
+  // raising the orders and lowering them back is the identity
+  auto nodal = [](const variable_order_layout& l)
+  {
+    std::vector<double> u(l.num_dofs());
+    for (std::size_t c = 0; c < l.num_cells(); ++c)
+    {
+      std::vector<double> r, w;
+      gauss_lobatto_quadrature(l.num_nodes(c), std::back_inserter(r), std::back_inserter(w));
+      for (std::size_t a = 0; a < r.size(); ++a) u[l.offset(c) + a] = (c + r[a]) * (c + r[a]);
+    }
+    return u;
+  };
+  variable_order_layout other(std::vector<int>{2, 4, 4, 3, 2});
+  std::vector<double> u = nodal(layout), v(other.num_dofs()), w(layout.num_dofs());
+  change_orders(layout, other, u.data(), v.data());
+  change_orders(other, layout, v.data(), w.data());
+  std::vector<double> exact = nodal(other);
+  for (std::size_t c = 0; c < other.num_cells(); ++c)
+    if (layout.order(c) >= 2)
+      for (std::size_t a = 0; a < other.num_nodes(c); ++a)
+        if (std::abs(v[other.offset(c) + a] - exact[other.offset(c) + a]) > tol) return 1;
+  for (std::size_t k = 0; k < u.size(); ++k)
+    if (std::abs(w[k] - u[k]) > tol) return 1;
+
+  // the smoothness indicator separates smooth polynomials from a jump
+  std::vector<double> r, wts, smooth, jump;
+  gauss_lobatto_quadrature(5, std::back_inserter(r), std::back_inserter(wts));
+  for (double x : r)
+  {
+    smooth.push_back(std::exp(x));
+    jump.push_back(x < 0.1 ? 1. : 0.125);
+  }
+  double sSmooth = smoothness_indicator(4, smooth.data()), sJump = smoothness_indicator(4, jump.data());
+  std::cout << "smoothness indicators of exp(x) and a jump = " << sSmooth << ", " << sJump << std::endl;
+  const double s0 = -4. * std::log10(4.);
+  if (sSmooth > s0 - 1. || sJump < s0) return 1;
+
+  return 0;
+}
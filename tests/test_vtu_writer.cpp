@@ -0,0 +1,100 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+
+#include "vtu_writer.h"
+#include "work_stealing_scheduler.h"
+
+namespace {
+
+std::string read_file(const std::string& filename)
+{
+  std::ifstream file(filename, std::ios::binary);
+  std::stringstream ss;
+  ss << file.rdbuf();
+  return ss.str();
+}
+
+}
+
+int test_vtu_writer()
+{
+  using namespace rdg;
+
+  // node orders of the Lagrange cells: corners, edges, faces, interior
+  if (vtk_lagrange_node_order(vtk_lagrange_cell::curve, 3) != std::vector<std::size_t>{0, 3, 1, 2}) return 1;
+  if (vtk_lagrange_node_order(vtk_lagrange_cell::quadrilateral, 2) != std::vector<std::size_t>{0, 2, 8, 6, 1, 5, 7, 3, 4}) return 1;
+  if (vtk_lagrange_node_order(vtk_lagrange_cell::hexahedron, 1) != std::vector<std::size_t>{0, 1, 3, 2, 4, 5, 7, 6}) return 1;
+  std::vector<std::size_t> hex = vtk_lagrange_node_order(vtk_lagrange_cell::hexahedron, 2);
+  if (hex.size() != 27 || hex[18] != 17 || hex[19] != 15 || hex[20] != 12 || hex[26] != 13) return 1;
+  std::vector<std::size_t> sorted = hex;
+  std::sort(sorted.begin(), sorted.end());
+  for (std::size_t i = 0; i < sorted.size(); ++i)
+    if (sorted[i] != i) return 1;
+
+  // a 1D mesh of various orders; the point data are the raw values after their size
+  variable_order_layout layout(std::vector<int>{1, 3, 2, 2, 4, 1});
+  std::size_t n = layout.num_dofs();
+  std::vector<double> x(n), u(n);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    x[i] = 0.1 * i;
+    u[i] = 1. / (i + 1.);
+  }
+  write_vtu<double>("test_vtu_writer.vtu", layout, 0, layout.num_cells(), x.data(), {{"u", u.data()}});
+  std::string s = read_file("test_vtu_writer.vtu");
+  std::remove("test_vtu_writer.vtu");
+  if (s.find("NumberOfPoints=\"" + std::to_string(n) + "\" NumberOfCells=\"6\"") == std::string::npos) return 1;
+  std::size_t data = s.find("   _");
+  if (data == std::string::npos) return 1;
+  std::uint64_t bytes;
+  std::memcpy(&bytes, s.data() + data + 4, sizeof(bytes));
+  if (bytes != n * sizeof(double) || std::memcmp(s.data() + data + 12, u.data(), bytes) != 0) return 1;
+
+  // pieces written on a pool of threads and their index
+  work_stealing_scheduler scheduler(3);
+  write_vtu_pieces<thread_pool_space, double>(thread_pool_space(&scheduler, 1.), "test_vtu_writer", 3, vtk_lagrange_cell::curve,
+    layout.num_cells(), [&](std::size_t c) { return layout.order(c); }, [&](std::size_t c) { return layout.offset(c); },
+    {x.data(), nullptr, nullptr}, {{"u", u.data()}});
+  std::string index = read_file("test_vtu_writer.pvtu");
+  std::remove("test_vtu_writer.pvtu");
+  std::size_t points = 0;
+  for (int k = 0; k < 3; ++k)
+  {
+    std::string piece = "test_vtu_writer_" + std::to_string(k) + ".vtu";
+    if (index.find("Source=\"" + piece + "\"") == std::string::npos) return 1;
+    std::string p = read_file(piece);
+    std::remove(piece.c_str());
+    std::size_t at = p.find("NumberOfPoints=\"");
+    if (at == std::string::npos) return 1;
+    points += std::stoul(p.substr(at + 16));
+  }
+  if (points != n) return 1;
+
+  return 0;
+}
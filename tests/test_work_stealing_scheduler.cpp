@@ -0,0 +1,74 @@
+/**
+ *  This file is part of rdg-and-fr.
+ *  rdg-and-fr is a C++ library implementing the robust DG and FR methods.
+ *
+ *  Copyright (C) 2023  hsongxa
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#include <iostream>
+#include <vector>
+#include <atomic>
+
+#include "work_stealing_scheduler.h"
+
+int test_work_stealing_scheduler()
+{
+  using namespace rdg;
+
+  work_stealing_scheduler scheduler(4);
+  if (scheduler.num_threads() != 4) return 1;
+
+  // every item is visited exactly once in consecutive loops of uniform costs
+  const std::size_t n = 10007;
+  std::vector<std::atomic<int>> visits(n);
+  for (int loop = 0; loop < 10; ++loop)
+    scheduler.parallel_for(n, 64, [&](std::size_t begin, std::size_t end)
+    { for (std::size_t i = begin; i < end; ++i) visits[i]++; });
+  for (std::size_t i = 0; i < n; ++i)
+    if (visits[i] != 10) return 1;
+
+  // tasks of about the grain cost given very uneven cost hints, where the first items
+  // are a thousand times more expensive than the others
+  auto cost = [](std::size_t i) { return i < 100 ? 1000. : 1.; };
+  std::atomic<std::size_t> numTasks{0}, maxExpensive{0};
+  std::atomic<double> sum{0.};
+  scheduler.parallel_for(n, cost, 4000., [&](std::size_t begin, std::size_t end)
+  {
+    numTasks++;
+    std::size_t expensive = 0;
+    double s = 0.;
+    for (std::size_t i = begin; i < end; ++i)
+    {
+      if (i < 100) expensive++;
+      s += static_cast<double>(i);
+    }
+    std::size_t max = maxExpensive.load();
+    while (expensive > max && !maxExpensive.compare_exchange_weak(max, expensive));
+    double old = sum.load();
+    while (!sum.compare_exchange_weak(old, old + s));
+  });
+  std::cout << "number of tasks = " << numTasks << ", stolen = " << scheduler.num_steals() << std::endl;
+  if (maxExpensive > 4 || numTasks < 25) return 1;
+  if (sum.load() != static_cast<double>(n) * (n - 1) / 2.) return 1;
+
+  // a single thread runs the loop in one call
+  work_stealing_scheduler serial(1);
+  numTasks = 0;
+  serial.parallel_for(n, 64, [&](std::size_t begin, std::size_t end) { numTasks++; });
+  if (numTasks != 1) return 1;
+
+  return 0;
+}
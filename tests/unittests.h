@@ -31,4 +31,48 @@
 
   int test_mapping_segment();
 
+  int test_dense_matrix_view();
+
+  int test_gauss_legendre_quadrature();
+
+  int test_lgl_gl_transfer();
+
+  int test_reference_segment_traits();
+
+  int test_modal_basis();
+
+  int test_reference_hexahedron();
+
+  int test_cartesian_mesh_1d();
+
+  int test_uniform_cartesian_mesh_2d();
+
+  int test_gmsh_reader();
+
+  int test_cell_reordering();
+
+  int test_cell_partition();
+
+  int test_curvilinear_metrics();
+
+  int test_adaptive_mesh_1d();
+
+  int test_variable_order_layout();
+
+  int test_work_stealing_scheduler();
+
+  int test_thread_affinity();
+
+  int test_execution_space();
+
+  int test_async_writer();
+
+  int test_checkpoint();
+
+  int test_vtu_writer();
+
+  int test_float_codec();
+
+  int test_text_writer();
+
 #endif